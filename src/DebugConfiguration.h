@@ -46,13 +46,34 @@
 #define LOG_TRACE(...) SEGGER_RTT_printf(0, __VA_ARGS__)
 #else
 #if defined(DEBUG_PORT) && !defined(DEBUG_MUTE)
+// Log calls below this level are compiled out entirely, so their arguments are not even evaluated.
+// 0 = TRACE, 1 = DEBUG, 2 = INFO, 3 = WARN. Errors and critical messages are always kept.
+#ifndef MESHTASTIC_LOG_LEVEL_MIN
+#define MESHTASTIC_LOG_LEVEL_MIN 0
+#endif
+#if MESHTASTIC_LOG_LEVEL_MIN <= 1
 #define LOG_DEBUG(...) DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...)
+#endif
+#if MESHTASTIC_LOG_LEVEL_MIN <= 2
 #define LOG_INFO(...) DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...)
+#endif
+#if MESHTASTIC_LOG_LEVEL_MIN <= 3
 #define LOG_WARN(...) DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...)
+#endif
 #define LOG_ERROR(...) DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_ERROR, __VA_ARGS__)
 #define LOG_CRIT(...) DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_CRIT, __VA_ARGS__)
+#if MESHTASTIC_LOG_LEVEL_MIN <= 0
 #define LOG_TRACE(...) DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_TRACE, __VA_ARGS__)
 #else
+#define LOG_TRACE(...)
+#endif
+#else
 #define LOG_DEBUG(...)
 #define LOG_INFO(...)
 #define LOG_WARN(...)
@@ -0,0 +1,112 @@
+#ifdef ARCH_PORTDUINO
+
+#include "DeferredLog.h"
+#include "DebugConfiguration.h"
+#include "RedirectablePrint.h"
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+
+DeferredLog::DeferredLog(RedirectablePrint &out) : out(out)
+{
+    slots = new Slot[NUM_SLOTS];
+    for (size_t i = 0; i < NUM_SLOTS; i++)
+        slots[i].seq.store(i, std::memory_order_relaxed);
+    writer = std::thread([this] { run(); });
+}
+
+DeferredLog::~DeferredLog()
+{
+    running = false;
+    wake.notify_one();
+    if (writer.joinable())
+        writer.join();
+    delete[] slots;
+}
+
+bool DeferredLog::push(const char *logLevel, uint32_t rtcSec, const char *threadName, const char *format, va_list arg)
+{
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Slot *slot;
+    while (true) {
+        slot = &slots[pos % NUM_SLOTS];
+        size_t seq = slot->seq.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            dropped++;
+            return false; // full
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    Record &r = slot->record;
+    r.logLevel = logLevel;
+    r.rtcSec = rtcSec;
+    r.uptimeMsec = millis();
+    strncpy(r.threadName, threadName ? threadName : "", sizeof(r.threadName) - 1);
+    r.threadName[sizeof(r.threadName) - 1] = '\0';
+    int len = vsnprintf(r.text, sizeof(r.text), format, arg);
+    if (len < 0)
+        len = 0;
+    if ((size_t)len > sizeof(r.text) - 1) {
+        len = sizeof(r.text) - 1;
+        r.text[len - 1] = '\n';
+    }
+    r.len = len;
+
+    slot->seq.store(pos + 1, std::memory_order_release);
+    wake.notify_one();
+    return true;
+}
+
+bool DeferredLog::writeOne()
+{
+    Slot &slot = slots[dequeuePos % NUM_SLOTS];
+    if (slot.seq.load(std::memory_order_acquire) != dequeuePos + 1)
+        return false;
+
+    Record &r = slot.record;
+    out.writeLogLine(r.logLevel, r.rtcSec, r.uptimeMsec, r.threadName[0] ? r.threadName : nullptr, r.text, r.len);
+
+    slot.seq.store(dequeuePos + NUM_SLOTS, std::memory_order_release);
+    dequeuePos++;
+    written++;
+    return true;
+}
+
+void DeferredLog::run()
+{
+    while (true) {
+        while (writeOne())
+            ;
+
+        uint32_t numDropped = dropped.exchange(0);
+        if (numDropped) {
+            char line[64];
+            int len = snprintf(line, sizeof(line), "%u log lines dropped, deferred log queue full\n", numDropped);
+            out.writeLogLine(MESHTASTIC_LOG_LEVEL_WARN, 0, millis(), nullptr, line, len);
+        }
+
+        if (!running)
+            break;
+        // Producers notify without taking the lock, the timeout covers a wakeup lost in between
+        std::unique_lock<std::mutex> lock(wakeLock);
+        wake.wait_for(lock, std::chrono::milliseconds(10));
+    }
+    while (writeOne())
+        ;
+}
+
+void DeferredLog::flush()
+{
+    const size_t target = enqueuePos.load();
+    wake.notify_one();
+    while (written.load() < target && running)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+#endif
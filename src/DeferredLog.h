@@ -0,0 +1,70 @@
+#pragma once
+
+#ifdef ARCH_PORTDUINO
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdarg.h>
+#include <stdint.h>
+#include <thread>
+
+class RedirectablePrint;
+
+/**
+ * Moves log output off the calling thread.
+ *
+ * log() formats the message straight into a slot of a bounded lock-free queue (no heap allocation, no locks, no I/O) and a
+ * background thread writes the queued lines to the console.  If the queue is full the line is dropped and the writer reports
+ * how many were lost, we never block the caller.
+ *
+ * Only used on native builds, enabled with "Logging: Deferred: true" in config.yaml.
+ */
+class DeferredLog
+{
+  public:
+    static constexpr size_t NUM_SLOTS = 1024;
+    static constexpr size_t MAX_LINE = 512; // same as the RedirectablePrint::vprintf buffer on native
+
+    explicit DeferredLog(RedirectablePrint &out);
+    ~DeferredLog();
+
+    /// Queue one log line. Returns false if the queue was full and the line was dropped.
+    bool push(const char *logLevel, uint32_t rtcSec, const char *threadName, const char *format, va_list arg);
+
+    /// Block until everything queued so far has been written
+    void flush();
+
+  private:
+    struct Record {
+        const char *logLevel; // always one of the MESHTASTIC_LOG_LEVEL_* literals
+        uint32_t rtcSec;
+        uint32_t uptimeMsec;
+        char threadName[16];
+        uint16_t len;
+        char text[MAX_LINE];
+    };
+
+    // Bounded multi-producer queue, each slot carries a sequence number telling producers and the consumer whose turn it is
+    struct Slot {
+        std::atomic<size_t> seq;
+        Record record;
+    };
+
+    RedirectablePrint &out;
+    Slot *slots;
+    std::atomic<size_t> enqueuePos{0};
+    size_t dequeuePos = 0; // only touched by the writer thread
+    std::atomic<size_t> written{0};
+    std::atomic<uint32_t> dropped{0};
+
+    std::atomic<bool> running{true};
+    std::mutex wakeLock;
+    std::condition_variable wake;
+    std::thread writer;
+
+    void run();
+    bool writeOne();
+};
+
+#endif
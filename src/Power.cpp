@@ -838,6 +838,16 @@ void Power::readPowerStatus()
                   memGet.getFreeHeap() - lastheap, running, concurrency::mainController.size(false));
         lastheap = memGet.getFreeHeap();
     }
+    uint32_t packetsShared = packetPool.getNumShared() - packetPool.getNumCopiedOnWrite();
+    if (packetsShared != lastPacketsShared) {
+        uint32_t now = millis();
+        uint32_t elapsedSecs = (now - lastPacketStatsMsec) / 1000;
+        if (elapsedSecs == 0)
+            elapsedSecs = 1;
+        LOG_DEBUG("Packet pool: %u copies avoided (%u/s)", packetsShared, (packetsShared - lastPacketsShared) / elapsedSecs);
+        lastPacketsShared = packetsShared;
+        lastPacketStatsMsec = now;
+    }
 #ifdef DEBUG_HEAP_MQTT
     if (mqtt) {
         // send MQTT-Packet with Heap-Size
@@ -13,6 +13,7 @@
 #include <time.h>
 
 #ifdef ARCH_PORTDUINO
+#include "DeferredLog.h"
 #include "platform/portduino/PortduinoGlue.h"
 #endif
 
@@ -24,7 +25,21 @@ void RedirectablePrint::rpInit()
 #ifdef HAS_FREE_RTOS
     inDebugPrint = xSemaphoreCreateMutexStatic(&this->_MutexStorageSpace);
 #endif
+#ifdef ARCH_PORTDUINO
+    if (settingsMap[deferred_logs] && !deferredLog) {
+        deferredLog = new DeferredLog(*this);
+        std::atexit([] { console->flushDeferredLog(); });
+    }
+#endif
+}
+
+#ifdef ARCH_PORTDUINO
+void RedirectablePrint::flushDeferredLog()
+{
+    if (deferredLog)
+        deferredLog->flush();
 }
+#endif
 
 void RedirectablePrint::setDestination(Print *_dest)
 {
@@ -56,12 +71,6 @@ size_t RedirectablePrint::vprintf(const char *logLevel, const char *format, va_l
     static char printBuf[160];
 #endif
 
-#ifdef ARCH_PORTDUINO
-    bool color = !settingsMap[ascii_logs];
-#else
-    bool color = true;
-#endif
-
     va_copy(copy, arg);
     size_t len = vsnprintf(printBuf, sizeof(printBuf), format, copy);
     va_end(copy);
@@ -73,31 +82,40 @@ size_t RedirectablePrint::vprintf(const char *logLevel, const char *format, va_l
         len = sizeof(printBuf) - 1;
         printBuf[sizeof(printBuf) - 2] = '\n';
     }
+    return writeLogBody(logLevel, printBuf, len);
+}
+
+size_t RedirectablePrint::writeLogBody(const char *logLevel, char *text, size_t len)
+{
+#ifdef ARCH_PORTDUINO
+    bool color = !settingsMap[ascii_logs];
+#else
+    bool color = true;
+#endif
+
     for (size_t f = 0; f < len; f++) {
-        if (!std::isprint(static_cast<unsigned char>(printBuf[f])) && printBuf[f] != '\n')
-            printBuf[f] = '#';
+        if (!std::isprint(static_cast<unsigned char>(text[f])) && text[f] != '\n')
+            text[f] = '#';
     }
     if (color && logLevel != nullptr) {
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_DEBUG) == 0)
+        if (isLevel(logLevel, MESHTASTIC_LOG_LEVEL_DEBUG))
             Print::write("\u001b[34m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_INFO) == 0)
+        if (isLevel(logLevel, MESHTASTIC_LOG_LEVEL_INFO))
             Print::write("\u001b[32m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_WARN) == 0)
+        if (isLevel(logLevel, MESHTASTIC_LOG_LEVEL_WARN))
             Print::write("\u001b[33m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_ERROR) == 0)
+        if (isLevel(logLevel, MESHTASTIC_LOG_LEVEL_ERROR))
             Print::write("\u001b[31m", 5);
     }
-    len = Print::write(printBuf, len);
+    len = Print::write(text, len);
     if (color && logLevel != nullptr) {
         Print::write("\u001b[0m", 4);
     }
     return len;
 }
 
-void RedirectablePrint::log_to_serial(const char *logLevel, const char *format, va_list arg)
+void RedirectablePrint::printLogHeader(const char *logLevel, uint32_t rtc_sec, uint32_t uptimeMsec, const char *threadName)
 {
-    size_t r = 0;
-
 #ifdef ARCH_PORTDUINO
     bool color = !settingsMap[ascii_logs];
 #else
@@ -106,19 +124,18 @@ void RedirectablePrint::log_to_serial(const char *logLevel, const char *format,
 
     // include the header
     if (color) {
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_DEBUG) == 0)
+        if (isLevel(logLevel, MESHTASTIC_LOG_LEVEL_DEBUG))
             Print::write("\u001b[34m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_INFO) == 0)
+        if (isLevel(logLevel, MESHTASTIC_LOG_LEVEL_INFO))
             Print::write("\u001b[32m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_WARN) == 0)
+        if (isLevel(logLevel, MESHTASTIC_LOG_LEVEL_WARN))
             Print::write("\u001b[33m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_ERROR) == 0)
+        if (isLevel(logLevel, MESHTASTIC_LOG_LEVEL_ERROR))
             Print::write("\u001b[31m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_TRACE) == 0)
+        if (isLevel(logLevel, MESHTASTIC_LOG_LEVEL_TRACE))
             Print::write("\u001b[35m", 5);
     }
 
-    uint32_t rtc_sec = getValidTime(RTCQuality::RTCQualityDevice, true); // display local time on logfile
     if (rtc_sec > 0) {
         long hms = rtc_sec % SEC_PER_DAY;
         // hms += tz.tz_dsttime * SEC_PER_HOUR;
@@ -135,13 +152,13 @@ void RedirectablePrint::log_to_serial(const char *logLevel, const char *format,
         if (color) {
             ::printf("\u001b[0m");
         }
-        ::printf("| %02d:%02d:%02d %u ", hour, min, sec, millis() / 1000);
+        ::printf("| %02d:%02d:%02d %u ", hour, min, sec, uptimeMsec / 1000);
 #else
         printf("%s ", logLevel);
         if (color) {
             printf("\u001b[0m");
         }
-        printf("| %02d:%02d:%02d %u ", hour, min, sec, millis() / 1000);
+        printf("| %02d:%02d:%02d %u ", hour, min, sec, uptimeMsec / 1000);
 #endif
     } else {
 #ifdef ARCH_PORTDUINO
@@ -149,24 +166,36 @@ void RedirectablePrint::log_to_serial(const char *logLevel, const char *format,
         if (color) {
             ::printf("\u001b[0m");
         }
-        ::printf("| ??:??:?? %u ", millis() / 1000);
+        ::printf("| ??:??:?? %u ", uptimeMsec / 1000);
 #else
         printf("%s ", logLevel);
         if (color) {
             printf("\u001b[0m");
         }
-        printf("| ??:??:?? %u ", millis() / 1000);
+        printf("| ??:??:?? %u ", uptimeMsec / 1000);
 #endif
     }
-    auto thread = concurrency::OSThread::currentThread;
-    if (thread) {
+    if (threadName) {
         print("[");
-        // printf("%p ", thread);
-        // assert(thread->ThreadName.length());
-        print(thread->ThreadName);
+        print(threadName);
         print("] ");
     }
-    r += vprintf(logLevel, format, arg);
+}
+
+void RedirectablePrint::log_to_serial(const char *logLevel, const char *format, va_list arg)
+{
+    auto thread = concurrency::OSThread::currentThread;
+    // display local time on logfile
+    printLogHeader(logLevel, getValidTime(RTCQuality::RTCQualityDevice, true), millis(),
+                   thread ? thread->ThreadName.c_str() : nullptr);
+    vprintf(logLevel, format, arg);
+}
+
+void RedirectablePrint::writeLogLine(const char *logLevel, uint32_t rtc_sec, uint32_t uptimeMsec, const char *threadName,
+                                     char *text, size_t len)
+{
+    printLogHeader(logLevel, rtc_sec, uptimeMsec, threadName);
+    writeLogBody(logLevel, text, len);
 }
 
 void RedirectablePrint::log_to_syslog(const char *logLevel, const char *format, va_list arg)
@@ -277,17 +306,9 @@ meshtastic_LogRecord_Level RedirectablePrint::getLogLevel(const char *logLevel)
 
 void RedirectablePrint::log(const char *logLevel, const char *format, ...)
 {
-
-    // append \n to format
-    size_t len = strlen(format);
-    char *newFormat = new char[len + 2];
-    strcpy(newFormat, format);
-    newFormat[len] = '\n';
-    newFormat[len + 1] = '\0';
-
 #if ARCH_PORTDUINO
     // level trace is special, two possible ways to handle it.
-    if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_TRACE) == 0) {
+    if (isLevel(logLevel, MESHTASTIC_LOG_LEVEL_TRACE)) {
         if (settingsStrings[traceFilename] != "") {
             va_list arg;
             va_start(arg, format);
@@ -297,27 +318,49 @@ void RedirectablePrint::log(const char *logLevel, const char *format, ...)
             }
             va_end(arg);
         }
-        if (settingsMap[logoutputlevel] < level_trace && strcmp(logLevel, MESHTASTIC_LOG_LEVEL_TRACE) == 0) {
-            delete[] newFormat;
+        if (settingsMap[logoutputlevel] < level_trace)
             return;
-        }
     }
-    if (settingsMap[logoutputlevel] < level_debug && strcmp(logLevel, MESHTASTIC_LOG_LEVEL_DEBUG) == 0) {
-        delete[] newFormat;
+    if (settingsMap[logoutputlevel] < level_debug && isLevel(logLevel, MESHTASTIC_LOG_LEVEL_DEBUG)) {
         return;
-    } else if (settingsMap[logoutputlevel] < level_info && strcmp(logLevel, MESHTASTIC_LOG_LEVEL_INFO) == 0) {
-        delete[] newFormat;
+    } else if (settingsMap[logoutputlevel] < level_info && isLevel(logLevel, MESHTASTIC_LOG_LEVEL_INFO)) {
         return;
-    } else if (settingsMap[logoutputlevel] < level_warn && strcmp(logLevel, MESHTASTIC_LOG_LEVEL_WARN) == 0) {
-        delete[] newFormat;
+    } else if (settingsMap[logoutputlevel] < level_warn && isLevel(logLevel, MESHTASTIC_LOG_LEVEL_WARN)) {
         return;
     }
 #endif
-    if (moduleConfig.serial.override_console_serial_port && strcmp(logLevel, MESHTASTIC_LOG_LEVEL_DEBUG) == 0) {
-        delete[] newFormat;
+    if (moduleConfig.serial.override_console_serial_port && isLevel(logLevel, MESHTASTIC_LOG_LEVEL_DEBUG)) {
         return;
     }
 
+    // append \n to format, on the stack unless the format is unusually long
+    size_t len = strlen(format);
+    char stackFormat[160];
+    std::unique_ptr<char[]> heapFormat;
+    char *newFormat = stackFormat;
+    if (len + 2 > sizeof(stackFormat)) {
+        heapFormat.reset(new char[len + 2]);
+        newFormat = heapFormat.get();
+    }
+    memcpy(newFormat, format, len);
+    newFormat[len] = '\n';
+    newFormat[len + 1] = '\0';
+
+#ifdef ARCH_PORTDUINO
+    // Only the console output is deferred, syslog and BLE still get the line below
+    if (deferredLog) {
+        auto thread = concurrency::OSThread::currentThread;
+        va_list arg;
+        va_start(arg, format);
+        deferredLog->push(logLevel, getValidTime(RTCQuality::RTCQualityDevice, true),
+                          thread ? thread->ThreadName.c_str() : nullptr, newFormat, arg);
+        va_end(arg);
+        // Make sure the last words before a crash reach the console
+        if (isLevel(logLevel, MESHTASTIC_LOG_LEVEL_CRIT))
+            deferredLog->flush();
+    }
+#endif
+
 #ifdef HAS_FREE_RTOS
     if (inDebugPrint != nullptr && xSemaphoreTake(inDebugPrint, portMAX_DELAY) == pdTRUE) {
 #else
@@ -328,7 +371,10 @@ void RedirectablePrint::log(const char *logLevel, const char *format, ...)
         va_list arg;
         va_start(arg, format);
 
-        log_to_serial(logLevel, newFormat, arg);
+#ifdef ARCH_PORTDUINO
+        if (!deferredLog)
+#endif
+            log_to_serial(logLevel, newFormat, arg);
         log_to_syslog(logLevel, newFormat, arg);
         log_to_ble(logLevel, newFormat, arg);
 
@@ -339,9 +385,6 @@ void RedirectablePrint::log(const char *logLevel, const char *format, ...)
         inDebugPrint = false;
 #endif
     }
-
-    delete[] newFormat;
-    return;
 }
 
 void RedirectablePrint::hexDump(const char *logLevel, unsigned char *buf, uint16_t len)
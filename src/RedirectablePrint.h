@@ -6,6 +6,10 @@
 #include <stdarg.h>
 #include <string>
 
+#ifdef ARCH_PORTDUINO
+class DeferredLog;
+#endif
+
 /**
  * A Printable that can be switched to squirt its bytes to a different sink.
  * This class is mostly useful to allow debug printing to be redirected away from Serial
@@ -20,6 +24,9 @@ class RedirectablePrint : public Print
     StaticSemaphore_t _MutexStorageSpace;
 #else
     volatile bool inDebugPrint = false;
+#endif
+#ifdef ARCH_PORTDUINO
+    DeferredLog *deferredLog = nullptr;
 #endif
   public:
     explicit RedirectablePrint(Print *_dest) : dest(_dest) {}
@@ -48,12 +55,26 @@ class RedirectablePrint : public Print
 
     std::string mt_sprintf(const std::string fmt_str, ...);
 
+    /// Write one already formatted log line with its header, used by the deferred log writer
+    void writeLogLine(const char *logLevel, uint32_t rtc_sec, uint32_t uptimeMsec, const char *threadName, char *text,
+                      size_t len);
+
+#ifdef ARCH_PORTDUINO
+    /// Wait for the deferred log writer to catch up, if deferred logging is enabled
+    void flushDeferredLog();
+#endif
+
   protected:
     /// Subclasses can override if they need to change how we format over the serial port
     virtual void log_to_serial(const char *logLevel, const char *format, va_list arg);
     meshtastic_LogRecord_Level getLogLevel(const char *logLevel);
 
-  private:
-    void log_to_syslog(const char *logLevel, const char *format, va_list arg);
-    void log_to_ble(const char *logLevel, const char *format, va_list arg);
+    /// The MESHTASTIC_LOG_LEVEL_* strings all start with a different letter, so that is all we need to compare
+    static inline bool isLevel(const char *logLevel, const char *level) { return logLevel[0] == level[0]; }
+
+    void printLogHeader(const char *logLevel, uint32_t rtc_sec, uint32_t uptimeMsec, const char *threadName);
+    size_t writeLogBody(const char *logLevel, char *text, size_t len);
+
+    virtual void log_to_syslog(const char *logLevel, const char *format, va_list arg);
+    virtual void log_to_ble(const char *logLevel, const char *format, va_list arg);
 };
\ No newline at end of file
@@ -31,6 +31,30 @@ void AirTime::logAirtime(reportTypes reportType, uint32_t airtime_ms)
     this->channelUtilization[this->getPeriodUtilMinute()] = channelUtilization[this->getPeriodUtilMinute()] + airtime_ms;
 }
 
+void AirTime::rememberPortnum(uint32_t from, uint32_t id, uint32_t portnum)
+{
+    for (KnownPortnum &k : knownPortnums) {
+        if (k.from == from && k.id == id) {
+            k.portnum = portnum;
+            return;
+        }
+    }
+    knownPortnums[nextKnownPortnum] = {from, id, portnum};
+    nextKnownPortnum = (nextKnownPortnum + 1) % AIRTIME_KNOWN_PORTNUMS;
+}
+
+void AirTime::logTransmitAirtime(uint32_t from, uint32_t id, uint32_t airtime_ms)
+{
+    logAirtime(TX_LOG, airtime_ms);
+    topSenders.add(from, airtime_ms);
+    for (const KnownPortnum &k : knownPortnums) {
+        if (id != 0 && k.id == id && k.from == from) {
+            topPortnums.add(k.portnum, airtime_ms);
+            return;
+        }
+    }
+}
+
 uint8_t AirTime::currentPeriodIndex()
 {
     return ((getSecondsSinceBoot() / SECONDS_PER_PERIOD) % PERIODS_TO_LOG);
@@ -68,10 +92,34 @@ void AirTime::airtimeRotatePeriod()
         air_period_tx[0] = 0;
         air_period_rx[0] = 0;
 
+        char top[80];
+        formatTopSenders(top, sizeof(top));
+        if (*top)
+            LOG_INFO("Top airtime senders last period: %s", top);
+        topSenders.decay();
+        topPortnums.decay();
+
         this->airtimes.lastPeriodIndex = this->currentPeriodIndex();
     }
 }
 
+void AirTime::formatTopSenders(char *buf, size_t bufLen, size_t maxSenders)
+{
+    AirtimeTopTalkers<AIRTIME_TOP_SENDERS>::Entry top[AIRTIME_TOP_SENDERS];
+    size_t n = topSenders.getSorted(top, min(maxSenders, (size_t)AIRTIME_TOP_SENDERS));
+    uint32_t total = topSenders.getTotal();
+
+    size_t used = 0;
+    buf[0] = '\0';
+    for (size_t i = 0; i < n && used < bufLen; i++) {
+        int len = snprintf(buf + used, bufLen - used, "%s!%08x %u%%", i ? " " : "", top[i].key,
+                           total ? (unsigned)((uint64_t)top[i].airtimeMs * 100 / total) : 0);
+        if (len < 0)
+            break;
+        used += len;
+    }
+}
+
 uint32_t *AirTime::airtimeReport(reportTypes reportType)
 {
 
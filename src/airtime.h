@@ -33,8 +33,91 @@
 #define MS_IN_MINUTE (SECONDS_IN_MINUTE * 1000)
 #define MS_IN_HOUR (MINUTES_IN_HOUR * SECONDS_IN_MINUTE * 1000)
 
+#define AIRTIME_TOP_SENDERS 16
+#define AIRTIME_TOP_PORTNUMS 8
+#define AIRTIME_KNOWN_PORTNUMS 16 // How many recent packets we remember the portnum of, to charge it when they are transmitted
+
 enum reportTypes { TX_LOG, RX_LOG, RX_ALL_LOG };
 
+/**
+ * A bounded heavy-hitter counter ("space saving" algorithm) used to find which senders and portnums use the most airtime.
+ *
+ * At most N keys are tracked.  When a new key arrives and the table is full it takes over the slot with the smallest count and
+ * inherits that count as its error bound, so any key responsible for more than 1/N of the total airtime is guaranteed to be
+ * listed, and its count overestimates the real value by at most errorMs.
+ */
+template <size_t N> class AirtimeTopTalkers
+{
+  public:
+    struct Entry {
+        uint32_t key;
+        uint32_t airtimeMs;
+        uint32_t errorMs;
+    };
+
+    void add(uint32_t key, uint32_t airtime_ms)
+    {
+        total += airtime_ms;
+
+        size_t smallest = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (entries[i].key == key) {
+                entries[i].airtimeMs += airtime_ms;
+                return;
+            }
+            if (entries[i].airtimeMs < entries[smallest].airtimeMs)
+                smallest = i;
+        }
+
+        if (count < N) {
+            entries[count++] = {key, airtime_ms, 0};
+        } else {
+            Entry &e = entries[smallest];
+            e.errorMs = e.airtimeMs;
+            e.key = key;
+            e.airtimeMs += airtime_ms;
+        }
+    }
+
+    /// Halve all counts, so the ranking follows recent traffic
+    void decay()
+    {
+        total /= 2;
+        for (size_t i = 0; i < count; i++) {
+            entries[i].airtimeMs /= 2;
+            entries[i].errorMs /= 2;
+        }
+    }
+
+    /// Copy up to max entries into out, largest airtime first. Returns the number copied.
+    size_t getSorted(Entry *out, size_t max) const
+    {
+        size_t n = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (entries[i].airtimeMs == 0)
+                continue;
+            // insertion sort, N is small
+            size_t j = n < max ? n++ : max;
+            while (j > 0 && out[j - 1].airtimeMs < entries[i].airtimeMs) {
+                if (j < max)
+                    out[j] = out[j - 1];
+                j--;
+            }
+            if (j < max)
+                out[j] = entries[i];
+        }
+        return n;
+    }
+
+    /// Total airtime added, including keys that are no longer tracked
+    uint32_t getTotal() const { return total; }
+
+  private:
+    Entry entries[N] = {};
+    size_t count = 0;
+    uint32_t total = 0;
+};
+
 void logAirtime(reportTypes reportType, uint32_t airtime_ms);
 
 uint32_t *airtimeReport(reportTypes reportType);
@@ -46,6 +129,29 @@ class AirTime : private concurrency::OSThread
     AirTime();
 
     void logAirtime(reportTypes reportType, uint32_t airtime_ms);
+
+    /// Attribute airtime of a packet we received or transmitted to its original sender
+    void logSenderAirtime(uint32_t from, uint32_t airtime_ms) { topSenders.add(from, airtime_ms); }
+
+    /// Attribute airtime to the portnum of a packet, once it is known (i.e. the packet was decoded)
+    void logPortnumAirtime(uint32_t portnum, uint32_t airtime_ms) { topPortnums.add(portnum, airtime_ms); }
+
+    /// Remember the portnum of a packet we decoded or encoded, so logTransmitAirtime() can charge it once it goes out encrypted
+    void rememberPortnum(uint32_t from, uint32_t id, uint32_t portnum);
+
+    /**
+     * Count a packet we just transmitted towards our TX airtime, its original sender and, if rememberPortnum() saw it, its
+     * portnum. Relayed packets are included, but only reach the portnum table if we could decode them.
+     */
+    void logTransmitAirtime(uint32_t from, uint32_t id, uint32_t airtime_ms);
+
+    /// The senders and portnums using the most airtime, decayed by half every period
+    AirtimeTopTalkers<AIRTIME_TOP_SENDERS> topSenders;
+    AirtimeTopTalkers<AIRTIME_TOP_PORTNUMS> topPortnums;
+
+    /// Write a one line summary of the top senders, e.g. "!a1b2c3d4 41% !0badf00d 12%", into buf
+    void formatTopSenders(char *buf, size_t bufLen, size_t maxSenders = 4);
+
     float channelUtilizationPercent();
     float utilizationTXPercent();
 
@@ -71,6 +177,14 @@ class AirTime : private concurrency::OSThread
     uint8_t polite_channel_util_percent = 25;
     uint8_t polite_duty_cycle_percent = 50; // half of Duty Cycle allowance is ok for metadata
 
+    struct KnownPortnum {
+        uint32_t from;
+        uint32_t id;
+        uint32_t portnum;
+    };
+    KnownPortnum knownPortnums[AIRTIME_KNOWN_PORTNUMS] = {};
+    uint8_t nextKnownPortnum = 0;
+
     struct airtimeStruct {
         uint32_t periodTX[PERIODS_TO_LOG];     // AirTime transmitted
         uint32_t periodRX[PERIODS_TO_LOG];     // AirTime received and repeated (Only valid mesh packets)
@@ -19,6 +19,7 @@
 #include "sleep.h"
 
 #include "GPSUpdateScheduling.h"
+#include "UBXFrameParser.h"
 #include "cas.h"
 #include "ubx.h"
 
@@ -67,6 +68,8 @@ static struct uBloxGnssModelInfo {
     uint8_t protocol_version;
 } ublox_info;
 
+// How often runOnce() checks for the ACK of a configuration command. Well inside what the UART buffer holds at 115200 baud
+#define GPS_ACK_POLL_INTERVAL 5
 #define GPS_SOL_EXPIRY_MS 5000 // in millis. give 1 second time to combine different sentences. NMEA Frequency isn't higher anyway
 #define NMEA_MSG_GXGSA "GNGSA" // GSA message (GPGSA, GNGSA etc)
 
@@ -253,6 +256,8 @@ GPS_RESPONSE GPS::getACK(const char *message, uint32_t waitMillis)
 #endif
                 }
             }
+        } else {
+            delay(1); // Nothing waiting, let other tasks run rather than spinning on available()
         }
     }
     return GNSS_RESPONSE_NONE;
@@ -284,6 +289,8 @@ GPS_RESPONSE GPS::getACKCas(uint8_t class_id, uint8_t msg_id, uint32_t waitMilli
                 buffer[1] = 0;
                 bufferPos = 1;
             }
+        } else {
+            delay(1);
         }
 
         // we have read all the bytes required for the Ack/Nack (14-bytes)
@@ -319,12 +326,24 @@ GPS_RESPONSE GPS::getACKCas(uint8_t class_id, uint8_t msg_id, uint32_t waitMilli
     return GNSS_RESPONSE_NONE;
 }
 
+// Read whatever the UART is already holding, up to size bytes, without waiting for more to arrive
+size_t GPS::readAvailable(uint8_t *buffer, size_t size)
+{
+    int available = _serial_gps->available();
+    if (available <= 0)
+        return 0;
+
+    size_t length = ((size_t)available < size) ? available : size;
+    return _serial_gps->readBytes(buffer, length);
+}
+
 GPS_RESPONSE GPS::getACK(uint8_t class_id, uint8_t msg_id, uint32_t waitMillis)
 {
-    uint8_t b;
-    uint8_t ack = 0;
-    const uint8_t ackP[2] = {class_id, msg_id};
-    uint8_t buf[10] = {0xB5, 0x62, 0x05, 0x01, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00};
+    uint8_t chunk[64];
+    // UBX-ACK-ACK and UBX-ACK-NAK carry the class and ID of the message they answer.
+    // Sizing the buffer to that means the parser skips over every longer frame without buffering it.
+    uint8_t ackPayload[2];
+    UBXFrameParser parser(ackPayload, sizeof(ackPayload));
     uint32_t startTime = millis();
     const char frame_errors[] = "More than 100 frame errors";
     int sCounter = 0;
@@ -332,31 +351,18 @@ GPS_RESPONSE GPS::getACK(uint8_t class_id, uint8_t msg_id, uint32_t waitMillis)
     std::string debugmsg = "";
 #endif
 
-    for (int j = 2; j < 6; j++) {
-        buf[8] += buf[j];
-        buf[9] += buf[8];
-    }
-
-    for (int j = 0; j < 2; j++) {
-        buf[6 + j] = ackP[j];
-        buf[8] += buf[6 + j];
-        buf[9] += buf[8];
-    }
-
     while (Throttle::isWithinTimespanMs(startTime, waitMillis)) {
-        if (ack > 9) {
-#ifdef GPS_DEBUG
-            LOG_INFO("Got ACK for class %02X message %02X in %dms", class_id, msg_id, millis() - startTime);
-#endif
-            return GNSS_RESPONSE_OK; // ACK received
+        size_t length = readAvailable(chunk, sizeof(chunk));
+        if (length == 0) {
+            delay(1); // Nothing waiting. At 115200 baud the UART buffer holds far more than a millisecond of data
+            continue;
         }
-        if (_serial_gps->available()) {
-            b = _serial_gps->read();
-            if (b == frame_errors[sCounter]) {
+
+        for (size_t i = 0; i < length; i++) {
+            if (chunk[i] == frame_errors[sCounter]) {
                 sCounter++;
                 if (sCounter == 26) {
 #ifdef GPS_DEBUG
-
                     LOG_DEBUG(debugmsg.c_str());
 #endif
                     return GNSS_RESPONSE_FRAME_ERRORS;
@@ -365,19 +371,32 @@ GPS_RESPONSE GPS::getACK(uint8_t class_id, uint8_t msg_id, uint32_t waitMillis)
                 sCounter = 0;
             }
 #ifdef GPS_DEBUG
-            debugmsg += vformat("%02X", b);
+            debugmsg += vformat("%02X", chunk[i]);
 #endif
-            if (b == buf[ack]) {
-                ack++;
-            } else {
-                if (ack == 3 && b == 0x00) { // UBX-ACK-NAK message
+        }
+
+        size_t position = 0;
+        while (position < length) {
+            position += parser.feed(chunk + position, length - position);
+
+            // Only an ACK class frame, answering the message we sent, is of interest
+            if (!parser.hasFrame() || parser.msgClass() != 0x05 || parser.payloadLength() != 2)
+                continue;
+            if (ackPayload[0] != class_id || ackPayload[1] != msg_id)
+                continue;
+
+            if (parser.msgId() == 0x01) {
 #ifdef GPS_DEBUG
-                    LOG_DEBUG(debugmsg.c_str());
+                LOG_INFO("Got ACK for class %02X message %02X in %dms", class_id, msg_id, millis() - startTime);
 #endif
-                    LOG_WARN("Got NAK for class %02X message %02X", class_id, msg_id);
-                    return GNSS_RESPONSE_NAK; // NAK received
-                }
-                ack = 0; // Reset the acknowledgement counter
+                return GNSS_RESPONSE_OK; // ACK received
+            }
+            if (parser.msgId() == 0x00) { // UBX-ACK-NAK message
+#ifdef GPS_DEBUG
+                LOG_DEBUG(debugmsg.c_str());
+#endif
+                LOG_WARN("Got NAK for class %02X message %02X", class_id, msg_id);
+                return GNSS_RESPONSE_NAK; // NAK received
             }
         }
     }
@@ -388,6 +407,75 @@ GPS_RESPONSE GPS::getACK(uint8_t class_id, uint8_t msg_id, uint32_t waitMillis)
     return GNSS_RESPONSE_NONE; // No response received within timeout
 }
 
+void GPS::queueUBXPacket(uint8_t msgClass, uint8_t msgId, const uint8_t *payload, uint8_t payloadSize, const char *description,
+                         uint16_t timeoutMs, const char *successMessage)
+{
+    ubxConfig.push_back({UBXConfigStep::SEND, msgClass, msgId, payloadSize, payload, timeoutMs, description, successMessage});
+}
+
+int32_t GPS::runUBXConfig()
+{
+    const UBXConfigStep &step = ubxConfig[ubxConfigNext];
+    if (step.kind == UBXConfigStep::CLEAR) {
+        clearBuffer();
+        ubxConfigNext++;
+        return 0;
+    }
+    if (step.kind == UBXConfigStep::WAIT) {
+        ubxConfigNext++;
+        return step.ms;
+    }
+
+    if (!ubxConfigAwaitingAck) {
+        ubxAckParser.reset();
+        uint8_t msglen = makeUBXPacket(step.msgClass, step.msgId, step.payloadSize, step.payload);
+        _serial_gps->write(UBXscratch, msglen);
+        ubxConfigSentAt = millis();
+        ubxConfigAwaitingAck = true;
+        return GPS_ACK_POLL_INTERVAL;
+    }
+
+    GPS_RESPONSE response = pollACK(step.msgClass, step.msgId);
+    if (response == GNSS_RESPONSE_NONE && Throttle::isWithinTimespanMs(ubxConfigSentAt, step.ms))
+        return GPS_ACK_POLL_INTERVAL;
+
+    if (response == GNSS_RESPONSE_OK) {
+        if (step.successMessage)
+            LOG_INFO(step.successMessage);
+    } else {
+        LOG_WARN(failMessage, step.description);
+    }
+    ubxConfigAwaitingAck = false;
+    ubxConfigNext++;
+    return 0;
+}
+
+GPS_RESPONSE GPS::pollACK(uint8_t class_id, uint8_t msg_id)
+{
+    uint8_t chunk[64];
+    size_t length;
+    while ((length = readAvailable(chunk, sizeof(chunk))) > 0) {
+        size_t position = 0;
+        while (position < length) {
+            position += ubxAckParser.feed(chunk + position, length - position);
+
+            // Same matching as getACK(), but the parser carries any partial frame over to the next poll
+            if (!ubxAckParser.hasFrame() || ubxAckParser.msgClass() != 0x05 || ubxAckParser.payloadLength() != 2)
+                continue;
+            if (ubxAckPayload[0] != class_id || ubxAckPayload[1] != msg_id)
+                continue;
+
+            if (ubxAckParser.msgId() == 0x01)
+                return GNSS_RESPONSE_OK;
+            if (ubxAckParser.msgId() == 0x00) {
+                LOG_WARN("Got NAK for class %02X message %02X", class_id, msg_id);
+                return GNSS_RESPONSE_NAK;
+            }
+        }
+    }
+    return GNSS_RESPONSE_NONE;
+}
+
 /**
  * @brief
  * @note   New method, this method can wait for the specified class and message ID, and return the payload
@@ -399,72 +487,31 @@ GPS_RESPONSE GPS::getACK(uint8_t class_id, uint8_t msg_id, uint32_t waitMillis)
  */
 int GPS::getACK(uint8_t *buffer, uint16_t size, uint8_t requestedClass, uint8_t requestedID, uint32_t waitMillis)
 {
-    uint16_t ubxFrameCounter = 0;
+    uint8_t chunk[64];
+    // Keep the last byte of the buffer free, so the payload stays terminated by the caller's memset
+    UBXFrameParser parser(buffer, size - 1);
     uint32_t startTime = millis();
-    uint16_t needRead = 0;
 
     while (Throttle::isWithinTimespanMs(startTime, waitMillis)) {
-        if (_serial_gps->available()) {
-            int c = _serial_gps->read();
-            switch (ubxFrameCounter) {
-            case 0:
-                // ubxFrame 'μ'
-                if (c == 0xB5) {
-                    ubxFrameCounter++;
-                }
-                break;
-            case 1:
-                // ubxFrame 'b'
-                if (c == 0x62) {
-                    ubxFrameCounter++;
-                } else {
-                    ubxFrameCounter = 0;
-                }
-                break;
-            case 2:
-                // Class
-                if (c == requestedClass) {
-                    ubxFrameCounter++;
-                } else {
-                    ubxFrameCounter = 0;
-                }
-                break;
-            case 3:
-                // Message ID
-                if (c == requestedID) {
-                    ubxFrameCounter++;
-                } else {
-                    ubxFrameCounter = 0;
-                }
-                break;
-            case 4:
-                // Payload length lsb
-                needRead = c;
-                ubxFrameCounter++;
-                break;
-            case 5:
-                // Payload length msb
-                needRead |= (c << 8);
-                ubxFrameCounter++;
-                // Check for buffer overflow
-                if (needRead >= size) {
-                    ubxFrameCounter = 0;
-                    break;
-                }
-                if (_serial_gps->readBytes(buffer, needRead) != needRead) {
-                    ubxFrameCounter = 0;
-                } else {
-                    // return payload length
+        size_t length = readAvailable(chunk, sizeof(chunk));
+        if (length == 0) {
+            delay(1);
+            continue;
+        }
+
+        size_t position = 0;
+        while (position < length) {
+            position += parser.feed(chunk + position, length - position);
+
+            // The parser skips anything too long for the buffer
+            if (!parser.hasFrame() || parser.msgClass() != requestedClass || parser.msgId() != requestedID)
+                continue;
+
+            // return payload length
 #ifdef GPS_DEBUG
-                    LOG_INFO("Got ACK for class %02X message %02X in %dms", requestedClass, requestedID, millis() - startTime);
+            LOG_INFO("Got ACK for class %02X message %02X in %dms", requestedClass, requestedID, millis() - startTime);
 #endif
-                    return needRead;
-                }
-                break;
-
-            default:
-                break;
-            }
+            return parser.payloadLength();
         }
     }
     return 0;
@@ -665,149 +712,124 @@ bool GPS::setup()
             delay(250);
             _serial_gps->write("$PAIR513*3D\r\n"); // save configuration
         } else if (gnssModel == GNSS_MODEL_UBLOX6) {
-            clearBuffer();
-            SEND_UBX_PACKET(0x06, 0x02, _message_DISABLE_TXT_INFO, "disable text info messages", 500);
-            SEND_UBX_PACKET(0x06, 0x39, _message_JAM_6_7, "enable interference resistance", 500);
-            SEND_UBX_PACKET(0x06, 0x23, _message_NAVX5, "configure NAVX5 settings", 500);
+            queueUBXClear();
+            QUEUE_UBX_PACKET(0x06, 0x02, _message_DISABLE_TXT_INFO, "disable text info messages", 500);
+            QUEUE_UBX_PACKET(0x06, 0x39, _message_JAM_6_7, "enable interference resistance", 500);
+            QUEUE_UBX_PACKET(0x06, 0x23, _message_NAVX5, "configure NAVX5 settings", 500);
 
             // Turn off unwanted NMEA messages, set update rate
-            SEND_UBX_PACKET(0x06, 0x08, _message_1HZ, "set GPS update rate", 500);
-            SEND_UBX_PACKET(0x06, 0x01, _message_GLL, "disable NMEA GLL", 500);
-            SEND_UBX_PACKET(0x06, 0x01, _message_GSA, "enable NMEA GSA", 500);
-            SEND_UBX_PACKET(0x06, 0x01, _message_GSV, "disable NMEA GSV", 500);
-            SEND_UBX_PACKET(0x06, 0x01, _message_VTG, "disable NMEA VTG", 500);
-            SEND_UBX_PACKET(0x06, 0x01, _message_RMC, "enable NMEA RMC", 500);
-            SEND_UBX_PACKET(0x06, 0x01, _message_GGA, "enable NMEA GGA", 500);
-
-            clearBuffer();
-            SEND_UBX_PACKET(0x06, 0x11, _message_CFG_RXM_ECO, "enable powersave ECO mode for Neo-6", 500);
-            SEND_UBX_PACKET(0x06, 0x3B, _message_CFG_PM2, "enable powersave details for GPS", 500);
-            SEND_UBX_PACKET(0x06, 0x01, _message_AID, "disable UBX-AID", 500);
-
-            msglen = makeUBXPacket(0x06, 0x09, sizeof(_message_SAVE), _message_SAVE);
-            _serial_gps->write(UBXscratch, msglen);
-            if (getACK(0x06, 0x09, 2000) != GNSS_RESPONSE_OK) {
-                LOG_WARN("Unable to save GNSS module config");
-            } else {
-                LOG_INFO("GNSS module config saved!");
-            }
+            QUEUE_UBX_PACKET(0x06, 0x08, _message_1HZ, "set GPS update rate", 500);
+            QUEUE_UBX_PACKET(0x06, 0x01, _message_GLL, "disable NMEA GLL", 500);
+            QUEUE_UBX_PACKET(0x06, 0x01, _message_GSA, "enable NMEA GSA", 500);
+            QUEUE_UBX_PACKET(0x06, 0x01, _message_GSV, "disable NMEA GSV", 500);
+            QUEUE_UBX_PACKET(0x06, 0x01, _message_VTG, "disable NMEA VTG", 500);
+            QUEUE_UBX_PACKET(0x06, 0x01, _message_RMC, "enable NMEA RMC", 500);
+            QUEUE_UBX_PACKET(0x06, 0x01, _message_GGA, "enable NMEA GGA", 500);
+
+            queueUBXClear();
+            QUEUE_UBX_PACKET(0x06, 0x11, _message_CFG_RXM_ECO, "enable powersave ECO mode for Neo-6", 500);
+            QUEUE_UBX_PACKET(0x06, 0x3B, _message_CFG_PM2, "enable powersave details for GPS", 500);
+            QUEUE_UBX_PACKET(0x06, 0x01, _message_AID, "disable UBX-AID", 500);
+
+            queueUBXPacket(0x06, 0x09, _message_SAVE, sizeof(_message_SAVE), "save GNSS module config", 2000,
+                           "GNSS module config saved!");
         } else if (IS_ONE_OF(gnssModel, GNSS_MODEL_UBLOX7, GNSS_MODEL_UBLOX8, GNSS_MODEL_UBLOX9)) {
             if (gnssModel == GNSS_MODEL_UBLOX7) {
                 LOG_DEBUG("Set GPS+SBAS");
-                msglen = makeUBXPacket(0x06, 0x3e, sizeof(_message_GNSS_7), _message_GNSS_7);
-                _serial_gps->write(UBXscratch, msglen);
+                queueUBXPacket(0x06, 0x3e, _message_GNSS_7, sizeof(_message_GNSS_7), "reconfigure GNSS, defaults maintained", 800,
+                               "GPS+SBAS configured");
             } else { // 8,9
-                msglen = makeUBXPacket(0x06, 0x3e, sizeof(_message_GNSS_8), _message_GNSS_8);
-                _serial_gps->write(UBXscratch, msglen);
-            }
-
-            if (getACK(0x06, 0x3e, 800) == GNSS_RESPONSE_NAK) {
-                // It's not critical if the module doesn't acknowledge this configuration.
-                LOG_DEBUG("reconfigure GNSS - defaults maintained. Is this module GPS-only?");
-            } else {
-                if (gnssModel == GNSS_MODEL_UBLOX7) {
-                    LOG_INFO("GPS+SBAS configured");
-                } else { // 8,9
-                    LOG_INFO("GPS+SBAS+GLONASS+Galileo configured");
-                }
-                // Documentation say, we need wait atleast 0.5s after reconfiguration of GNSS module, before sending next
-                // commands for the M8 it tends to be more... 1 sec should be enough ;>)
-                delay(1000);
+                queueUBXPacket(0x06, 0x3e, _message_GNSS_8, sizeof(_message_GNSS_8), "reconfigure GNSS, defaults maintained", 800,
+                               "GPS+SBAS+GLONASS+Galileo configured");
             }
+            // It's not critical if the module doesn't acknowledge this configuration, it may just be GPS-only.
+            // Documentation say, we need wait atleast 0.5s after reconfiguration of GNSS module, before sending next
+            // commands for the M8 it tends to be more... 1 sec should be enough ;>)
+            queueUBXWait(1000);
 
             // Disable Text Info messages //6,7,8,9
-            clearBuffer();
-            SEND_UBX_PACKET(0x06, 0x02, _message_DISABLE_TXT_INFO, "disable text info messages", 500);
+            queueUBXClear();
+            QUEUE_UBX_PACKET(0x06, 0x02, _message_DISABLE_TXT_INFO, "disable text info messages", 500);
 
             if (gnssModel == GNSS_MODEL_UBLOX8) { // 8
-                clearBuffer();
-                SEND_UBX_PACKET(0x06, 0x39, _message_JAM_8, "enable interference resistance", 500);
+                queueUBXClear();
+                QUEUE_UBX_PACKET(0x06, 0x39, _message_JAM_8, "enable interference resistance", 500);
 
-                clearBuffer();
-                SEND_UBX_PACKET(0x06, 0x23, _message_NAVX5_8, "configure NAVX5_8 settings", 500);
+                queueUBXClear();
+                QUEUE_UBX_PACKET(0x06, 0x23, _message_NAVX5_8, "configure NAVX5_8 settings", 500);
             } else { // 6,7,9
-                SEND_UBX_PACKET(0x06, 0x39, _message_JAM_6_7, "enable interference resistance", 500);
-                SEND_UBX_PACKET(0x06, 0x23, _message_NAVX5, "configure NAVX5 settings", 500);
+                QUEUE_UBX_PACKET(0x06, 0x39, _message_JAM_6_7, "enable interference resistance", 500);
+                QUEUE_UBX_PACKET(0x06, 0x23, _message_NAVX5, "configure NAVX5 settings", 500);
             }
             // Turn off unwanted NMEA messages, set update rate
-            SEND_UBX_PACKET(0x06, 0x08, _message_1HZ, "set GPS update rate", 500);
-            SEND_UBX_PACKET(0x06, 0x01, _message_GLL, "disable NMEA GLL", 500);
-            SEND_UBX_PACKET(0x06, 0x01, _message_GSA, "enable NMEA GSA", 500);
-            SEND_UBX_PACKET(0x06, 0x01, _message_GSV, "disable NMEA GSV", 500);
-            SEND_UBX_PACKET(0x06, 0x01, _message_VTG, "disable NMEA VTG", 500);
-            SEND_UBX_PACKET(0x06, 0x01, _message_RMC, "enable NMEA RMC", 500);
-            SEND_UBX_PACKET(0x06, 0x01, _message_GGA, "enable NMEA GGA", 500);
+            QUEUE_UBX_PACKET(0x06, 0x08, _message_1HZ, "set GPS update rate", 500);
+            QUEUE_UBX_PACKET(0x06, 0x01, _message_GLL, "disable NMEA GLL", 500);
+            QUEUE_UBX_PACKET(0x06, 0x01, _message_GSA, "enable NMEA GSA", 500);
+            QUEUE_UBX_PACKET(0x06, 0x01, _message_GSV, "disable NMEA GSV", 500);
+            QUEUE_UBX_PACKET(0x06, 0x01, _message_VTG, "disable NMEA VTG", 500);
+            QUEUE_UBX_PACKET(0x06, 0x01, _message_RMC, "enable NMEA RMC", 500);
+            QUEUE_UBX_PACKET(0x06, 0x01, _message_GGA, "enable NMEA GGA", 500);
 
             if (ublox_info.protocol_version >= 18) {
-                clearBuffer();
-                SEND_UBX_PACKET(0x06, 0x86, _message_PMS, "enable powersave for GPS", 500);
-                SEND_UBX_PACKET(0x06, 0x3B, _message_CFG_PM2, "enable powersave details for GPS", 500);
+                queueUBXClear();
+                QUEUE_UBX_PACKET(0x06, 0x86, _message_PMS, "enable powersave for GPS", 500);
+                QUEUE_UBX_PACKET(0x06, 0x3B, _message_CFG_PM2, "enable powersave details for GPS", 500);
 
                 // For M8 we want to enable NMEA vserion 4.10 so we can see the additional sats.
                 if (gnssModel == GNSS_MODEL_UBLOX8) {
-                    clearBuffer();
-                    SEND_UBX_PACKET(0x06, 0x17, _message_NMEA, "enable NMEA 4.10", 500);
+                    queueUBXClear();
+                    QUEUE_UBX_PACKET(0x06, 0x17, _message_NMEA, "enable NMEA 4.10", 500);
                 }
             } else {
-                SEND_UBX_PACKET(0x06, 0x11, _message_CFG_RXM_PSM, "enable powersave mode for GPS", 500);
-                SEND_UBX_PACKET(0x06, 0x3B, _message_CFG_PM2, "enable powersave details for GPS", 500);
+                QUEUE_UBX_PACKET(0x06, 0x11, _message_CFG_RXM_PSM, "enable powersave mode for GPS", 500);
+                QUEUE_UBX_PACKET(0x06, 0x3B, _message_CFG_PM2, "enable powersave details for GPS", 500);
             }
 
-            msglen = makeUBXPacket(0x06, 0x09, sizeof(_message_SAVE), _message_SAVE);
-            _serial_gps->write(UBXscratch, msglen);
-            if (getACK(0x06, 0x09, 2000) != GNSS_RESPONSE_OK) {
-                LOG_WARN("Unable to save GNSS module config");
-            } else {
-                LOG_INFO("GNSS module configuration saved!");
-            }
+            queueUBXPacket(0x06, 0x09, _message_SAVE, sizeof(_message_SAVE), "save GNSS module config", 2000,
+                           "GNSS module configuration saved!");
         } else if (gnssModel == GNSS_MODEL_UBLOX10) {
-            delay(1000);
-            clearBuffer();
-            SEND_UBX_PACKET(0x06, 0x8A, _message_VALSET_DISABLE_NMEA_RAM, "disable NMEA messages in M10 RAM", 300);
-            delay(750);
-            clearBuffer();
-            SEND_UBX_PACKET(0x06, 0x8A, _message_VALSET_DISABLE_NMEA_BBR, "disable NMEA messages in M10 BBR", 300);
-            delay(750);
-            clearBuffer();
-            SEND_UBX_PACKET(0x06, 0x8A, _message_VALSET_DISABLE_TXT_INFO_RAM, "disable Info messages for M10 GPS RAM", 300);
-            delay(750);
+            queueUBXWait(1000);
+            queueUBXClear();
+            QUEUE_UBX_PACKET(0x06, 0x8A, _message_VALSET_DISABLE_NMEA_RAM, "disable NMEA messages in M10 RAM", 300);
+            queueUBXWait(750);
+            queueUBXClear();
+            QUEUE_UBX_PACKET(0x06, 0x8A, _message_VALSET_DISABLE_NMEA_BBR, "disable NMEA messages in M10 BBR", 300);
+            queueUBXWait(750);
+            queueUBXClear();
+            QUEUE_UBX_PACKET(0x06, 0x8A, _message_VALSET_DISABLE_TXT_INFO_RAM, "disable Info messages for M10 GPS RAM", 300);
+            queueUBXWait(750);
             // Next disable Info txt messages in BBR layer
-            clearBuffer();
-            SEND_UBX_PACKET(0x06, 0x8A, _message_VALSET_DISABLE_TXT_INFO_BBR, "disable Info messages for M10 GPS BBR", 300);
-            delay(750);
+            queueUBXClear();
+            QUEUE_UBX_PACKET(0x06, 0x8A, _message_VALSET_DISABLE_TXT_INFO_BBR, "disable Info messages for M10 GPS BBR", 300);
+            queueUBXWait(750);
             // Do M10 configuration for Power Management.
-            SEND_UBX_PACKET(0x06, 0x8A, _message_VALSET_PM_RAM, "enable powersave for M10 GPS RAM", 300);
-            delay(750);
-            SEND_UBX_PACKET(0x06, 0x8A, _message_VALSET_PM_BBR, "enable powersave for M10 GPS BBR", 300);
-            delay(750);
-            SEND_UBX_PACKET(0x06, 0x8A, _message_VALSET_ITFM_RAM, "enable jam detection M10 GPS RAM", 300);
-            delay(750);
-            SEND_UBX_PACKET(0x06, 0x8A, _message_VALSET_ITFM_BBR, "enable jam detection M10 GPS BBR", 300);
-            delay(750);
+            QUEUE_UBX_PACKET(0x06, 0x8A, _message_VALSET_PM_RAM, "enable powersave for M10 GPS RAM", 300);
+            queueUBXWait(750);
+            QUEUE_UBX_PACKET(0x06, 0x8A, _message_VALSET_PM_BBR, "enable powersave for M10 GPS BBR", 300);
+            queueUBXWait(750);
+            QUEUE_UBX_PACKET(0x06, 0x8A, _message_VALSET_ITFM_RAM, "enable jam detection M10 GPS RAM", 300);
+            queueUBXWait(750);
+            QUEUE_UBX_PACKET(0x06, 0x8A, _message_VALSET_ITFM_BBR, "enable jam detection M10 GPS BBR", 300);
+            queueUBXWait(750);
             // Here is where the init commands should go to do further M10 initialization.
-            SEND_UBX_PACKET(0x06, 0x8A, _message_VALSET_DISABLE_SBAS_RAM, "disable SBAS M10 GPS RAM", 300);
-            delay(750); // will cause a receiver restart so wait a bit
-            SEND_UBX_PACKET(0x06, 0x8A, _message_VALSET_DISABLE_SBAS_BBR, "disable SBAS M10 GPS BBR", 300);
-            delay(750); // will cause a receiver restart so wait a bit
+            QUEUE_UBX_PACKET(0x06, 0x8A, _message_VALSET_DISABLE_SBAS_RAM, "disable SBAS M10 GPS RAM", 300);
+            queueUBXWait(750); // will cause a receiver restart so wait a bit
+            QUEUE_UBX_PACKET(0x06, 0x8A, _message_VALSET_DISABLE_SBAS_BBR, "disable SBAS M10 GPS BBR", 300);
+            queueUBXWait(750); // will cause a receiver restart so wait a bit
 
             // Done with initialization, Now enable wanted NMEA messages in BBR layer so they will survive a periodic
             // sleep.
-            SEND_UBX_PACKET(0x06, 0x8A, _message_VALSET_ENABLE_NMEA_BBR, "enable messages for M10 GPS BBR", 300);
-            delay(750);
+            QUEUE_UBX_PACKET(0x06, 0x8A, _message_VALSET_ENABLE_NMEA_BBR, "enable messages for M10 GPS BBR", 300);
+            queueUBXWait(750);
             // Next enable wanted NMEA messages in RAM layer
-            SEND_UBX_PACKET(0x06, 0x8A, _message_VALSET_ENABLE_NMEA_RAM, "enable messages for M10 GPS RAM", 500);
-            delay(750);
+            QUEUE_UBX_PACKET(0x06, 0x8A, _message_VALSET_ENABLE_NMEA_RAM, "enable messages for M10 GPS RAM", 500);
+            queueUBXWait(750);
 
             // As the M10 has no flash, the best we can do to preserve the config is to set it in RAM and BBR.
             // BBR will survive a restart, and power off for a while, but modules with small backup
             // batteries or super caps will not retain the config for a long power off time.
-            msglen = makeUBXPacket(0x06, 0x09, sizeof(_message_SAVE_10), _message_SAVE_10);
-            _serial_gps->write(UBXscratch, msglen);
-            if (getACK(0x06, 0x09, 2000) != GNSS_RESPONSE_OK) {
-                LOG_WARN("Unable to save GNSS module config");
-            } else {
-                LOG_INFO("GNSS module configuration saved!");
-            }
+            queueUBXPacket(0x06, 0x09, _message_SAVE_10, sizeof(_message_SAVE_10), "save GNSS module config", 2000,
+                           "GNSS module configuration saved!");
         }
         didSerialInit = true;
     }
@@ -1089,8 +1111,15 @@ int32_t GPS::runOnce()
             LOG_INFO("GPS set to not-present. Skip probe");
             return disable();
         }
-        if (!setup())
-            return 2000; // Setup failed, re-run in two seconds
+        if (!GPSInitStarted) {
+            if (!setup())
+                return 2000; // Setup failed, re-run in two seconds
+            GPSInitStarted = true;
+        }
+        // Send the configuration setup() queued a step at a time, so the rest of the firmware runs while the receiver answers
+        if (ubxConfigNext < ubxConfig.size())
+            return runUBXConfig();
+        std::vector<UBXConfigStep>().swap(ubxConfig);
 
         // We have now loaded our saved preferences from flash
         if (config.position.gps_mode != meshtastic_Config_PositionConfig_GpsMode_ENABLED) {
@@ -1745,21 +1774,25 @@ bool GPS::whileActive()
         clearBuffer();
     }
 #endif
-    // First consume any chars that have piled up at the receiver
-    while (_serial_gps->available() > 0) {
-        int c = _serial_gps->read();
-        UBXscratch[charsInBuf] = c;
+    // First consume any chars that have piled up at the receiver, taking them from the UART a chunk at a time
+    uint8_t chunk[64];
+    size_t length;
+    while ((length = readAvailable(chunk, sizeof(chunk))) > 0) {
+        for (size_t i = 0; i < length; i++) {
+            uint8_t c = chunk[i];
+            UBXscratch[charsInBuf] = c;
 #ifdef GPS_DEBUG
-        debugmsg += vformat("%c", (c >= 32 && c <= 126) ? c : '.');
+            debugmsg += vformat("%c", (c >= 32 && c <= 126) ? c : '.');
 #endif
-        isValid |= reader.encode(c);
-        if (charsInBuf > sizeof(UBXscratch) - 10 || c == '\r') {
-            if (strnstr((char *)UBXscratch, "$GPTXT,01,01,02,u-blox ag - www.u-blox.com*50", charsInBuf)) {
-                rebootsSeen++;
+            isValid |= reader.encode(c);
+            if (charsInBuf > sizeof(UBXscratch) - 10 || c == '\r') {
+                if (strnstr((char *)UBXscratch, "$GPTXT,01,01,02,u-blox ag - www.u-blox.com*50", charsInBuf)) {
+                    rebootsSeen++;
+                }
+                charsInBuf = 0;
+            } else {
+                charsInBuf++;
             }
-            charsInBuf = 0;
-        } else {
-            charsInBuf++;
         }
     }
 #ifdef GPS_DEBUG
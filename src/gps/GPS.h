@@ -6,10 +6,12 @@
 #include "GpioLogic.h"
 #include "Observer.h"
 #include "TinyGPS++.h"
+#include "UBXFrameParser.h"
 #include "concurrency/OSThread.h"
 #include "input/RotaryEncoderInterruptImpl1.h"
 #include "input/UpDownInterruptImpl1.h"
 #include "modules/PositionModule.h"
+#include <vector>
 
 // Allow defining the polarity of the ENABLE output.  default is active high
 #ifndef GPS_EN_ACTIVE
@@ -179,7 +181,7 @@ class GPS : private concurrency::OSThread
     bool hasGPS = false; // Do we have a GPS we are talking to
 
     bool GPSInitFinished = false; // Init thread finished?
-    bool GPSInitStarted = false;  // Init thread finished?
+    bool GPSInitStarted = false;  // setup() done, its queued receiver configuration may still be going out
 
     GPSPowerState powerState = GPS_OFF; // GPS_ACTIVE if we want a location right now
 
@@ -203,12 +205,44 @@ class GPS : private concurrency::OSThread
 
     int rebootsSeen = 0;
 
+    size_t readAvailable(uint8_t *buffer, size_t size); // Bulk read from the UART, never waiting for more bytes
+
     int getACK(uint8_t *buffer, uint16_t size, uint8_t requestedClass, uint8_t requestedID, uint32_t waitMillis);
     GPS_RESPONSE getACK(uint8_t c, uint8_t i, uint32_t waitMillis);
     GPS_RESPONSE getACK(const char *message, uint32_t waitMillis);
 
     GPS_RESPONSE getACKCas(uint8_t class_id, uint8_t msg_id, uint32_t waitMillis);
 
+    /// One step of the UBX receiver configuration queued by setup() and carried out by runOnce()
+    struct UBXConfigStep {
+        enum Kind : uint8_t { SEND, WAIT, CLEAR } kind;
+        uint8_t msgClass;
+        uint8_t msgId;
+        uint8_t payloadSize;
+        const uint8_t *payload;
+        uint16_t ms;                // SEND: how long to wait for the ACK, WAIT: how long to pause
+        const char *description;    // SEND: logged as "Unable to <description>" if not acknowledged
+        const char *successMessage; // SEND: logged once acknowledged, if set
+    };
+
+    std::vector<UBXConfigStep> ubxConfig; // Steps still to be carried out, freed once they are all done
+    size_t ubxConfigNext = 0;             // Index of the step in progress
+    bool ubxConfigAwaitingAck = false;    // The current SEND step has gone out and we're watching for its ACK
+    uint32_t ubxConfigSentAt = 0;
+    uint8_t ubxAckPayload[2];
+    UBXFrameParser ubxAckParser = UBXFrameParser(ubxAckPayload, sizeof(ubxAckPayload)); // Keeps its place between runs
+
+    void queueUBXPacket(uint8_t msgClass, uint8_t msgId, const uint8_t *payload, uint8_t payloadSize, const char *description,
+                        uint16_t timeoutMs, const char *successMessage = nullptr);
+    void queueUBXWait(uint16_t ms) { ubxConfig.push_back({UBXConfigStep::WAIT, 0, 0, 0, nullptr, ms, nullptr, nullptr}); }
+    void queueUBXClear() { ubxConfig.push_back({UBXConfigStep::CLEAR, 0, 0, 0, nullptr, 0, nullptr, nullptr}); }
+
+    /// Carry out the current configuration step, returns the ms until runOnce() should call again
+    int32_t runUBXConfig();
+
+    /// Check what has arrived so far for an ACK or NAK of the given message, without waiting for more
+    GPS_RESPONSE pollACK(uint8_t class_id, uint8_t msg_id);
+
     /// Prepare the GPS for the cpu entering deep sleep, expect to be gone for at least 100s of msecs
     /// always returns 0 to indicate okay to sleep
     int prepareDeepSleep(void *unused);
@@ -438,6 +438,24 @@ float GeoCoord::rangeMetersToRadians(double range_meters)
     return (PI / (180 * 60)) * distance_nm;
 }
 
+/**
+ * Truncate a position to the given number of significant bits, as set by a channel's position_precision
+ * The result is placed in the middle of the area which the truncated position could be anywhere in, rather than at its corner
+ * Precision of 0 or 32 (and above) leaves the position unchanged
+ */
+void GeoCoord::applyPrecision(int32_t &latitude_i, int32_t &longitude_i, uint32_t precisionBits)
+{
+    if (precisionBits == 0 || precisionBits >= 32)
+        return;
+
+    // Same mask and offset for both axes
+    const uint32_t mask = UINT32_MAX << (32 - precisionBits);
+    const uint32_t halfStep = 1UL << (31 - precisionBits);
+
+    latitude_i = (int32_t)(((uint32_t)latitude_i & mask) + halfStep);
+    longitude_i = (int32_t)(((uint32_t)longitude_i & mask) + halfStep);
+}
+
 /**
  * Ported from http://www.edwilliams.org/avform147.htm#Intro
  * @brief Convert from radians to range in meters on a great circle
@@ -96,6 +96,7 @@ class GeoCoord
     static float rangeRadiansToMeters(double range_radians);
     static float rangeMetersToRadians(double range_meters);
     static unsigned int bearingToDegrees(const char *bearing);
+    static void applyPrecision(int32_t &latitude_i, int32_t &longitude_i, uint32_t precisionBits);
     static const char *degreesToBearing(unsigned int degrees);
 
     // Raises a number to an exponent, handling negative exponents.
@@ -0,0 +1,110 @@
+#include "UBXFrameParser.h"
+
+// 8-bit Fletcher checksum, running over class, id, length and payload
+void UBXFrameParser::accumulate(uint8_t b)
+{
+    ckA += b;
+    ckB += ckA;
+}
+
+size_t UBXFrameParser::feed(const uint8_t *data, size_t length)
+{
+    // The previous frame has been looked at by now
+    frameReady = false;
+
+    for (size_t i = 0; i < length; i++) {
+        if (step(data[i])) {
+            frameReady = true;
+            return i + 1;
+        }
+    }
+
+    return length;
+}
+
+bool UBXFrameParser::step(uint8_t b)
+{
+    switch (state) {
+    case SYNC_1:
+        if (b == 0xB5)
+            state = SYNC_2;
+        break;
+
+    case SYNC_2:
+        // A repeated 0xB5 could still be the start of a frame
+        if (b == 0x62)
+            state = CLASS;
+        else if (b != 0xB5)
+            state = SYNC_1;
+        break;
+
+    case CLASS:
+        ckA = ckB = 0;
+        accumulate(b);
+        frameClass = b;
+        state = ID;
+        break;
+
+    case ID:
+        accumulate(b);
+        frameId = b;
+        state = LENGTH_LSB;
+        break;
+
+    case LENGTH_LSB:
+        accumulate(b);
+        frameLength = b;
+        state = LENGTH_MSB;
+        break;
+
+    case LENGTH_MSB:
+        accumulate(b);
+        frameLength |= (uint16_t)b << 8;
+        received = 0;
+        state = frameLength ? PAYLOAD : CHECKSUM_A;
+
+        // Nothing we wait for is this long, so most likely 0xB5 0x62 turned up inside other data.
+        // Rather than swallowing what follows as payload, look for a frame again from the byte after the false sync.
+        if (frameLength > capacity) {
+            const uint8_t header[] = {frameClass, frameId, (uint8_t)frameLength, b};
+            oversized++;
+            state = SYNC_1;
+            for (uint8_t h : header)
+                step(h); // Four bytes are too few to complete a frame
+        }
+        break;
+
+    case PAYLOAD:
+        accumulate(b);
+        payload[received] = b;
+        if (++received == frameLength)
+            state = CHECKSUM_A;
+        break;
+
+    case CHECKSUM_A:
+        if (b == ckA) {
+            state = CHECKSUM_B;
+        } else {
+            badChecksums++;
+            state = SYNC_1;
+        }
+        break;
+
+    case CHECKSUM_B:
+        state = SYNC_1;
+        if (b == ckB)
+            return true;
+        badChecksums++;
+        break;
+    }
+
+    return false;
+}
+
+void UBXFrameParser::reset()
+{
+    state = SYNC_1;
+    frameReady = false;
+    frameLength = 0;
+    received = 0;
+}
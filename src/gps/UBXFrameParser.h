@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Incremental framing parser for UBX messages arriving over a serial stream
+ *
+ * Bytes can be fed in whatever chunks the UART hands us; the parser keeps its place between calls.
+ * Anything which isn't UBX (NMEA sentences, line noise) is skipped.
+ * A frame is only reported once its checksum has been verified.
+ * Frames declaring more payload than fits in the buffer are treated as a false sync and skipped.
+ */
+class UBXFrameParser
+{
+  public:
+    // Payload of the current frame is written to this buffer, capacity is also the longest payload accepted
+    UBXFrameParser(uint8_t *payload, uint16_t capacity) : payload(payload), capacity(capacity) {}
+
+    // Returns how many bytes were consumed. Stops straight after a complete frame, so the caller can inspect it.
+    size_t feed(const uint8_t *data, size_t length);
+
+    bool hasFrame() const { return frameReady; }               // A checksum-valid frame was completed by the last feed()
+    uint8_t msgClass() const { return frameClass; }            // Class of the completed frame
+    uint8_t msgId() const { return frameId; }                  // Message ID of the completed frame
+    uint16_t payloadLength() const { return frameLength; }     // Length of the payload, as declared by the frame
+    uint32_t checksumFailures() const { return badChecksums; } // Frames discarded because their checksum did not match
+    uint32_t oversizedFrames() const { return oversized; }     // Frames discarded because they were longer than capacity
+
+    void reset();
+
+  private:
+    enum State : uint8_t { SYNC_1, SYNC_2, CLASS, ID, LENGTH_LSB, LENGTH_MSB, PAYLOAD, CHECKSUM_A, CHECKSUM_B };
+
+    bool step(uint8_t b); // Returns true when b completes a valid frame
+    void accumulate(uint8_t b);
+
+    uint8_t *payload;
+    uint16_t capacity;
+
+    State state = SYNC_1;
+    bool frameReady = false;
+    uint8_t frameClass = 0;
+    uint8_t frameId = 0;
+    uint16_t frameLength = 0;
+    uint16_t received = 0; // Payload bytes received so far
+    uint8_t ckA = 0;
+    uint8_t ckB = 0;
+    uint32_t badChecksums = 0;
+    uint32_t oversized = 0;
+};
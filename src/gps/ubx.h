@@ -1,13 +1,7 @@
 static const char *failMessage = "Unable to %s";
 
-#define SEND_UBX_PACKET(TYPE, ID, DATA, ERRMSG, TIMEOUT)                                                                         \
-    do {                                                                                                                         \
-        msglen = makeUBXPacket(TYPE, ID, sizeof(DATA), DATA);                                                                    \
-        _serial_gps->write(UBXscratch, msglen);                                                                                  \
-        if (getACK(TYPE, ID, TIMEOUT) != GNSS_RESPONSE_OK) {                                                                     \
-            LOG_WARN(failMessage, #ERRMSG);                                                                                      \
-        }                                                                                                                        \
-    } while (0)
+// Queue a UBX command for runOnce() to send, it warns with ERRMSG if the receiver doesn't acknowledge it within TIMEOUT ms
+#define QUEUE_UBX_PACKET(TYPE, ID, DATA, ERRMSG, TIMEOUT) queueUBXPacket(TYPE, ID, DATA, sizeof(DATA), ERRMSG, TIMEOUT)
 
 // Power Management
 
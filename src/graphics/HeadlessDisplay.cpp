@@ -0,0 +1,138 @@
+#include "HeadlessDisplay.h"
+
+#if ARCH_PORTDUINO && HAS_SCREEN
+
+#include <stdio.h>
+#include <vector>
+
+HeadlessDisplay::HeadlessDisplay(OLEDDISPLAY_GEOMETRY geometry, uint16_t width, uint16_t height)
+{
+    setGeometry(geometry, width, height);
+}
+
+bool HeadlessDisplay::isPixelSet(int16_t x, int16_t y) const
+{
+    if (x < 0 || y < 0 || x >= displayWidth || y >= displayHeight)
+        return false;
+    return buffer[x + (y / 8) * displayWidth] & (1 << (y & 7));
+}
+
+uint32_t HeadlessDisplay::countSetPixels() const
+{
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < displayBufferSize; i++)
+        count += __builtin_popcount(buffer[i]);
+    return count;
+}
+
+static uint32_t crc32Update(uint32_t crc, const uint8_t *data, size_t len)
+{
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int k = 0; k < 8; k++)
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+    return ~crc;
+}
+
+uint32_t HeadlessDisplay::checksum() const
+{
+    return crc32Update(0, buffer, displayBufferSize);
+}
+
+static void putBE32(std::vector<uint8_t> &out, uint32_t v)
+{
+    out.push_back(v >> 24);
+    out.push_back(v >> 16);
+    out.push_back(v >> 8);
+    out.push_back(v);
+}
+
+static void putChunk(std::vector<uint8_t> &out, const char *type, const std::vector<uint8_t> &data)
+{
+    putBE32(out, data.size());
+    const size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    putBE32(out, crc32Update(0, &out[start], out.size() - start));
+}
+
+std::vector<uint8_t> HeadlessDisplay::encodePNG() const
+{
+    // One bit greyscale scanlines, each starting with filter type 0 (none)
+    const size_t rowBytes = (displayWidth + 7) / 8;
+    std::vector<uint8_t> raw;
+    raw.reserve((rowBytes + 1) * displayHeight);
+    for (int16_t y = 0; y < displayHeight; y++) {
+        raw.push_back(0);
+        for (size_t b = 0; b < rowBytes; b++) {
+            uint8_t bits = 0;
+            for (int i = 0; i < 8; i++)
+                if (isPixelSet(b * 8 + i, y))
+                    bits |= 0x80 >> i;
+            raw.push_back(bits);
+        }
+    }
+
+    // zlib stream made of uncompressed (stored) deflate blocks, screens are small enough that we don't care about size
+    std::vector<uint8_t> idat = {0x78, 0x01};
+    uint32_t adlerA = 1, adlerB = 0;
+    for (size_t pos = 0; pos < raw.size() || pos == 0;) {
+        const uint16_t len = raw.size() - pos > 65535 ? 65535 : raw.size() - pos;
+        const bool last = pos + len == raw.size();
+        idat.push_back(last ? 1 : 0);
+        idat.push_back(len & 0xff);
+        idat.push_back(len >> 8);
+        idat.push_back(~len & 0xff);
+        idat.push_back((~len >> 8) & 0xff);
+        for (size_t i = pos; i < pos + len; i++) {
+            idat.push_back(raw[i]);
+            adlerA = (adlerA + raw[i]) % 65521;
+            adlerB = (adlerB + adlerA) % 65521;
+        }
+        pos += len;
+        if (last)
+            break;
+    }
+    putBE32(idat, (adlerB << 16) | adlerA);
+
+    std::vector<uint8_t> ihdr;
+    putBE32(ihdr, displayWidth);
+    putBE32(ihdr, displayHeight);
+    ihdr.insert(ihdr.end(), {1, 0, 0, 0, 0}); // bit depth 1, greyscale, deflate, no filter, no interlace
+
+    std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    putChunk(png, "IHDR", ihdr);
+    putChunk(png, "IDAT", idat);
+    putChunk(png, "IEND", {});
+    return png;
+}
+
+bool HeadlessDisplay::writePNG(const char *path) const
+{
+    const std::vector<uint8_t> png = encodePNG();
+    FILE *f = fopen(path, "wb");
+    if (!f)
+        return false;
+    const bool ok = fwrite(png.data(), 1, png.size(), f) == png.size();
+    return fclose(f) == 0 && ok;
+}
+
+bool HeadlessDisplay::matchesPNG(const char *path) const
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return false;
+    std::vector<uint8_t> golden;
+    uint8_t chunk[512];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+        golden.insert(golden.end(), chunk, chunk + n);
+    fclose(f);
+
+    // The encoder always produces the same bytes for the same pixels, so there is no need to decode the golden image
+    return golden == encodePNG();
+}
+
+#endif
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "configuration.h"
+
+#if ARCH_PORTDUINO && HAS_SCREEN
+
+#include <OLEDDisplay.h>
+#include <vector>
+
+/**
+ * An OLEDDisplay that only renders into memory, for exercising the screen code on native without any hardware.
+ *
+ * display() just counts frames. The rendered buffer can be checked with checksum() or written out with writePNG(), so
+ * frames can be compared against golden images.
+ */
+class HeadlessDisplay : public OLEDDisplay
+{
+  public:
+    explicit HeadlessDisplay(OLEDDISPLAY_GEOMETRY geometry, uint16_t width = 0, uint16_t height = 0);
+
+    virtual void display() override { framesDisplayed++; }
+
+    /// Is pixel x, y lit in the current buffer
+    bool isPixelSet(int16_t x, int16_t y) const;
+
+    /// Number of lit pixels
+    uint32_t countSetPixels() const;
+
+    /// CRC32 of the buffer, cheap way to detect that a frame rendered differently
+    uint32_t checksum() const;
+
+    /// Write the buffer as a black and white PNG (lit pixels are white). Returns false if the file couldn't be written.
+    bool writePNG(const char *path) const;
+
+    /// Does the buffer look exactly like the PNG at path, as written by writePNG(). False if the file can't be read.
+    bool matchesPNG(const char *path) const;
+
+    uint32_t framesDisplayed = 0;
+
+  protected:
+    std::vector<uint8_t> encodePNG() const;
+
+    virtual int getBufferOffset(void) override { return 0; }
+
+    virtual void sendCommand(uint8_t com) override { (void)com; }
+
+    virtual bool connect() override { return true; }
+};
+
+#endif
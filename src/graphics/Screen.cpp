@@ -91,6 +91,10 @@ namespace graphics
 // This means the *visible* area (sh1106 can address 132, but shows 128 for example)
 #define IDLE_FRAMERATE 1 // in fps
 
+// How long a frame's content must stay the same before its redraws are skipped.
+// Covers the navigation bar hiding (2s after a frame change) and the E-Ink ghost cleanup (10s after that)
+#define FRAME_SETTLE_MS 15000
+
 // DEBUG
 #define NUM_EXTRA_FRAMES 3 // text message and debug frame
 // if defined a pixel will blink to show redraws
@@ -698,6 +702,7 @@ int32_t Screen::runOnce()
         if (!cmdQueue.dequeue(&cmd, 0)) {
             break;
         }
+        contentVersion++;
         switch (cmd.cmd) {
         case Cmd::SET_ON:
             handleSetOn(true);
@@ -751,7 +756,20 @@ int32_t Screen::runOnce()
 
     // this must be before the frameState == FIXED check, because we always
     // want to draw at least one FIXED frame before doing forceDisplay
-    ui->update();
+    // An idle frame with nothing new to show is left as it is: no redraw, and nothing sent to the display
+    if (!frameContentUnchanged()) {
+        uint64_t lastUpdate = ui->getUiState()->lastUpdate;
+        ui->update();
+
+        // The UI only draws once its frame interval has passed. Remember what was drawn, if it did
+        if (ui->getUiState()->lastUpdate != lastUpdate) {
+            FrameContent drawn = currentFrameContent();
+            if (!(drawn == drawnContent)) {
+                drawnContent = drawn;
+                drawnContentSince = millis();
+            }
+        }
+    }
 
     // Switch to a low framerate (to save CPU) when we are not in transition
     // but we should only call setTargetFPS when framestate changes, because
@@ -791,6 +809,39 @@ int32_t Screen::runOnce()
     return (1000 / targetFramerate);
 }
 
+// Describe what the current frame would draw from right now
+Screen::FrameContent Screen::currentFrameContent()
+{
+    FrameContent content;
+    content.frame = ui->getUiState()->currentFrame;
+    content.screenVersion = contentVersion;
+
+    // Only frames which can report every input they draw from are cacheable.
+    // Others animate, scroll, or show seconds, and are always redrawn.
+    if (content.frame == framesetInfo.positions.home) {
+        content.cacheable = true;
+        content.frameVersion = UIRenderer::deviceFocusedContentVersion();
+    }
+
+    return content;
+}
+
+// Whether the display already shows exactly what the current frame would draw
+bool Screen::frameContentUnchanged()
+{
+    if (!showingNormalScreen || targetFramerate != IDLE_FRAMERATE || ui->getUiState()->frameState != FIXED)
+        return false;
+
+    // Banners time out, and the charging bolt and the unread mail icon in the header blink
+    if (NotificationRenderer::isOverlayBannerShowing() || powerStatus->getIsCharging() || hasUnreadMessage)
+        return false;
+
+    if (!drawnContent.cacheable || Throttle::isWithinTimespanMs(drawnContentSince, FRAME_SETTLE_MS))
+        return false;
+
+    return currentFrameContent() == drawnContent;
+}
+
 /* show a message that the SSL cert is being built
  * it is expected that this will be used during the boot phase */
 void Screen::setSSLFrames()
@@ -860,6 +911,7 @@ void Screen::setScreensaverFrames(FrameCallback einkScreensaver)
 // Called when a frame should be added / removed, or custom frames should be cleared
 void Screen::setFrames(FrameFocus focus)
 {
+    contentVersion++;
     uint8_t originalPosition = ui->getUiState()->currentFrame;
     uint8_t previousFrameCount = framesetInfo.frameCount;
     FramesetInfo fsi; // Location of specific frames, for applying focus parameter
@@ -1229,6 +1281,7 @@ void Screen::setFastFramerate()
 
 int Screen::handleStatusUpdate(const meshtastic::Status *arg)
 {
+    contentVersion++;
     // LOG_DEBUG("Screen got status update %d", arg->getStatusType());
     switch (arg->getStatusType()) {
     case STATUS_TYPE_NODE:
@@ -1245,6 +1298,7 @@ int Screen::handleStatusUpdate(const meshtastic::Status *arg)
 // Handles when message is received; will jump to text message frame.
 int Screen::handleTextMessage(const meshtastic_MeshPacket *packet)
 {
+    contentVersion++;
     if (showingNormalScreen) {
         if (packet->from == 0) {
             // Outgoing message (likely sent from phone)
@@ -1307,6 +1361,7 @@ int Screen::handleTextMessage(const meshtastic_MeshPacket *packet)
 // Triggered by MeshModules
 int Screen::handleUIFrameEvent(const UIFrameEvent *event)
 {
+    contentVersion++;
     if (showingNormalScreen) {
         // Regenerate the frameset, potentially honoring a module's internal requestFocus() call
         if (event->action == UIFrameEvent::Action::REGENERATE_FRAMESET)
@@ -1326,6 +1381,7 @@ int Screen::handleUIFrameEvent(const UIFrameEvent *event)
 
 int Screen::handleInputEvent(const InputEvent *event)
 {
+    contentVersion++;
     if (!screenOn)
         return 0;
 
@@ -1409,6 +1465,7 @@ int Screen::handleInputEvent(const InputEvent *event)
 
 int Screen::handleAdminMessage(AdminModule_ObserverData *arg)
 {
+    contentVersion++;
     switch (arg->request->which_payload_variant) {
     // Node removed manually (i.e. via app)
     case meshtastic_AdminMessage_remove_by_nodenum_tag:
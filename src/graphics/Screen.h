@@ -707,6 +707,26 @@ class Screen : public concurrency::OSThread
     /// Holds state for debug information
     DebugInfo debugInfo;
 
+    /// What a frame was drawn from. While it stays the same, an idle frame can skip its redraw
+    struct FrameContent {
+        bool cacheable = false;     // Only frames which report everything they depend on can be skipped
+        uint8_t frame = 255;        // Index of the frame in the frameset
+        uint32_t screenVersion = 0; // Screen::contentVersion when drawn
+        uint32_t frameVersion = 0;  // The frame's own inputs, which change without any observer being notified
+
+        bool operator==(const FrameContent &other) const
+        {
+            return cacheable == other.cacheable && frame == other.frame && screenVersion == other.screenVersion &&
+                   frameVersion == other.frameVersion;
+        }
+    };
+    FrameContent currentFrameContent();
+    bool frameContentUnchanged();
+
+    FrameContent drawnContent;      // What the display is currently showing
+    uint32_t drawnContentSince = 0; // When the display started showing it (millis)
+    uint32_t contentVersion = 0;    // Bumped by observers, commands and input: anything which might change what is drawn
+
     /// Display device
     OLEDDisplay *dispdev;
 
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+namespace graphics
+{
+
+/**
+ * Helpers for copying the page ordered monochrome OLEDDisplay buffer to a colour panel.
+ *
+ * The buffer holds one page of displayWidth bytes for every 8 rows, each byte being a column of 8 vertical pixels (LSB on
+ * top). forEachChangedSpan() compares it with the previous frame and reports every horizontal run of a row that has to be
+ * redrawn, so the caller can convert it with rowToRGB565() and push it with one block write instead of a drawPixel() per
+ * pixel.
+ */
+namespace TFTBlit
+{
+
+/// Unchanged pixels between two changes in the same row are redrawn rather than starting a new span when the gap is shorter
+/// than this, setting up another address window costs about as much on the bus.
+constexpr uint16_t SPAN_MERGE_GAP = 16;
+
+inline uint32_t load32(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/// Fill line with the colours of pixels x .. x + w - 1 of row y
+inline void rowToRGB565(const uint8_t *buffer, uint16_t displayWidth, uint16_t x, uint16_t y, uint16_t w, uint16_t on,
+                        uint16_t off, uint16_t *line)
+{
+    const uint8_t *src = buffer + (y / 8) * displayWidth + x;
+    const uint8_t bit = 1 << (y & 7);
+    for (uint16_t i = 0; i < w; i++)
+        line[i] = (src[i] & bit) ? on : off;
+}
+
+/**
+ * Call fn(x, y, w) for each run of pixels that differs between buffer and back.
+ *
+ * back may be NULL to compare against a blank (all off) screen. Unchanged pages are skipped a word at a time.
+ */
+template <typename F>
+void forEachChangedSpan(const uint8_t *buffer, const uint8_t *back, uint16_t displayWidth, uint16_t displayHeight, F &&fn)
+{
+    for (uint16_t page = 0; page * 8 < displayHeight; page++) {
+        const uint8_t *cur = buffer + page * displayWidth;
+        const uint8_t *prev = back ? back + page * displayWidth : nullptr;
+        auto diff = [&](uint16_t x) -> uint8_t { return prev ? cur[x] ^ prev[x] : cur[x]; };
+
+        // Narrow the page down to the first and last changed column, comparing 4 columns at a time
+        uint16_t left = 0, right = displayWidth;
+        while (left + 4 <= right && (prev ? load32(cur + left) == load32(prev + left) : load32(cur + left) == 0))
+            left += 4;
+        while (left < right && !diff(left))
+            left++;
+        if (left == right)
+            continue; // nothing changed in these 8 rows
+        while (right - 4 >= left && (prev ? load32(cur + right - 4) == load32(prev + right - 4) : load32(cur + right - 4) == 0))
+            right -= 4;
+        while (!diff(right - 1))
+            right--;
+
+        uint8_t rowsChanged = 0;
+        for (uint16_t x = left; x < right; x++)
+            rowsChanged |= diff(x);
+
+        for (uint8_t row = 0; row < 8 && page * 8 + row < displayHeight; row++) {
+            const uint8_t bit = 1 << row;
+            if (!(rowsChanged & bit))
+                continue;
+
+            const uint16_t y = page * 8 + row;
+            int32_t start = -1, last = -1;
+            for (uint16_t x = left; x < right; x++) {
+                if (!(diff(x) & bit))
+                    continue;
+                if (start >= 0 && x - last > SPAN_MERGE_GAP) {
+                    fn((uint16_t)start, y, (uint16_t)(last - start + 1));
+                    start = -1;
+                }
+                if (start < 0)
+                    start = x;
+                last = x;
+            }
+            if (start >= 0)
+                fn((uint16_t)start, y, (uint16_t)(last - start + 1));
+        }
+    }
+}
+
+} // namespace TFTBlit
+} // namespace graphics
@@ -965,6 +965,7 @@ static LGFX *tft = nullptr;
 #if defined(ST7701_CS) || defined(ST7735_CS) || defined(ST7789_CS) || defined(ILI9341_DRIVER) || defined(ILI9342_DRIVER) ||      \
     defined(RAK14014) || defined(HX8357_CS) || defined(ILI9488_CS) || defined(ST72xx_DE) || (ARCH_PORTDUINO && HAS_SCREEN != 0)
 #include "SPILock.h"
+#include "TFTBlit.h"
 #include "TFTDisplay.h"
 #include <SPI.h>
 
@@ -1015,29 +1016,27 @@ void TFTDisplay::display(bool fromBlank)
     // tft->clear();
     concurrency::LockGuard g(spiLock);
 
-    uint16_t x, y;
-
-    for (y = 0; y < displayHeight; y++) {
-        for (x = 0; x < displayWidth; x++) {
-            auto isset = buffer[x + (y / 8) * displayWidth] & (1 << (y & 7));
-            if (!fromBlank) {
-                // get src pixel in the page based ordering the OLED lib uses FIXME, super inefficent
-                auto dblbuf_isset = buffer_back[x + (y / 8) * displayWidth] & (1 << (y & 7));
-                if (isset != dblbuf_isset) {
-                    tft->drawPixel(x, y, isset ? TFT_MESH : TFT_BLACK);
-                }
-            } else if (isset) {
-                tft->drawPixel(x, y, TFT_MESH);
-            }
-        }
-    }
+    if (!lineBuffer)
+        lineBuffer = new uint16_t[displayWidth];
+
+    // Only redraw the runs of pixels that changed since the last frame, one block write per run. After a fillScreen
+    // everything is black already, so we only have to draw the lit pixels.
+    bool writing = false;
+    graphics::TFTBlit::forEachChangedSpan(buffer, fromBlank ? nullptr : buffer_back, displayWidth, displayHeight,
+                                          [&](uint16_t x, uint16_t y, uint16_t w) {
+                                              if (!writing) {
+                                                  tft->startWrite();
+                                                  writing = true;
+                                              }
+                                              graphics::TFTBlit::rowToRGB565(buffer, displayWidth, x, y, w, TFT_MESH,
+                                                                             TFT_BLACK, lineBuffer);
+                                              tft->pushImage(x, y, w, 1, lineBuffer);
+                                          });
+    if (writing)
+        tft->endWrite();
+
     // Copy the Buffer to the Back Buffer
-    for (y = 0; y < (displayHeight / 8); y++) {
-        for (x = 0; x < displayWidth; x++) {
-            uint16_t pos = x + y * displayWidth;
-            buffer_back[pos] = buffer[pos];
-        }
-    }
+    memcpy(buffer_back, buffer, displayBufferSize);
 }
 
 // Send a command to the display (low level function)
@@ -1177,7 +1176,6 @@ bool TFTDisplay::connect()
     tft->setRotation(0);
 #elif defined(RAK14014)
     tft->setRotation(1);
-    tft->setSwapBytes(true);
     //    tft->fillScreen(TFT_BLACK);
     ft6336u.begin();
     pinMode(SCREEN_TOUCH_INT, INPUT_PULLUP);
@@ -1191,6 +1189,8 @@ bool TFTDisplay::connect()
 #else
     tft->setRotation(3); // Orient horizontal and wide underneath the silkscreen name label
 #endif
+    // display() pushes rows of native endian RGB565 pixels
+    tft->setSwapBytes(true);
     tft->fillScreen(TFT_BLACK);
 
     return true;
@@ -56,13 +56,32 @@ namespace graphics
 namespace MessageRenderer
 {
 
-// Simple cache based on text hash
-static size_t cachedKey = 0;
-static std::vector<std::string> cachedLines;
-static std::vector<int> cachedHeights;
+// Wrapped lines of the message on screen, only laid out again when the message, the text width or the font changes
+static struct {
+    uint32_t from = 0, to = 0, id = 0, rxTime = 0;
+    int textWidth = 0;
+    const uint8_t *font = nullptr;
+    std::vector<std::string> lines; // lines[0] is the header
+    std::vector<int> heights;
+    int totalHeight = 0; // of the lines below the header
+} cachedLayout;
+
+// True when the line has no emotes or bold markers, all emote labels are multi byte UTF-8
+static bool isPlainLine(const std::string &line)
+{
+    for (unsigned char c : line)
+        if (c >= 0x80)
+            return false;
+    return line.find("**") == std::string::npos;
+}
 
 void drawStringWithEmotes(OLEDDisplay *display, int x, int y, const std::string &line, const Emote *emotes, int emoteCount)
 {
+    if (isPlainLine(line)) {
+        display->drawString(x, y, line.c_str());
+        return;
+    }
+
     int cursorX = x;
     const int fontHeight = FONT_HEIGHT_SMALL;
 
@@ -266,34 +285,32 @@ void drawTextMessageFrame(OLEDDisplay *display, OLEDDisplayUiState *state, int16
         }
     }
 #endif
-    // === Generate the cache key ===
-    size_t currentKey = (size_t)mp.from;
-    currentKey ^= ((size_t)mp.to << 8);
-    currentKey ^= ((size_t)mp.rx_time << 16);
-    currentKey ^= ((size_t)mp.id << 24);
-
-    if (cachedKey != currentKey) {
-        LOG_INFO("Message cache key is misssed cachedKey=0x%0x, currentKey=0x%x", cachedKey, currentKey);
-
-        // Cache miss - regenerate lines and heights
-        cachedLines = generateLines(display, headerStr, messageBuf, textWidth);
-        cachedHeights = calculateLineHeights(cachedLines, emotes);
-        cachedKey = currentKey;
+    // === Lay out the message, once per message ===
+    if (cachedLayout.from != mp.from || cachedLayout.to != mp.to || cachedLayout.id != mp.id || cachedLayout.rxTime != mp.rx_time ||
+        cachedLayout.textWidth != textWidth || cachedLayout.font != FONT_SMALL) {
+        LOG_DEBUG("Lay out message 0x%x from 0x%x", mp.id, mp.from);
+        cachedLayout.from = mp.from;
+        cachedLayout.to = mp.to;
+        cachedLayout.id = mp.id;
+        cachedLayout.rxTime = mp.rx_time;
+        cachedLayout.textWidth = textWidth;
+        cachedLayout.font = FONT_SMALL;
+        cachedLayout.lines = generateLines(display, headerStr, messageBuf, textWidth);
+        cachedLayout.heights = calculateLineHeights(cachedLayout.lines, emotes);
+        // The header is drawn as plain text, whatever is in the sender's name
+        cachedLayout.heights[0] = std::max(FONT_HEIGHT_SMALL - 2, 8);
+        cachedLayout.totalHeight = 0;
+        for (size_t i = 1; i < cachedLayout.heights.size(); ++i)
+            cachedLayout.totalHeight += cachedLayout.heights[i];
     } else {
-        // Cache hit but update the header line with current time information
-        cachedLines[0] = std::string(headerStr);
-        // The header always has a fixed height since it doesn't contain emotes
-        // As per calculateLineHeights logic for lines without emotes:
-        cachedHeights[0] = FONT_HEIGHT_SMALL - 2;
-        if (cachedHeights[0] < 8)
-            cachedHeights[0] = 8; // minimum safety
+        // Only the header changes between frames, as the time since the message ticks on
+        cachedLayout.lines[0].assign(headerStr);
     }
+    const std::vector<std::string> &cachedLines = cachedLayout.lines;
+    const std::vector<int> &cachedHeights = cachedLayout.heights;
 
     // === Scrolling logic ===
-    int totalHeight = 0;
-    for (size_t i = 1; i < cachedHeights.size(); ++i) {
-        totalHeight += cachedHeights[i];
-    }
+    int totalHeight = cachedLayout.totalHeight;
     int usableScrollHeight = usableHeight - cachedHeights[0]; // remove header height
     int scrollStop = std::max(0, totalHeight - usableScrollHeight + cachedHeights.back());
 
@@ -426,11 +443,11 @@ std::vector<int> calculateLineHeights(const std::vector<std::string> &lines, con
 void renderMessageContent(OLEDDisplay *display, const std::vector<std::string> &lines, const std::vector<int> &rowHeights, int x,
                           int yOffset, int scrollBottom, const Emote *emotes, int numEmotes, bool isInverted, bool isBold)
 {
-    for (size_t i = 0; i < lines.size(); ++i) {
-        int lineY = yOffset;
-        for (size_t j = 0; j < i; ++j)
-            lineY += rowHeights[j];
-        if (lineY > -rowHeights[i] && lineY < scrollBottom) {
+    int lineY = yOffset;
+    for (size_t i = 0; i < lines.size(); lineY += rowHeights[i], ++i) {
+        if (lineY >= scrollBottom)
+            break;
+        if (lineY > -rowHeights[i]) {
             if (i == 0 && isInverted) {
                 display->drawString(x, lineY, lines[i].c_str());
                 if (isBold)
@@ -128,6 +128,74 @@ void drawScrollbar(OLEDDisplay *display, int visibleNodeRows, int totalEntries,
     }
 }
 
+// =============================
+// Distance and Bearing Cache
+// =============================
+
+/// Distance and bearing from our position to a node, only worked out again when one of the two positions changes
+struct NodeGeometry {
+    NodeNum num;
+    int32_t ourLat, ourLon, nodeLat, nodeLon;
+    float meters;
+    float bearing; // radians, 0 is north
+};
+
+// Direct mapped on the node number, enough slots for every entry on a screenful of nodes
+#define NODE_GEOMETRY_CACHE_SIZE 32
+static NodeGeometry geometryCache[NODE_GEOMETRY_CACHE_SIZE];
+
+// Up to about 1 degree (110 km) apart a flat earth projection in float is well inside the precision we display
+#define FLAT_EARTH_MAX_DELTA_I 10000000
+
+static void computeNodeGeometry(NodeGeometry &g)
+{
+    const int32_t dLatI = g.nodeLat - g.ourLat;
+    int64_t dLonI = (int64_t)g.nodeLon - g.ourLon;
+    if (dLonI > 1800000000)
+        dLonI -= 3600000000LL;
+    else if (dLonI < -1800000000)
+        dLonI += 3600000000LL;
+
+    if (abs(dLatI) < FLAT_EARTH_MAX_DELTA_I && llabs(dLonI) < FLAT_EARTH_MAX_DELTA_I) {
+        const float metersPerUnit = 6371000.0f * (float)DEG_TO_RAD * 1e-7f;
+        const float midLat = (g.ourLat + dLatI / 2) * 1e-7f * (float)DEG_TO_RAD;
+        const float north = dLatI * metersPerUnit;
+        const float east = dLonI * metersPerUnit * cosf(midLat);
+        g.meters = sqrtf(north * north + east * east);
+        g.bearing = atan2f(east, north);
+        return;
+    }
+
+    double lat1 = g.ourLat * 1e-7;
+    double lon1 = g.ourLon * 1e-7;
+    double lat2 = g.nodeLat * 1e-7;
+    double lon2 = g.nodeLon * 1e-7;
+
+    double earthRadiusKm = 6371.0;
+    double dLat = (lat2 - lat1) * DEG_TO_RAD;
+    double dLon = (lon2 - lon1) * DEG_TO_RAD;
+
+    double a = sin(dLat / 2) * sin(dLat / 2) + cos(lat1 * DEG_TO_RAD) * cos(lat2 * DEG_TO_RAD) * sin(dLon / 2) * sin(dLon / 2);
+    double c = 2 * atan2(sqrt(a), sqrt(1 - a));
+    g.meters = earthRadiusKm * c * 1000;
+    g.bearing = GeoCoord::bearing(lat1, lon1, lat2, lon2);
+}
+
+static const NodeGeometry &getNodeGeometry(const meshtastic_NodeInfoLite *node, int32_t ourLat, int32_t ourLon)
+{
+    NodeGeometry &g = geometryCache[node->num % NODE_GEOMETRY_CACHE_SIZE];
+    if (g.num != node->num || g.ourLat != ourLat || g.ourLon != ourLon || g.nodeLat != node->position.latitude_i ||
+        g.nodeLon != node->position.longitude_i) {
+        g.num = node->num;
+        g.ourLat = ourLat;
+        g.ourLon = ourLon;
+        g.nodeLat = node->position.latitude_i;
+        g.nodeLon = node->position.longitude_i;
+        computeNodeGeometry(g);
+    }
+    return g;
+}
+
 // =============================
 // Entry Renderers
 // =============================
@@ -231,19 +299,7 @@ void drawNodeDistance(OLEDDisplay *display, meshtastic_NodeInfoLite *node, int16
 
     meshtastic_NodeInfoLite *ourNode = nodeDB->getMeshNode(nodeDB->getNodeNum());
     if (nodeDB->hasValidPosition(ourNode) && nodeDB->hasValidPosition(node)) {
-        double lat1 = ourNode->position.latitude_i * 1e-7;
-        double lon1 = ourNode->position.longitude_i * 1e-7;
-        double lat2 = node->position.latitude_i * 1e-7;
-        double lon2 = node->position.longitude_i * 1e-7;
-
-        double earthRadiusKm = 6371.0;
-        double dLat = (lat2 - lat1) * DEG_TO_RAD;
-        double dLon = (lon2 - lon1) * DEG_TO_RAD;
-
-        double a =
-            sin(dLat / 2) * sin(dLat / 2) + cos(lat1 * DEG_TO_RAD) * cos(lat2 * DEG_TO_RAD) * sin(dLon / 2) * sin(dLon / 2);
-        double c = 2 * atan2(sqrt(a), sqrt(1 - a));
-        double distanceKm = earthRadiusKm * c;
+        double distanceKm = getNodeGeometry(node, ourNode->position.latitude_i, ourNode->position.longitude_i).meters / 1000.0;
 
         if (config.display.units == meshtastic_Config_DisplayConfig_DisplayUnits_IMPERIAL) {
             double miles = distanceKm * 0.621371;
@@ -347,9 +403,8 @@ void drawCompassArrow(OLEDDisplay *display, meshtastic_NodeInfoLite *node, int16
     int centerX = x + columnWidth - arrowXOffset;
     int centerY = y + FONT_HEIGHT_SMALL / 2;
 
-    double nodeLat = node->position.latitude_i * 1e-7;
-    double nodeLon = node->position.longitude_i * 1e-7;
-    float bearing = GeoCoord::bearing(userLat, userLon, nodeLat, nodeLon);
+    // userLat and userLon came from our position_i through DegD(), so this gets the exact integers back
+    float bearing = getNodeGeometry(node, (int32_t)lround(userLat * 1e7), (int32_t)lround(userLon * 1e7)).bearing;
     float bearingToNode = RAD_TO_DEG * bearing;
     float relativeBearing = fmod((bearingToNode - myHeading + 360), 360);
     float angle = relativeBearing * DEG_TO_RAD;
@@ -16,6 +16,7 @@
 #include "target_specific.h"
 #include <OLEDDisplay.h>
 #include <RTC.h>
+#include <cmath>
 #include <cstring>
 
 // External variables
@@ -676,6 +677,21 @@ void UIRenderer::drawDeviceFocused(OLEDDisplay *display, OLEDDisplayUiState *sta
     }
 }
 
+// Inputs of drawDeviceFocused which change by themselves, rather than through the power, GPS or node status observers
+// Only needs to change when the drawn text would: minutes of uptime and clock, channel utilization rounded like "%2.0f"
+uint32_t UIRenderer::deviceFocusedContentVersion()
+{
+    uint32_t version = millis() / 60000;
+    version = version * 31 + getValidTime(RTCQuality::RTCQualityDevice, true) / 60;
+    version = version * 31 + (airTime ? (uint32_t)lroundf(airTime->channelUtilizationPercent()) : 0);
+    version = version * 31 + powerStatus->getBatteryVoltageMv() / 10;
+    version = version * 31 + powerStatus->getBatteryChargePercent();
+    version = version * 31 + config.bluetooth.enabled;
+    version = version * 31 + config.position.gps_mode;
+    version = version * 31 + config.position.fixed_position;
+    return version;
+}
+
 // Start Functions to write date/time to the screen
 // Helper function to check if a year is a leap year
 bool isLeapYear(int year)
@@ -53,6 +53,8 @@ class UIRenderer
     static void drawNodeInfo(OLEDDisplay *display, const OLEDDisplayUiState *state, int16_t x, int16_t y);
 
     static void drawDeviceFocused(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t x, int16_t y);
+    // Changes whenever something drawDeviceFocused shows changes, other than through the Screen's observers
+    static uint32_t deviceFocusedContentVersion();
 
     // Icon and screen drawing functions
     static void drawIconScreen(const char *upperMsg, OLEDDisplay *display, OLEDDisplayUiState *state, int16_t x, int16_t y);
@@ -9,6 +9,7 @@ EInk::EInk(uint16_t width, uint16_t height, UpdateTypes supported)
     : concurrency::OSThread("EInkDriver"), width(width), height(height), supportedUpdateTypes(supported)
 {
     OSThread::disable();
+    windowRows = height;
 }
 
 // Used by NicheGraphics implementations to check if a display supports a specific refresh operation.
@@ -22,6 +23,21 @@ bool EInk::supports(UpdateTypes type)
         return false;
 }
 
+// Tell the driver which rows of the image changed since the previous update
+// Set before each update. A driver can use this to limit how much image data it sends to the display controller,
+// but only for update types which leave the rest of the controller's image memory in place (e.g. FAST)
+void EInk::setUpdateWindow(uint16_t top, uint16_t rows)
+{
+    if (top >= height || rows == 0) {
+        top = 0;
+        rows = height;
+    }
+    if (rows > height - top)
+        rows = height - top;
+    windowTop = top;
+    windowRows = rows;
+}
+
 // Begins using the OSThread to detect when a display update is complete
 // This allows the refresh operation to run "asynchronously".
 // Rather than blocking execution waiting for the update to complete, we are periodically checking the hardware's BUSY pin
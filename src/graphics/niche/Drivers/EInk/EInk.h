@@ -33,6 +33,7 @@ class EInk : private concurrency::OSThread
     void await();                                                  // Wait for an in-progress update to complete before proceeding
     bool supports(UpdateTypes type);                               // Can display perform a certain update type
     bool busy() { return updateRunning; }                          // Display able to update right now?
+    void setUpdateWindow(uint16_t top, uint16_t rows);             // Only these rows changed, for the next update
 
     const uint16_t width; // Public so that NicheGraphics implementations can access. Safe because const.
     const uint16_t height;
@@ -43,6 +44,11 @@ class EInk : private concurrency::OSThread
     virtual void finalizeUpdate() {}                                 // Run any post-update code
     bool failed = false;                                             // If an error occurred during update
 
+    // Rows of the image which changed since the previous update, as set by setUpdateWindow
+    // Drivers may send just these rows to the display controller, when the update type allows it
+    uint16_t windowTop = 0;
+    uint16_t windowRows = 0;
+
   private:
     int32_t runOnce() override; // Repeated checking if update finished
 
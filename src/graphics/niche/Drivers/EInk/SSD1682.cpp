@@ -38,4 +38,13 @@ void SSD1682::configFullscreen()
     sendData(sy);
 }
 
+// Move the memory cursor to the start of row y. As with configFullscreen, y is a single byte
+void SSD1682::setMemoryCursorY(uint16_t y)
+{
+    sendCommand(0x4E); // Memory cursor X
+    sendData(bufferOffsetX);
+    sendCommand(0x4F); // Memory cursor y
+    sendData(y & 0xFF);
+}
+
 #endif
\ No newline at end of file
@@ -22,8 +22,9 @@ class SSD1682 : public SSD16XX
 {
   public:
     SSD1682(uint16_t width, uint16_t height, EInk::UpdateTypes supported, uint8_t bufferOffsetX = 0);
-    virtual void configFullscreen(); // Select memory region on controller IC
-    virtual void deepSleep() {}      // Not usable (image memory not retained)
+    virtual void configFullscreen();           // Select memory region on controller IC
+    virtual void setMemoryCursorY(uint16_t y); // Single byte y, as with configFullscreen
+    virtual void deepSleep() {}                // Not usable (image memory not retained)
 };
 
 } // namespace NicheGraphics::Drivers
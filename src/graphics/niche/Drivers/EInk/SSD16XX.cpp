@@ -173,6 +173,16 @@ void SSD16XX::configFullscreen()
     sendData(sy2);
 }
 
+// Move the memory cursor to the start of row y, so that part of the image can be written
+void SSD16XX::setMemoryCursorY(uint16_t y)
+{
+    sendCommand(0x4E); // Memory cursor X
+    sendData(bufferOffsetX);
+    sendCommand(0x4F); // Memory cursor y
+    sendData(y & 0xFF);
+    sendData((y >> 8) & 0xFF);
+}
+
 void SSD16XX::update(uint8_t *imageData, UpdateTypes type)
 {
     this->updateType = type;
@@ -212,16 +222,32 @@ void SSD16XX::configUpdateSequence()
     }
 }
 
+// For a FULL update, the whole image is sent.
+// Otherwise, only the rows which changed (EInk::setUpdateWindow): the controller still holds the rest from the previous update.
 void SSD16XX::writeNewImage()
 {
-    sendCommand(0x24);
-    sendData(buffer, bufferSize);
+    if (updateType == FULL) {
+        setMemoryCursorY(0);
+        sendCommand(0x24);
+        sendData(buffer, bufferSize);
+    } else {
+        setMemoryCursorY(windowTop);
+        sendCommand(0x24);
+        sendData(buffer + (windowTop * bufferRowSize), windowRows * bufferRowSize);
+    }
 }
 
 void SSD16XX::writeOldImage()
 {
-    sendCommand(0x26);
-    sendData(buffer, bufferSize);
+    if (updateType == FULL) {
+        setMemoryCursorY(0);
+        sendCommand(0x26);
+        sendData(buffer, bufferSize);
+    } else {
+        setMemoryCursorY(windowTop);
+        sendCommand(0x26);
+        sendData(buffer + (windowTop * bufferRowSize), windowRows * bufferRowSize);
+    }
 }
 
 void SSD16XX::detachFromUpdate()
@@ -32,11 +32,12 @@ class SSD16XX : public EInk
     virtual void sendCommand(const uint8_t command);
     virtual void sendData(const uint8_t data);
     virtual void sendData(const uint8_t *data, uint32_t size);
-    virtual void configFullscreen();     // Select memory region on controller IC
-    virtual void configScanning() {}     // Optional. First & last gates, scan direction, etc
-    virtual void configVoltages() {}     // Optional. Manual panel voltages, soft-start, etc
-    virtual void configWaveform() {}     // Optional. LUT, panel border, temperature sensor, etc
-    virtual void configUpdateSequence(); // Tell controller IC which operations to run
+    virtual void configFullscreen();           // Select memory region on controller IC
+    virtual void setMemoryCursorY(uint16_t y); // Place the memory cursor at the start of a row, before writing image data
+    virtual void configScanning() {}           // Optional. First & last gates, scan direction, etc
+    virtual void configVoltages() {}           // Optional. Manual panel voltages, soft-start, etc
+    virtual void configWaveform() {}           // Optional. LUT, panel border, temperature sensor, etc
+    virtual void configUpdateSequence();       // Tell controller IC which operations to run
 
     virtual void writeNewImage();
     virtual void writeOldImage(); // Image which can be used at *next* update for "differential refresh"
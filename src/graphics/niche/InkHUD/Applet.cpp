@@ -325,9 +325,11 @@ InkHUD::AppletFont InkHUD::Applet::getFont()
 
 // Parse any text which might have "special characters"
 // Re-encodes UTF-8 characters to match our 8-bit encoded fonts
+// Decodes in place, into the string we were handed, so no further allocation is needed
 std::string InkHUD::Applet::parse(std::string text)
 {
-    return getFont().decodeUTF8(text);
+    text.resize(currentFont.decodeUTF8(text.data(), text.length(), &text[0]));
+    return text;
 }
 
 // Get the best version of a node's short name available to us
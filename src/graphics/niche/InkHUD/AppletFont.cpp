@@ -1,9 +1,7 @@
-#ifdef MESHTASTIC_INCLUDE_INKHUD
+#if defined(MESHTASTIC_INCLUDE_INKHUD) || defined(MESHTASTIC_INCLUDE_INKHUD_FONT)
 
 #include "./AppletFont.h"
 
-#include <assert.h>
-
 using namespace NicheGraphics;
 
 InkHUD::AppletFont::AppletFont()
@@ -98,33 +96,35 @@ uint8_t InkHUD::AppletFont::widthBetweenWords()
 
 // Convert a unicode char from set of UTF-8 bytes to UTF-32
 // Used by AppletFont::applyEncoding, which remaps unicode chars for extended ASCII fonts, based on their UTF-32 value
-uint32_t InkHUD::AppletFont::toUtf32(std::string utf8)
+uint32_t InkHUD::AppletFont::toUtf32(const uint8_t *utf8, uint8_t length)
 {
     uint32_t utf32 = 0;
 
-    switch (utf8.length()) {
+    switch (length) {
     case 2:
         // 5 bits + 6 bits
-        utf32 |= (utf8.at(0) & 0b00011111) << 6;
-        utf32 |= (utf8.at(1) & 0b00111111);
+        utf32 |= (utf8[0] & 0b00011111) << 6;
+        utf32 |= (utf8[1] & 0b00111111);
         break;
 
     case 3:
         // 4 bits + 6 bits + 6 bits
-        utf32 |= (utf8.at(0) & 0b00001111) << (6 + 6);
-        utf32 |= (utf8.at(1) & 0b00111111) << 6;
-        utf32 |= (utf8.at(2) & 0b00111111);
+        utf32 |= (utf8[0] & 0b00001111) << (6 + 6);
+        utf32 |= (utf8[1] & 0b00111111) << 6;
+        utf32 |= (utf8[2] & 0b00111111);
         break;
 
     case 4:
         // 3 bits + 6 bits + 6 bits + 6 bits
-        utf32 |= (utf8.at(0) & 0b00000111) << (6 + 6 + 6);
-        utf32 |= (utf8.at(1) & 0b00111111) << (6 + 6);
-        utf32 |= (utf8.at(2) & 0b00111111) << 6;
-        utf32 |= (utf8.at(3) & 0b00111111);
+        utf32 |= (utf8[0] & 0b00000111) << (6 + 6 + 6);
+        utf32 |= (utf8[1] & 0b00111111) << (6 + 6);
+        utf32 |= (utf8[2] & 0b00111111) << 6;
+        utf32 |= (utf8[3] & 0b00111111);
         break;
+
     default:
-        assert(false);
+        // Not valid UTF-8. Zero isn't remapped by any encoding, so the char will be drawn as SUB
+        break;
     }
 
     return utf32;
@@ -132,53 +132,56 @@ uint32_t InkHUD::AppletFont::toUtf32(std::string utf8)
 
 // Process a string, collating UTF-8 bytes, and sending them off for re-encoding to extended ASCII
 // Not all InkHUD text is passed through here, only text which could potentially contain non-ASCII chars
-std::string InkHUD::AppletFont::decodeUTF8(std::string encoded)
+std::string InkHUD::AppletFont::decodeUTF8(const std::string &encoded)
+{
+    // Every char becomes a single byte, so the result is never longer than the input. One allocation covers it.
+    std::string decoded(encoded.length(), '\0');
+    decoded.resize(decodeUTF8(encoded.data(), encoded.length(), &decoded[0]));
+    return decoded;
+}
+
+// Re-encode UTF-8 text into a buffer supplied by the caller, without any allocation
+// The output buffer needs room for as many bytes as the input. Returns the number of bytes written.
+// Output never gets ahead of input, so the text can be decoded in place by passing the same buffer for both.
+size_t InkHUD::AppletFont::decodeUTF8(const char *encoded, size_t length, char *output)
 {
-    // Final processed output
-    std::string decoded;
-
-    // Holds bytes for one UTF-8 char during parsing
-    std::string utf8Char;
-    uint8_t utf8CharSize = 0;
-
-    for (char &c : encoded) {
-
-        // If first byte
-        if (utf8Char.empty()) {
-            // If MSB is unset, byte is an ASCII char
-            // If MSB is set, byte is part of a UTF-8 char. Counting number of higher-order bits tells how many bytes in char
-            if ((c & 0x80)) {
-                char c1 = c;
-                while (c1 & 0x80) {
-                    c1 <<= 1;
-                    utf8CharSize++;
-                }
-            }
+    const uint8_t *in = reinterpret_cast<const uint8_t *>(encoded);
+    const uint8_t *end = in + length;
+    char *out = output;
+
+    while (in < end) {
+        // If MSB is unset, byte is an ASCII char, no remapping
+        if (!(*in & 0x80)) {
+            *out++ = *in++;
+            continue;
         }
 
-        // Append the byte to the UTF-8 char we're building
-        utf8Char += c;
+        // If MSB is set, byte is part of a UTF-8 char. Counting number of higher-order bits tells how many bytes in char
+        uint8_t charSize = 0;
+        for (uint8_t c = *in; c & 0x80; c <<= 1)
+            charSize++;
 
-        // More bytes left to collect. Iterate.
-        if (utf8Char.length() < utf8CharSize)
-            continue;
+        // Text ends partway through a char: drop it
+        if (charSize > end - in)
+            break;
 
-        // Now collected all bytes for this char
-        // Remap the value to match the encoding of our 8-bit AppletFont
-        decoded += applyEncoding(utf8Char);
+        // A stray continuation byte is passed through unchanged
+        // Otherwise, remap the value to match the encoding of our 8-bit AppletFont
+        if (charSize == 1)
+            *out++ = *in;
+        else
+            *out++ = applyEncoding(toUtf32(in, charSize));
 
-        // Reset, ready to build next UTF-8 char from the encoded bytes
-        utf8Char.clear();
-        utf8CharSize = 0;
-    } // For each char
+        in += charSize;
+    }
 
-    // All chars processed, return result
-    return decoded;
+    return out - output;
 }
 
-// Re-encode a single UTF-8 character to extended ASCII
+// Re-encode a single multi-byte UTF-8 character to extended ASCII, by its UTF-32 value
 // Target encoding depends on the font
-char InkHUD::AppletFont::applyEncoding(std::string utf8)
+// The switch statements compile to jump tables / binary searches, so no need to scan through the mappings
+char InkHUD::AppletFont::applyEncoding(uint32_t utf32)
 {
     // ##################################################### Syntactic Sugar #####################################################
 #define REMAP(in, out)                                                                                                           \
@@ -189,12 +192,7 @@ char InkHUD::AppletFont::applyEncoding(std::string utf8)
     // Latin - Central Europe
     // https://www.unicode.org/Public/MAPPINGS/VENDORS/MICSFT/WINDOWS/CP1250.TXT
     if (encoding == WINDOWS_1250) {
-        // 1-Byte chars: no remapping
-        if (utf8.length() == 1)
-            return utf8.at(0);
-
-        // Multi-byte chars:
-        switch (toUtf32(utf8)) {
+        switch (utf32) {
             REMAP(0x20AC, 0x80); // EURO SIGN
             REMAP(0x201A, 0x82); // SINGLE LOW-9 QUOTATION MARK
             REMAP(0x201E, 0x84); // DOUBLE LOW-9 QUOTATION MARK
@@ -331,12 +329,7 @@ char InkHUD::AppletFont::applyEncoding(std::string utf8)
     // Latin - Cyrillic
     // https://www.unicode.org/Public/MAPPINGS/VENDORS/MICSFT/WINDOWS/CP1251.TXT
     else if (encoding == WINDOWS_1251) {
-        // 1-Byte chars: no remapping
-        if (utf8.length() == 1)
-            return utf8.at(0);
-
-        // Multi-byte chars:
-        switch (toUtf32(utf8)) {
+        switch (utf32) {
             REMAP(0x0402, 0x80); // CYRILLIC CAPITAL LETTER DJE
             REMAP(0x0403, 0x81); // CYRILLIC CAPITAL LETTER GJE
             REMAP(0x201A, 0x82); // SINGLE LOW-9 QUOTATION MARK
@@ -477,12 +470,7 @@ char InkHUD::AppletFont::applyEncoding(std::string utf8)
     // Latin - Western Europe
     // https://www.unicode.org/Public/MAPPINGS/VENDORS/MICSFT/WINDOWS/CP1252.TXT
     else if (encoding == WINDOWS_1252) {
-        // 1-Byte chars: no remapping
-        if (utf8.length() == 1)
-            return utf8.at(0);
-
-        // Multi-byte chars:
-        switch (toUtf32(utf8)) {
+        switch (utf32) {
             REMAP(0x20AC, 0x80) // EURO SIGN
             REMAP(0x201A, 0x82) // SINGLE LOW-9 QUOTATION MARK
             REMAP(0x0192, 0x83) // LATIN SMALL LETTER F WITH HOOK
@@ -616,18 +604,12 @@ char InkHUD::AppletFont::applyEncoding(std::string utf8)
         }
     }
 
-    else /*ASCII or Unhandled*/ {
-        if (utf8.length() == 1)
-            return utf8.at(0);
-    }
-
-    // All single-byte (ASCII) characters should have been handled by now
     // Only unhandled multi-byte UTF8 characters should remain
-    assert(utf8.length() > 1);
+    // (ASCII, or a char not found in the font's encoding)
 
     // Parse emoji
     // Strip emoji modifiers
-    switch (toUtf32(utf8)) {
+    switch (utf32) {
         REMAP(0x1F44D, 0x01) // 👍 Thumbs Up
         REMAP(0x1F44E, 0x02) // 👎 Thumbs Down
 
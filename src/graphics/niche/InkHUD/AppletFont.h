@@ -1,4 +1,4 @@
-#ifdef MESHTASTIC_INCLUDE_INKHUD
+#if defined(MESHTASTIC_INCLUDE_INKHUD) || defined(MESHTASTIC_INCLUDE_INKHUD_FONT)
 
 /*
 
@@ -36,13 +36,14 @@ class AppletFont
     uint8_t heightBelowCursor();
     uint8_t widthBetweenWords(); // Width of the space character
 
-    std::string decodeUTF8(std::string encoded);
+    std::string decodeUTF8(const std::string &encoded);
+    size_t decodeUTF8(const char *encoded, size_t length, char *output); // Output needs length bytes, may be encoded itself
 
     const GFXfont *gfxFont = NULL; // Default value: in-built AdafruitGFX font
 
   private:
-    uint32_t toUtf32(std::string utf8);
-    char applyEncoding(std::string utf8);
+    static uint32_t toUtf32(const uint8_t *utf8, uint8_t length);
+    char applyEncoding(uint32_t utf32);
 
     uint8_t height = 8;          // Default value: in-built AdafruitGFX font
     uint8_t ascenderHeight = 0;  // Default value: in-built AdafruitGFX font
@@ -115,6 +115,19 @@ void InkHUD::Renderer::handlePixel(int16_t x, int16_t y, Color c)
 {
     rotatePixelCoords(&x, &y);
 
+    // During a partial render, the rest of the image stays as it was
+    if (clipToDamage) {
+        bool inside = false;
+        for (const Region &r : damage) {
+            if (x >= r.left * 8 && x < r.right * 8 && y >= r.top && y < r.bottom) {
+                inside = true;
+                break;
+            }
+        }
+        if (!inside)
+            return;
+    }
+
     uint32_t byteNum = (y * imageBufferWidth) + (x / 8); // X data is 8 pixels per byte
     uint8_t bitNum = 7 - (x % 8); // Invert order: leftmost bit (most significant) is leftmost pixel of byte.
 
@@ -218,18 +231,37 @@ void InkHUD::Renderer::render(bool async)
         // Done early, as rendering resets the Applets' requested types
         Drivers::EInk::UpdateTypes updateType = decideUpdateType();
 
+        // Work out which applets make up the new image,
+        // and whether only some of them need to be drawn again
+        std::vector<Layer> layers = composeLayers();
+        clipToDamage = findDamage(layers);
+
         // Render the new image
-        clearBuffer();
-        renderUserApplets();
-        renderPlaceholders();
-        renderSystemApplets();
+        uint32_t start = millis();
+        if (clipToDamage)
+            clearDamage();
+        else
+            clearBuffer();
+        renderLayers(layers);
 
         // Invert Buffer if set by user
-        if (config.display.displaymode == meshtastic_Config_DisplayConfig_DisplayMode_INVERTED) {
-            for (size_t i = 0; i < imageBufferWidth * imageBufferHeight; ++i) {
-                imageBuffer[i] = ~imageBuffer[i];
+        if (config.display.displaymode == meshtastic_Config_DisplayConfig_DisplayMode_INVERTED)
+            invertBuffer();
+        LOG_DEBUG("Rendered %s image in %dms", clipToDamage ? "partial" : "full", millis() - start);
+
+        // Let the driver know which rows of the image changed, in case it can send just those to the display
+        uint16_t windowTop = 0;
+        uint16_t windowBottom = driver->height;
+        if (clipToDamage) {
+            windowTop = driver->height;
+            windowBottom = 0;
+            for (const Region &r : damage) {
+                windowTop = min(windowTop, r.top);
+                windowBottom = max(windowBottom, r.bottom);
             }
         }
+        driver->setUpdateWindow(windowTop, windowBottom - windowTop);
+        clipToDamage = false;
 
         // Tell display to begin process of drawing new image
         LOG_INFO("Updating display");
@@ -252,13 +284,43 @@ void InkHUD::Renderer::render(bool async)
 // Manually fill the image buffer with WHITE
 // Clears any old drawing
 // Note: benchmarking revealed that this is *much* faster than setting pixels individually
-// So much so that it's more efficient to re-render all applets,
+// So much so that it's more efficient to re-render whole applets,
 // rather than rendering selectively, and manually blanking a portion of the display
 void InkHUD::Renderer::clearBuffer()
 {
     memset(imageBuffer, 0xFF, imageBufferHeight * imageBufferWidth);
 }
 
+// Fill only the damaged regions with WHITE, a row at a time
+// The applets covering these regions will be drawn again in full
+void InkHUD::Renderer::clearDamage()
+{
+    for (const Region &r : damage) {
+        for (uint16_t y = r.top; y < r.bottom; y++)
+            memset(imageBuffer + (y * imageBufferWidth) + r.left, 0xFF, r.right - r.left);
+    }
+}
+
+// Invert the newly rendered image
+// During a partial render, only the damaged regions: the rest of the buffer was inverted last time
+void InkHUD::Renderer::invertBuffer()
+{
+    if (!clipToDamage) {
+        for (size_t i = 0; i < imageBufferWidth * imageBufferHeight; ++i) {
+            imageBuffer[i] = ~imageBuffer[i];
+        }
+        return;
+    }
+
+    for (const Region &r : damage) {
+        for (uint16_t y = r.top; y < r.bottom; y++) {
+            uint8_t *row = imageBuffer + (y * imageBufferWidth);
+            for (uint16_t b = r.left; b < r.right; b++)
+                row[b] = ~row[b];
+        }
+    }
+}
+
 void InkHUD::Renderer::checkLocks()
 {
     lockRendering = nullptr;
@@ -336,29 +398,32 @@ Drivers::EInk::UpdateTypes InkHUD::Renderer::decideUpdateType()
     return displayHealth.decideUpdateType();
 }
 
-// Run the drawing operations of any user applets which are currently displayed
-// Pixel output is placed into the framebuffer, ready for handoff to the EInk driver
-void InkHUD::Renderer::renderUserApplets()
+// Determine which applets will be drawn, and on which tiles
+// User applets first, then placeholders for any empty user tiles, then system applets over the top
+std::vector<InkHUD::Renderer::Layer> InkHUD::Renderer::composeLayers()
 {
-    // Don't render user applets if a system applet has demanded the whole display to itself
-    if (lockRendering)
-        return;
+    std::vector<Layer> layers;
 
-    // Render any user applets which are currently visible
-    for (Applet *ua : inkhud->userApplets) {
-        if (ua && ua->isActive() && ua->isForeground()) {
-            uint32_t start = millis();
-            ua->render(); // Draw!
-            uint32_t stop = millis();
-            LOG_DEBUG("%s took %dms to render", ua->name, stop - start);
+    auto addLayer = [&layers](Applet *a, Tile *t) {
+        layers.push_back({a, t, t->getLeft(), t->getTop(), t->getWidth(), t->getHeight()});
+    };
+
+    // Don't render user applets or placeholders if a system applet has demanded the whole display to itself
+    if (!lockRendering) {
+        // Any user applets which are currently visible
+        for (Applet *ua : inkhud->userApplets) {
+            if (ua && ua->isActive() && ua->isForeground())
+                addLayer(ua, ua->getTile());
         }
+
+        // In some situations (e.g. layout or applet selection changes),
+        // a user tile can end up without an assigned applet.
+        // In this case, we will fill the empty space with diagonal lines.
+        SystemApplet *placeholder = inkhud->getSystemApplet("Placeholder");
+        for (Tile *t : inkhud->getEmptyTiles())
+            addLayer(placeholder, t);
     }
-}
 
-// Run the drawing operations of any system applets which are currently displayed
-// Pixel output is placed into the framebuffer, ready for handoff to the EInk driver
-void InkHUD::Renderer::renderSystemApplets()
-{
     SystemApplet *battery = inkhud->getSystemApplet("BatteryIcon");
     SystemApplet *menu = inkhud->getSystemApplet("Menu");
     SystemApplet *notifications = inkhud->getSystemApplet("Notification");
@@ -380,40 +445,110 @@ void InkHUD::Renderer::renderSystemApplets()
             continue;
 
         assert(sa->getTile());
-
-        // uint32_t start = millis();
-        sa->render(); // Draw!
-        // uint32_t stop = millis();
-        // LOG_DEBUG("%s took %dms to render", sa->name, stop - start);
+        addLayer(sa, sa->getTile());
     }
+
+    return layers;
 }
 
-// In some situations (e.g. layout or applet selection changes),
-// a user tile can end up without an assigned applet.
-// In this case, we will fill the empty space with diagonal lines.
-void InkHUD::Renderer::renderPlaceholders()
+// Decide whether it is enough to redraw only part of the image
+// Only possible if the same applets are shown in the same places as last time: then only applets which requested an update
+// can have changed. Their tiles become the damaged regions.
+// Returns false if the whole image needs to be redrawn
+bool InkHUD::Renderer::findDamage(const std::vector<Layer> &layers)
 {
-    // Don't fill empty space with placeholders if a system applet wants exclusive use of the display
-    if (lockRendering)
-        return;
+    damage.clear();
 
-    // Ask the window manager which tiles are empty
-    std::vector<Tile *> emptyTiles = inkhud->getEmptyTiles();
+    bool inverted = (config.display.displaymode == meshtastic_Config_DisplayConfig_DisplayMode_INVERTED);
+    bool sameLayout = !forced && !lockRendering && layers == previousLayers && settings->rotation == previousRotation &&
+                      inverted == previousInverted;
 
-    // No empty tiles
-    if (emptyTiles.size() == 0)
-        return;
+    previousLayers = layers;
+    previousRotation = settings->rotation;
+    previousInverted = inverted;
+
+    if (!sameLayout)
+        return false;
 
-    SystemApplet *placeholder = inkhud->getSystemApplet("Placeholder");
+    for (const Layer &l : layers) {
+        if (!l.applet->wantsToRender())
+            continue;
 
-    // uint32_t start = millis();
-    for (Tile *t : emptyTiles) {
-        t->assignApplet(placeholder);
-        placeholder->render();
-        t->assignApplet(nullptr);
+        // Merge with any damage this overlaps (system applets sit on top of user tiles),
+        // so that no part of the buffer is cleared or inverted twice
+        Region r = getBufferRegion(l.tile);
+        for (size_t i = 0; i < damage.size();) {
+            if (damage[i].intersects(r)) {
+                r.left = min(r.left, damage[i].left);
+                r.top = min(r.top, damage[i].top);
+                r.right = max(r.right, damage[i].right);
+                r.bottom = max(r.bottom, damage[i].bottom);
+                damage.erase(damage.begin() + i);
+                i = 0; // Grown, so might now overlap something already checked
+            } else
+                i++;
+        }
+        damage.push_back(r);
     }
-    // uint32_t stop = millis();
-    // LOG_DEBUG("Placeholders took %dms to render", stop - start);
+
+    return !damage.empty();
+}
+
+// Run the drawing operations of each applet in the image
+// Pixel output is placed into the framebuffer, ready for handoff to the EInk driver
+void InkHUD::Renderer::renderLayers(const std::vector<Layer> &layers)
+{
+    for (const Layer &l : layers) {
+        // During a partial render, skip applets which don't touch the damaged regions
+        if (clipToDamage) {
+            Region r = getBufferRegion(l.tile);
+            bool touched = false;
+            for (const Region &d : damage)
+                touched |= d.intersects(r);
+            if (!touched)
+                continue;
+        }
+
+        // Placeholder applet is lent to each empty tile in turn
+        bool borrowed = (l.tile->getAssignedApplet() != l.applet);
+        if (borrowed)
+            l.tile->assignApplet(l.applet);
+
+        l.applet->render(); // Draw!
+
+        if (borrowed)
+            l.tile->assignApplet(nullptr);
+    }
+}
+
+// Part of the image buffer covered by a tile, once the display rotation is applied
+// Widened to whole bytes, so that it can be cleared with memset
+InkHUD::Renderer::Region InkHUD::Renderer::getBufferRegion(Tile *t)
+{
+    int16_t x1 = t->getLeft();
+    int16_t y1 = t->getTop();
+    int16_t x2 = x1 + t->getWidth() - 1;
+    int16_t y2 = y1 + t->getHeight() - 1;
+    rotatePixelCoords(&x1, &y1);
+    rotatePixelCoords(&x2, &y2);
+
+    int16_t left = constrain(min(x1, x2), 0, driver->width - 1);
+    int16_t right = constrain(max(x1, x2), 0, driver->width - 1);
+    int16_t top = constrain(min(y1, y2), 0, driver->height - 1);
+    int16_t bottom = constrain(max(y1, y2), 0, driver->height - 1);
+
+    return {(uint16_t)(left / 8), (uint16_t)top, (uint16_t)((right / 8) + 1), (uint16_t)(bottom + 1)};
+}
+
+bool InkHUD::Renderer::Layer::operator==(const Layer &other) const
+{
+    return applet == other.applet && tile == other.tile && left == other.left && top == other.top && width == other.width &&
+           height == other.height;
+}
+
+bool InkHUD::Renderer::Region::intersects(const Region &other) const
+{
+    return left < other.right && other.left < right && top < other.bottom && other.top < bottom;
 }
 
 #endif
\ No newline at end of file
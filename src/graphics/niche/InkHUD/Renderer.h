@@ -53,6 +53,28 @@ class Renderer : protected concurrency::OSThread
     uint16_t height();
 
   private:
+    // One applet, drawn on one tile, as part of the image
+    struct Layer {
+        Applet *applet;
+        Tile *tile;
+        int16_t left;
+        int16_t top;
+        uint16_t width;
+        uint16_t height;
+
+        bool operator==(const Layer &other) const;
+    };
+
+    // Rectangle of the image buffer. Horizontally in bytes (8px), vertically in rows. Right and bottom are exclusive.
+    struct Region {
+        uint16_t left;
+        uint16_t top;
+        uint16_t right;
+        uint16_t bottom;
+
+        bool intersects(const Region &other) const;
+    };
+
     // Make attemps to render / update, once triggered by requestUpdate or forceUpdate
     int32_t runOnce() override;
 
@@ -68,9 +90,13 @@ class Renderer : protected concurrency::OSThread
     void checkLocks();
     bool shouldUpdate();
     Drivers::EInk::UpdateTypes decideUpdateType();
-    void renderUserApplets();
-    void renderSystemApplets();
-    void renderPlaceholders();
+    std::vector<Layer> composeLayers();
+    bool findDamage(const std::vector<Layer> &layers);
+    void clearDamage();
+    void renderLayers(const std::vector<Layer> &layers);
+    void invertBuffer();
+
+    Region getBufferRegion(Tile *t); // Part of the image buffer which a tile covers, after rotation
 
     Drivers::EInk *driver = nullptr; // Interacts with your variants display hardware
     DisplayHealth displayHealth;     // Manages display health by controlling type of update
@@ -80,6 +106,14 @@ class Renderer : protected concurrency::OSThread
     uint16_t imageBufferWidth = 0;
     uint32_t imageBufferSize = 0; // Bytes
 
+    // Partial rendering: if the same applets are on the same tiles as last time,
+    // only the tiles of applets which requested an update are cleared and drawn again
+    std::vector<Layer> previousLayers;
+    uint8_t previousRotation = 0;
+    bool previousInverted = false;
+    std::vector<Region> damage; // Parts of the image being redrawn. Empty when redrawing everything
+    bool clipToDamage = false;  // Discard pixels outside the damaged regions
+
     SystemApplet *lockRendering = nullptr; // Render this applet *only*
     SystemApplet *lockRequests = nullptr;  // Honor update requests from this applet *only*
 
@@ -190,6 +190,18 @@ void InkHUD::Tile::handleAppletPixel(int16_t x, int16_t y, Color c)
     }
 }
 
+// Position of the tile on the display, before rotation
+// Used by the renderer, to work out which part of the image an applet covers
+int16_t InkHUD::Tile::getLeft()
+{
+    return left;
+}
+
+int16_t InkHUD::Tile::getTop()
+{
+    return top;
+}
+
 // Called by Applet base class, when setting applet dimensions, immediately before render
 uint16_t InkHUD::Tile::getWidth()
 {
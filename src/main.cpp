@@ -83,6 +83,7 @@ NRF52Bluetooth *nrf52Bluetooth = nullptr;
 #endif
 
 #if defined(ARCH_PORTDUINO)
+#include "platform/portduino/MeshSimulator.h"
 #include "platform/portduino/SimRadio.h"
 #endif
 
@@ -1417,6 +1418,13 @@ void setup()
         LOG_DEBUG("LoRA bitrate = %f bytes / sec", (float(meshtastic_Constants_DATA_PAYLOAD_LEN) /
                                                     (float(rIf->getPacketTime(meshtastic_Constants_DATA_PAYLOAD_LEN)))) *
                                                        1000);
+
+#ifdef ARCH_PORTDUINO
+        if (simMeshNodes > 0) {
+            runMeshSimulation(*rIf, simMeshNodes);
+            exit(EXIT_SUCCESS);
+        }
+#endif
     }
 
     // This must be _after_ service.init because we need our preferences loaded from flash to have proper timeout values
@@ -294,6 +294,8 @@ void Channels::onConfigChanged()
             primaryIndex = i;
     }
 #if !MESHTASTIC_EXCLUDE_MQTT
+    if (mqtt)
+        mqtt->onChannelsChanged();
     if (channels.anyMqttEnabled() && mqtt && !mqtt->isEnabled()) {
         LOG_DEBUG("MQTT is enabled on at least one channel, so set MQTT thread to run immediately");
         mqtt->start();
@@ -83,6 +83,15 @@ class Channels
      */
     int16_t setActiveByIndex(ChannelIndex channelIndex);
 
+    /// The (0 to 255) hash for a channel, or -1 if it is invalid
+    int16_t getHash(ChannelIndex i) { return hashes[i]; }
+
+    /**
+     * Return the key used for encrypting this channel (if channel is secondary and no key provided, use the primary channel's
+     * PSK)
+     */
+    CryptoKey getKey(ChannelIndex chIndex);
+
     // Returns true if the channel has the default name and PSK
     bool isDefaultChannel(ChannelIndex chIndex);
 
@@ -111,8 +120,6 @@ class Channels
      */
     int16_t generateHash(ChannelIndex channelNum);
 
-    int16_t getHash(ChannelIndex i) { return hashes[i]; }
-
     /**
      * Validate a channel, fixing any errors as needed
      */
@@ -127,12 +134,6 @@ class Channels
      * Write default channels defined in UserPrefs
      */
     void initDefaultChannel(ChannelIndex chIndex);
-
-    /**
-     * Return the key used for encrypting this channel (if channel is secondary and no key provided, use the primary channel's
-     * PSK)
-     */
-    CryptoKey getKey(ChannelIndex chIndex);
 };
 
 /// Singleton channel table
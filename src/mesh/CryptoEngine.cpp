@@ -233,16 +233,32 @@ void CryptoEngine::decrypt(uint32_t fromNode, uint64_t packetId, size_t numBytes
     encryptPacket(fromNode, packetId, numBytes, bytes);
 }
 
+void CryptoEngine::decryptBatch(DecryptJob *jobs, size_t numJobs)
+{
+    // Goes through encryptAESCtr() so platforms with hardware AES use it here too
+    for (size_t i = 0; i < numJobs; i++) {
+        DecryptJob &job = jobs[i];
+        if (job.key->length <= 0 || job.numBytes > MAX_BLOCKSIZE)
+            continue;
+        initNonce(job.fromNode, job.packetId);
+        encryptAESCtr(*job.key, nonce, job.numBytes, job.bytes);
+    }
+}
+
 // Generic implementation of AES-CTR encryption.
 void CryptoEngine::encryptAESCtr(CryptoKey _key, uint8_t *_nonce, size_t numBytes, uint8_t *bytes)
 {
-    delete ctr;
-    ctr = nullptr;
-    if (_key.length == 16)
-        ctr = new CTR<AES128>();
-    else
-        ctr = new CTR<AES256>();
-    ctr->setKey(_key.bytes, _key.length);
+    // Only rebuild the cipher when the key changes, consecutive packets on a channel share it
+    if (!ctr || ctrKey.length != _key.length || memcmp(ctrKey.bytes, _key.bytes, _key.length)) {
+        delete ctr;
+        ctr = nullptr;
+        if (_key.length == 16)
+            ctr = new CTR<AES128>();
+        else
+            ctr = new CTR<AES256>();
+        ctr->setKey(_key.bytes, _key.length);
+        ctrKey = _key;
+    }
     static uint8_t scratch[MAX_BLOCKSIZE];
     memcpy(scratch, bytes, numBytes);
     memset(scratch + numBytes, 0,
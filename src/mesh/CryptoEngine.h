@@ -71,6 +71,24 @@ class CryptoEngine
      */
     virtual void encryptPacket(uint32_t fromNode, uint64_t packetId, size_t numBytes, uint8_t *bytes);
     virtual void decrypt(uint32_t fromNode, uint64_t packetId, size_t numBytes, uint8_t *bytes);
+
+    /// One packet for decryptBatch()
+    struct DecryptJob {
+        const CryptoKey *key;
+        uint32_t fromNode;
+        uint64_t packetId;
+        size_t numBytes;
+        uint8_t *bytes; // updated in place
+    };
+
+    /**
+     * Decrypt several packets in one call
+     *
+     * Each job goes through encryptAESCtr(), so hardware implementations are used; platforms that can do better with many
+     * packets at once override this.  Consecutive jobs using the same key share one key schedule, so callers should group
+     * jobs by key.  Jobs with no key or more than MAX_BLOCKSIZE bytes are left untouched, same as decrypt().
+     */
+    virtual void decryptBatch(DecryptJob *jobs, size_t numJobs);
     virtual void encryptAESCtr(CryptoKey key, uint8_t *nonce, size_t numBytes, uint8_t *bytes);
 #ifndef PIO_UNIT_TESTING
   protected:
@@ -79,6 +97,7 @@ class CryptoEngine
     uint8_t nonce[16] = {0};
     CryptoKey key = {};
     CTRCommon *ctr = NULL;
+    CryptoKey ctrKey = {}; // the key ctr was set up with
 #if !(MESHTASTIC_EXCLUDE_PKI)
     uint8_t shared_key[32] = {0};
     uint8_t private_key[32] = {0};
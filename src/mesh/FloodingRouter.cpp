@@ -43,11 +43,22 @@ bool FloodingRouter::shouldFilterReceived(const meshtastic_MeshPacket *p)
     return Router::shouldFilterReceived(p);
 }
 
+bool FloodingRouter::roleCancelsDupes(meshtastic_Config_DeviceConfig_Role role)
+{
+    return role != meshtastic_Config_DeviceConfig_Role_ROUTER && role != meshtastic_Config_DeviceConfig_Role_REPEATER &&
+           role != meshtastic_Config_DeviceConfig_Role_ROUTER_LATE;
+}
+
+bool FloodingRouter::roleRebroadcasts(meshtastic_Config_DeviceConfig_Role role,
+                                      meshtastic_Config_DeviceConfig_RebroadcastMode rebroadcastMode)
+{
+    return role != meshtastic_Config_DeviceConfig_Role_CLIENT_MUTE &&
+           rebroadcastMode != meshtastic_Config_DeviceConfig_RebroadcastMode_NONE;
+}
+
 void FloodingRouter::perhapsCancelDupe(const meshtastic_MeshPacket *p)
 {
-    if (config.device.role != meshtastic_Config_DeviceConfig_Role_ROUTER &&
-        config.device.role != meshtastic_Config_DeviceConfig_Role_REPEATER &&
-        config.device.role != meshtastic_Config_DeviceConfig_Role_ROUTER_LATE) {
+    if (roleCancelsDupes(config.device.role)) {
         // cancel rebroadcast of this message *if* there was already one, unless we're a router/repeater!
         if (Router::cancelSending(p->from, p->id))
             txRelayCanceled++;
@@ -59,8 +70,7 @@ void FloodingRouter::perhapsCancelDupe(const meshtastic_MeshPacket *p)
 
 bool FloodingRouter::isRebroadcaster()
 {
-    return config.device.role != meshtastic_Config_DeviceConfig_Role_CLIENT_MUTE &&
-           config.device.rebroadcast_mode != meshtastic_Config_DeviceConfig_RebroadcastMode_NONE;
+    return roleRebroadcasts(config.device.role, config.device.rebroadcast_mode);
 }
 
 void FloodingRouter::perhapsRebroadcast(const meshtastic_MeshPacket *p)
@@ -45,6 +45,13 @@ class FloodingRouter : public Router
      */
     virtual ErrorCode send(meshtastic_MeshPacket *p) override;
 
+    /// Does a node with this role cancel its pending rebroadcast when it hears someone else relay the packet first
+    static bool roleCancelsDupes(meshtastic_Config_DeviceConfig_Role role);
+
+    /// Does a node with this role and rebroadcast mode relay floods at all
+    static bool roleRebroadcasts(meshtastic_Config_DeviceConfig_Role role,
+                                 meshtastic_Config_DeviceConfig_RebroadcastMode rebroadcastMode);
+
   protected:
     /**
      * Should this incoming filter be dropped?
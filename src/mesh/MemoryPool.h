@@ -2,8 +2,11 @@
 
 #include <Arduino.h>
 #include <assert.h>
+#include <atomic>
 #include <functional>
 #include <memory>
+#include <new>
+#include <stddef.h>
 
 #include "PointerQueue.h"
 
@@ -62,6 +65,39 @@ template <class T> class Allocator
         return UniqueAllocation(allocCopy(src, maxWait), deleter);
     }
 
+    /**
+     * Take another reference to an object from this pool, so that it can be handed to a second owner (e.g. the phone queue)
+     * without copying it.  Each reference must be given back with release().  Shared objects are read-only: an owner that wants
+     * to change one must call makeWritable() first.
+     *
+     * Allocators that can't share storage fall back to returning a copy, which is always safe.
+     */
+    virtual T *retain(const T *p) { return allocCopy(*p); }
+
+    /// Return true if more than one owner currently holds a reference to this object
+    virtual bool isShared(const T *p) const { return false; }
+
+    /**
+     * Copy-on-write: return an object that the caller may modify.  If the caller is the only owner that is p itself, otherwise
+     * the caller's reference to p is dropped and it gets a private copy instead.
+     */
+    T *makeWritable(T *p)
+    {
+        if (!isShared(p))
+            return p;
+
+        T *copy = allocCopy(*p);
+        release(p);
+        numCopiedOnWrite++;
+        return copy;
+    }
+
+    /// Number of times retain() shared an object instead of copying it
+    uint32_t getNumShared() const { return numShared.load(); }
+
+    /// Number of shared objects that later had to be copied by makeWritable() after all
+    uint32_t getNumCopiedOnWrite() const { return numCopiedOnWrite.load(); }
+
     /// Return a buffer for use by others
     virtual void release(T *p) = 0;
 
@@ -69,30 +105,72 @@ template <class T> class Allocator
     // Alloc some storage
     virtual T *alloc(TickType_t maxWait) = 0;
 
+    std::atomic<uint32_t> numShared{0};
+    std::atomic<uint32_t> numCopiedOnWrite{0};
+
   private:
     // std::unique_ptr Deleter function; calls release().
     const std::function<void(T *)> deleter;
 };
 
 /**
- * An allocator that just uses regular free/malloc
+ * An allocator that just uses regular free/malloc.
+ *
+ * Each allocation is prefixed with a small header holding a reference count, so objects can be shared with retain() and are
+ * only freed when the last owner releases them.  The count is atomic, because the owners don't all live on the main loop: on
+ * native the phone API threads of the web server release the packets the main loop queued for them.
  */
 template <class T> class MemoryDynamic : public Allocator<T>
 {
   public:
+    virtual T *retain(const T *p) override
+    {
+        assert(p);
+        Header *h = headerOf(p);
+        // Only an owner can take another reference, so the count can't reach zero underneath us
+        assert(h->refs.load(std::memory_order_relaxed) > 0);
+        h->refs.fetch_add(1, std::memory_order_relaxed);
+        this->numShared++;
+        return const_cast<T *>(p);
+    }
+
+    virtual bool isShared(const T *p) const override { return headerOf(p)->refs.load(std::memory_order_acquire) > 1; }
+
     /// Return a buffer for use by others
     virtual void release(T *p) override
     {
         assert(p);
-        free(p);
+        Header *h = headerOf(p);
+        // Whoever drops the last reference frees, after every other owner's last use of the object
+        const uint16_t before = h->refs.fetch_sub(1, std::memory_order_acq_rel);
+        assert(before > 0);
+        if (before == 1) {
+            h->~Header();
+            free(h);
+        }
     }
 
   protected:
     // Alloc some storage
     virtual T *alloc(TickType_t maxWait) override
     {
-        T *p = (T *)malloc(sizeof(T));
-        assert(p);
-        return p;
+        void *storage = malloc(HEADER_SIZE + sizeof(T));
+        assert(storage);
+        if (!storage)
+            return NULL;
+        Header *h = new (storage) Header;
+        h->refs.store(1, std::memory_order_relaxed);
+        return (T *)((uint8_t *)h + HEADER_SIZE);
     }
+
+  private:
+    struct Header {
+        std::atomic<uint16_t> refs;
+    };
+
+    // Keep the object itself at malloc()'s alignment
+    static constexpr size_t HEADER_SIZE =
+        (sizeof(Header) + alignof(max_align_t) - 1) / alignof(max_align_t) * alignof(max_align_t);
+
+    static Header *headerOf(const T *p) { return (Header *)((uint8_t *)const_cast<T *>(p) - HEADER_SIZE); }
 };
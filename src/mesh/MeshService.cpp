@@ -105,7 +105,7 @@ int MeshService::handleFromRadio(const meshtastic_MeshPacket *mp)
     }
 
     printPacket("Forwarding to phone", mp);
-    sendToPhone(packetPool.allocCopy(*mp));
+    sendToPhone(packetPool.retain(mp)); // mp is owned by the router, share it rather than copying
 
     return 0;
 }
@@ -196,10 +196,11 @@ void MeshService::handleToRadio(meshtastic_MeshPacket &p)
 
     bool loopback = false; // if true send any packet the phone sends back itself (for testing)
     if (loopback) {
-        // no need to copy anymore because handle from radio assumes it should _not_ delete
-        // packetPool.allocCopy(r.variant.packet);
-        handleFromRadio(&p);
+        // handleFromRadio may keep a reference to the packet, so it must come from the pool
+        meshtastic_MeshPacket *copy = packetPool.allocCopy(p);
+        handleFromRadio(copy);
         // handleFromRadio will tell the phone a new packet arrived
+        packetPool.release(copy);
     }
 }
 
@@ -282,6 +283,9 @@ bool MeshService::trySendPosition(NodeNum dest, bool wantReplies)
 
 void MeshService::sendToPhone(meshtastic_MeshPacket *p)
 {
+    // p might be shared with the router, only take a private copy if decoding is going to change it
+    if (p->which_payload_variant == meshtastic_MeshPacket_encrypted_tag)
+        p = packetPool.makeWritable(p);
     perhapsDecode(p);
 
 #ifdef ARCH_ESP32
@@ -204,74 +204,115 @@ PendingPacket *NextHopRouter::startRetransmission(meshtastic_MeshPacket *p, uint
 int32_t NextHopRouter::doRetransmissions()
 {
     uint32_t now = millis();
-    int32_t d = INT32_MAX;
-
-    // FIXME, we should use a better datastructure rather than walking through this map.
-    // for(auto el: pending) {
-    for (auto it = pending.begin(), nextIt = it; it != pending.end(); it = nextIt) {
-        ++nextIt; // we use this odd pattern because we might be deleting it...
-        auto &p = it->second;
-
-        bool stillValid = true; // assume we'll keep this record around
-
-        // FIXME, handle 51 day rolloever here!!!
-        if (p.nextTxMsec <= now) {
-            if (p.numRetransmissions == 0) {
-                if (isFromUs(p.packet)) {
-                    LOG_DEBUG("Reliable send failed, returning a nak for fr=0x%x,to=0x%x,id=0x%x", p.packet->from, p.packet->to,
-                              p.packet->id);
-                    sendAckNak(meshtastic_Routing_Error_MAX_RETRANSMIT, getFrom(p.packet), p.packet->id, p.packet->channel);
-                }
-                // Note: we don't stop retransmission here, instead the Nak packet gets processed in sniffReceived
-                stopRetransmission(it->first);
-                stillValid = false; // just deleted it
-            } else {
-                LOG_DEBUG("Sending retransmission fr=0x%x,to=0x%x,id=0x%x, tries left=%d", p.packet->from, p.packet->to,
-                          p.packet->id, p.numRetransmissions);
-
-                if (!isBroadcast(p.packet->to)) {
-                    if (p.numRetransmissions == 1) {
-                        // Last retransmission, reset next_hop (fallback to FloodingRouter)
-                        p.packet->next_hop = NO_NEXT_HOP_PREFERENCE;
-                        // Also reset it in the nodeDB
-                        meshtastic_NodeInfoLite *sentTo = nodeDB->getMeshNode(p.packet->to);
-                        if (sentTo) {
-                            LOG_INFO("Resetting next hop for packet with dest 0x%x\n", p.packet->to);
-                            sentTo->next_hop = NO_NEXT_HOP_PREFERENCE;
-                        }
-                        FloodingRouter::send(packetPool.allocCopy(*p.packet));
-                    } else {
-                        NextHopRouter::send(packetPool.allocCopy(*p.packet));
+    RetransmissionDeadline top = {0, 0, GlobalPacketId(0, 0)};
+    int32_t waitMsec;
+
+    while (popDueRetransmission(now, top, waitMsec)) {
+        PendingPacket *p = findPendingPacket(top.key);
+
+        if (p->numRetransmissions == 0) {
+            if (isFromUs(p->packet)) {
+                LOG_DEBUG("Reliable send failed, returning a nak for fr=0x%x,to=0x%x,id=0x%x", p->packet->from, p->packet->to,
+                          p->packet->id);
+                sendAckNak(meshtastic_Routing_Error_MAX_RETRANSMIT, getFrom(p->packet), p->packet->id, p->packet->channel);
+            }
+            // Note: we don't stop retransmission here, instead the Nak packet gets processed in sniffReceived
+            stopRetransmission(top.key);
+        } else {
+            LOG_DEBUG("Sending retransmission fr=0x%x,to=0x%x,id=0x%x, tries left=%d", p->packet->from, p->packet->to,
+                      p->packet->id, p->numRetransmissions);
+
+            if (!isBroadcast(p->packet->to)) {
+                if (p->numRetransmissions == 1) {
+                    // Last retransmission, reset next_hop (fallback to FloodingRouter)
+                    p->packet->next_hop = NO_NEXT_HOP_PREFERENCE;
+                    // Also reset it in the nodeDB
+                    meshtastic_NodeInfoLite *sentTo = nodeDB->getMeshNode(p->packet->to);
+                    if (sentTo) {
+                        LOG_INFO("Resetting next hop for packet with dest 0x%x\n", p->packet->to);
+                        sentTo->next_hop = NO_NEXT_HOP_PREFERENCE;
                     }
+                    FloodingRouter::send(packetPool.allocCopy(*p->packet));
                 } else {
-                    // Note: we call the superclass version because we don't want to have our version of send() add a new
-                    // retransmission record
-                    FloodingRouter::send(packetPool.allocCopy(*p.packet));
+                    NextHopRouter::send(packetPool.allocCopy(*p->packet));
                 }
+            } else {
+                // Note: we call the superclass version because we don't want to have our version of send() add a new
+                // retransmission record
+                FloodingRouter::send(packetPool.allocCopy(*p->packet));
+            }
 
-                // Queue again
-                --p.numRetransmissions;
-                setNextTx(&p);
+            // Queue again (sending might have replaced or removed our record, so look it up again)
+            p = findPendingPacket(top.key);
+            if (p && p->retxSeq == top.retxSeq) {
+                --p->numRetransmissions;
+                setNextTx(p);
             }
         }
+        now = millis();
+    }
 
-        if (stillValid) {
-            // Update our desired sleep delay
-            int32_t t = p.nextTxMsec - now;
+    return waitMsec;
+}
 
-            d = min(t, d);
+bool NextHopRouter::popDueRetransmission(uint32_t now, RetransmissionDeadline &due, int32_t &waitMsec)
+{
+    while (!retxQueue.empty()) {
+        due = retxQueue.top();
+        const PendingPacket *p = findPendingPacket(due.key);
+        if (!p || p->retxSeq != due.retxSeq) {
+            retxQueue.pop(); // stale, the packet was stopped or rescheduled since
+            continue;
         }
+
+        waitMsec = (int32_t)(p->nextTxMsec + retxDelayMsec - now);
+        if (waitMsec > 0)
+            return false; // Everything else in the queue is due even later
+
+        retxQueue.pop();
+        return true;
     }
 
-    return d;
+    waitMsec = INT32_MAX;
+    return false;
 }
 
 void NextHopRouter::setNextTx(PendingPacket *pending)
 {
     assert(iface);
     auto d = iface->getRetransmissionMsec(pending->packet);
-    pending->nextTxMsec = millis() + d;
+    pending->nextTxMsec = millis() + d - retxDelayMsec;
+    scheduleRetransmission(pending);
     LOG_DEBUG("Setting next retransmission in %u msecs: ", d);
     printPacket("", pending->packet);
     setReceivedMessage(); // Run ASAP, so we can figure out our correct sleep time
-}
\ No newline at end of file
+}
+
+void NextHopRouter::scheduleRetransmission(PendingPacket *pending)
+{
+    // Records that were stopped before their deadline leave stale entries behind, don't let them pile up
+    if (retxQueue.size() > 4 * this->pending.size() + 16) {
+        std::vector<RetransmissionDeadline> live;
+        live.reserve(this->pending.size());
+        for (auto &it : this->pending)
+            live.push_back({it.second.nextTxMsec, it.second.retxSeq, it.first});
+        retxQueue = decltype(retxQueue)(RetransmissionDeadlineLater(), std::move(live));
+    }
+
+    pending->retxSeq = ++nextRetxSeq;
+    retxQueue.push({pending->nextTxMsec, pending->retxSeq, GlobalPacketId(pending->packet)});
+}
+
+void NextHopRouter::delayRetransmissions(uint32_t msec, const meshtastic_MeshPacket *except)
+{
+    retxDelayMsec += msec;
+
+    if (except) {
+        // Keep the deadline of this one where it was
+        PendingPacket *p = findPendingPacket(GlobalPacketId(except));
+        if (p) {
+            p->nextTxMsec -= msec;
+            scheduleRetransmission(p);
+        }
+    }
+}
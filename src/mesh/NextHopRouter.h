@@ -1,7 +1,9 @@
 #pragma once
 
 #include "FloodingRouter.h"
+#include <queue>
 #include <unordered_map>
+#include <vector>
 
 /**
  * An identifier for a globally unique message - a pair of the sending nodenum and the packet id assigned
@@ -32,9 +34,13 @@ struct GlobalPacketId {
 struct PendingPacket {
     meshtastic_MeshPacket *packet;
 
-    /** The next time we should try to retransmit this packet */
+    /** The next time we should try to retransmit this packet, not including NextHopRouter::retxDelayMsec (so delaying all
+     * pending retransmissions at once doesn't need to touch every record) */
     uint32_t nextTxMsec = 0;
 
+    /** Identifies the current entry for this packet in NextHopRouter::retxQueue, older entries are stale */
+    uint32_t retxSeq = 0;
+
     /** Starts at NUM_RETRANSMISSIONS -1 and counts down.  Once zero it will be removed from the list */
     uint8_t numRetransmissions = 0;
 
@@ -48,6 +54,26 @@ class GlobalPacketIdHashFunction
     size_t operator()(const GlobalPacketId &p) const { return (std::hash<NodeNum>()(p.node)) ^ (std::hash<PacketId>()(p.id)); }
 };
 
+/**
+ * An entry in the retransmission deadline heap.  Entries are never removed early, instead they go stale when the pending
+ * record is removed or rescheduled (its retxSeq no longer matches) and get dropped once they reach the top.
+ */
+struct RetransmissionDeadline {
+    uint32_t nextTxMsec; // same base as PendingPacket::nextTxMsec
+    uint32_t retxSeq;
+    GlobalPacketId key;
+};
+
+/// Orders the heap so the earliest deadline is on top, millis() rollover safe as long as deadlines are < 24 days apart
+class RetransmissionDeadlineLater
+{
+  public:
+    bool operator()(const RetransmissionDeadline &a, const RetransmissionDeadline &b) const
+    {
+        return (int32_t)(a.nextTxMsec - b.nextTxMsec) > 0;
+    }
+};
+
 /*
   Router for direct messages, which only relays if it is the next hop for a packet. The next hop is set by the current
   relayer of a packet, which bases this on information from a previous successful delivery to the destination via flooding.
@@ -97,6 +123,16 @@ class NextHopRouter : public FloodingRouter
      */
     std::unordered_map<GlobalPacketId, PendingPacket, GlobalPacketIdHashFunction> pending;
 
+    /**
+     * Deadlines of the pending retransmissions, earliest first, so doRetransmissions() only visits packets that are due
+     */
+    std::priority_queue<RetransmissionDeadline, std::vector<RetransmissionDeadline>, RetransmissionDeadlineLater> retxQueue;
+
+    /// Added to every PendingPacket::nextTxMsec, see delayRetransmissions()
+    uint32_t retxDelayMsec = 0;
+
+    uint32_t nextRetxSeq = 0;
+
     /**
      * Should this incoming filter be dropped?
      *
@@ -138,6 +174,21 @@ class NextHopRouter : public FloodingRouter
 
     void setNextTx(PendingPacket *pending);
 
+    /**
+     * Push back all pending retransmissions by msec (e.g. for the airtime of a packet during which we couldn't have heard an
+     * ACK), except the retransmission of 'except' if given.  O(1) for the common case, regardless of how much is pending.
+     */
+    void delayRetransmissions(uint32_t msec, const meshtastic_MeshPacket *except = NULL);
+
+    /**
+     * Take the earliest retransmission that is due at 'now' off retxQueue, dropping stale entries on the way.
+     * @return false if nothing is due yet, waitMsec then holds the msecs until something is (INT32_MAX if nothing is pending)
+     */
+    bool popDueRetransmission(uint32_t now, RetransmissionDeadline &due, int32_t &waitMsec);
+
+    /// Add the current deadline of this pending packet to retxQueue, superseding any previous entry for it
+    void scheduleRetransmission(PendingPacket *pending);
+
   private:
     /**
      * Get the next hop for a destination, given the relay node
@@ -524,6 +524,7 @@ void NodeDB::installDefaultNodeDatabase()
     nodeDatabase.nodes = std::vector<meshtastic_NodeInfoLite>(MAX_NUM_NODES);
     numMeshNodes = 0;
     meshNodes = &nodeDatabase.nodes;
+    dropPositionIndex();
 }
 
 void NodeDB::installDefaultConfig(bool preserveKey = false)
@@ -987,6 +988,7 @@ void NodeDB::resetNodes()
         clearLocalPosition();
     numMeshNodes = 1;
     std::fill(nodeDatabase.nodes.begin() + 1, nodeDatabase.nodes.end(), meshtastic_NodeInfoLite());
+    dropPositionIndex();
     devicestate.has_rx_text_message = false;
     devicestate.has_rx_waypoint = false;
     saveNodeDatabaseToDisk();
@@ -1007,6 +1009,7 @@ void NodeDB::removeNodeByNum(NodeNum nodeNum)
     numMeshNodes -= removed;
     std::fill(nodeDatabase.nodes.begin() + numMeshNodes, nodeDatabase.nodes.begin() + numMeshNodes + 1,
               meshtastic_NodeInfoLite());
+    unindexPosition(nodeNum);
     LOG_DEBUG("NodeDB::removeNodeByNum purged %d entries. Save changes", removed);
     saveNodeDatabaseToDisk();
 }
@@ -1018,6 +1021,7 @@ void NodeDB::clearLocalPosition()
     node->position.longitude_i = 0;
     node->position.altitude = 0;
     node->position.time = 0;
+    unindexPosition(node->num);
     setLocalPosition(meshtastic_Position_init_default);
 }
 
@@ -1042,6 +1046,8 @@ void NodeDB::cleanupMeshDB()
     numMeshNodes -= removed;
     std::fill(nodeDatabase.nodes.begin() + numMeshNodes, nodeDatabase.nodes.begin() + numMeshNodes + removed,
               meshtastic_NodeInfoLite());
+    if (removed)
+        dropPositionIndex();
     LOG_DEBUG("cleanupMeshDB purged %d entries", removed);
 }
 
@@ -1191,6 +1197,7 @@ void NodeDB::loadFromDisk()
         numMeshNodes = MAX_NUM_NODES;
     }
     meshNodes->resize(MAX_NUM_NODES);
+    dropPositionIndex();
 
     // static DeviceState scratch; We no longer read into a tempbuf because this structure is 15KB of valuable RAM
     state = loadProto(deviceStateFileName, meshtastic_DeviceState_size, sizeof(meshtastic_DeviceState),
@@ -1569,6 +1576,7 @@ void NodeDB::updatePosition(uint32_t nodeId, const meshtastic_Position &p, RxSou
             info->position.time = tmp_time;
     }
     info->has_position = true;
+    reindexPosition(info);
     updateGUIforNode = info;
     notifyObservers(true); // Force an update whether or not our node counts have changed
 }
@@ -1614,6 +1622,7 @@ void NodeDB::addFromContact(meshtastic_SharedContact contact)
         info->is_ignored = true;
         info->has_device_metrics = false;
         info->has_position = false;
+        unindexPosition(info->num);
         info->user.public_key.size = 0;
         info->user.public_key.bytes[0] = 0;
     } else {
@@ -1722,6 +1731,15 @@ void NodeDB::updateFrom(const meshtastic_MeshPacket &mp)
 
         info->via_mqtt = mp.via_mqtt; // Store if we received this packet via MQTT
 
+        // The originator sets the bitfield, so it tells us what that node can decode (relays pass it through unchanged). Only
+        // NodeInfo carries the capability, the bit isn't reserved for other packets.
+        if (mp.decoded.portnum == meshtastic_PortNum_NODEINFO_APP && mp.decoded.has_bitfield) {
+            if (mp.decoded.bitfield & BITFIELD_CAN_DECOMPRESS_TEXT_MASK)
+                info->bitfield |= NODEINFO_BITFIELD_CAN_DECOMPRESS_TEXT_MASK;
+            else
+                info->bitfield &= ~NODEINFO_BITFIELD_CAN_DECOMPRESS_TEXT_MASK;
+        }
+
         // If hopStart was set and there wasn't someone messing with the limit in the middle, add hopsAway
         if (mp.hop_start != 0 && mp.hop_limit <= mp.hop_start) {
             info->has_hops_away = true;
@@ -1837,6 +1855,7 @@ meshtastic_NodeInfoLite *NodeDB::getOrCreateMeshNode(NodeNum n)
             }
 
             if (oldestIndex != -1) {
+                unindexPosition(meshNodes->at(oldestIndex).num);
                 // Shove the remaining nodes down the chain
                 for (int i = oldestIndex; i < numMeshNodes - 1; i++) {
                     meshNodes->at(i) = meshNodes->at(i + 1);
@@ -1863,6 +1882,38 @@ bool NodeDB::hasValidPosition(const meshtastic_NodeInfoLite *n)
     return n->has_position && (n->position.latitude_i != 0 || n->position.longitude_i != 0);
 }
 
+void NodeDB::reindexPosition(const meshtastic_NodeInfoLite *n)
+{
+    if (!positionIndexBuilt)
+        return;
+    if (hasValidPosition(n))
+        positionIndex.update(n->num, n->position.latitude_i, n->position.longitude_i);
+    else
+        positionIndex.remove(n->num);
+}
+
+void NodeDB::unindexPosition(NodeNum num)
+{
+    if (positionIndexBuilt)
+        positionIndex.remove(num);
+}
+
+void NodeDB::dropPositionIndex()
+{
+    positionIndex.clear();
+    positionIndexBuilt = false;
+}
+
+NodePositionIndex &NodeDB::getPositionIndex()
+{
+    if (!positionIndexBuilt) {
+        positionIndexBuilt = true;
+        for (size_t i = 0; i < numMeshNodes; i++)
+            reindexPosition(&meshNodes->at(i));
+    }
+    return positionIndex;
+}
+
 /// If we have a node / user and they report is_licensed = true
 /// we consider them licensed
 UserLicenseStatus NodeDB::getLicenseStatus(uint32_t nodeNum)
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "MeshTypes.h"
+#include "NodePositionIndex.h"
 #include "NodeStatus.h"
 #include "configuration.h"
 #include "mesh-pb-constants.h"
@@ -279,6 +280,22 @@ class NodeDB
 
     bool hasValidPosition(const meshtastic_NodeInfoLite *n);
 
+    /// Nodes with a valid position within radius of a point, nearest first
+    std::vector<NodePositionIndex::Match> getNodesWithin(int32_t latitude_i, int32_t longitude_i, float meters,
+                                                         size_t maxResults = SIZE_MAX)
+    {
+        return getPositionIndex().withinRadius(latitude_i, longitude_i, meters, maxResults);
+    }
+
+    /// The closest nodes with a valid position to a point, nearest first
+    std::vector<NodePositionIndex::Match> getNearestNodes(int32_t latitude_i, int32_t longitude_i, size_t count)
+    {
+        return getPositionIndex().nearest(latitude_i, longitude_i, count);
+    }
+
+    /// Call after changing a node's position directly, instead of through updatePosition
+    void reindexPosition(const meshtastic_NodeInfoLite *n);
+
     bool checkLowEntropyPublicKey(const meshtastic_Config_SecurityConfig_public_key_t &keyToTest);
 
     bool backupPreferences(meshtastic_AdminMessage_BackupLocation location);
@@ -327,6 +344,14 @@ class NodeDB
     bool saveDeviceStateToDisk();
     bool saveNodeDatabaseToDisk();
     void sortMeshDB();
+
+    /// Index of node positions, for distance queries. Only built once something asks for one, until then nodes without a
+    /// distance query don't pay for keeping it up to date.
+    NodePositionIndex positionIndex;
+    bool positionIndexBuilt = false;
+    NodePositionIndex &getPositionIndex();
+    void unindexPosition(NodeNum num);
+    void dropPositionIndex();
 };
 
 extern NodeDB *nodeDB;
@@ -363,6 +388,9 @@ extern meshtastic_CriticalErrorCode error_code;
 extern uint32_t error_address;
 #define NODEINFO_BITFIELD_IS_KEY_MANUALLY_VERIFIED_SHIFT 0
 #define NODEINFO_BITFIELD_IS_KEY_MANUALLY_VERIFIED_MASK (1 << NODEINFO_BITFIELD_IS_KEY_MANUALLY_VERIFIED_SHIFT)
+// Last NodeInfo from this node said it understands TEXT_MESSAGE_COMPRESSED_APP
+#define NODEINFO_BITFIELD_CAN_DECOMPRESS_TEXT_SHIFT 1
+#define NODEINFO_BITFIELD_CAN_DECOMPRESS_TEXT_MASK (1 << NODEINFO_BITFIELD_CAN_DECOMPRESS_TEXT_SHIFT)
 
 #define Module_Config_size                                                                                                       \
     (ModuleConfig_CannedMessageConfig_size + ModuleConfig_ExternalNotificationConfig_size + ModuleConfig_MQTTConfig_size +       \
@@ -0,0 +1,181 @@
+#include "NodePositionIndex.h"
+
+#include "gps/GeoCoord.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+// Length of one unit of latitude_i, in meters. Same earth radius as GeoCoord::latLongToMeter
+static constexpr double METERS_PER_UNIT = 6366000 * PI / 180 / 1e7;
+
+static constexpr int64_t MAX_LATITUDE_I = 900000000;
+static constexpr int64_t MAX_LONGITUDE_I = 1800000000;
+
+void NodePositionIndex::update(uint32_t num, int32_t latitude_i, int32_t longitude_i)
+{
+    if (latitude_i == 0 && longitude_i == 0) {
+        remove(num);
+        return;
+    }
+
+    Entry entry = {num, latitude_i, longitude_i};
+
+    auto existing = nodes.find(num);
+    if (existing != nodes.end()) {
+        const Entry &old = existing->second;
+        if (old.latitude_i == latitude_i && old.longitude_i == longitude_i)
+            return;
+
+        // Still in the same cell: just move it
+        if (keyOf(old) == keyOf(entry)) {
+            for (Entry &e : cells[keyOf(entry)]) {
+                if (e.num == num)
+                    e = entry;
+            }
+            existing->second = entry;
+            return;
+        }
+
+        remove(num);
+    }
+
+    cells[keyOf(entry)].push_back(entry);
+    nodes[num] = entry;
+}
+
+void NodePositionIndex::remove(uint32_t num)
+{
+    auto existing = nodes.find(num);
+    if (existing == nodes.end())
+        return;
+
+    auto cell = cells.find(keyOf(existing->second));
+    if (cell != cells.end()) {
+        std::vector<Entry> &entries = cell->second;
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (entries[i].num == num) {
+                entries[i] = entries.back();
+                entries.pop_back();
+                break;
+            }
+        }
+        if (entries.empty())
+            cells.erase(cell);
+    }
+
+    nodes.erase(existing);
+}
+
+void NodePositionIndex::clear()
+{
+    cells.clear();
+    nodes.clear();
+}
+
+// Measure the exact distance to each node of a cell, keeping those within range
+void NodePositionIndex::measureCell(const std::vector<Entry> &cell, int32_t latitude_i, int32_t longitude_i, float meters,
+                                    std::vector<Match> &results) const
+{
+    for (const Entry &e : cell) {
+        float d = GeoCoord::latLongToMeter(latitude_i * 1e-7, longitude_i * 1e-7, e.latitude_i * 1e-7, e.longitude_i * 1e-7);
+        if (d <= meters)
+            results.push_back({e.num, d});
+    }
+}
+
+std::vector<NodePositionIndex::Match> NodePositionIndex::withinRadius(int32_t latitude_i, int32_t longitude_i, float meters,
+                                                                      size_t maxResults) const
+{
+    std::vector<Match> results;
+    if (nodes.empty() || meters < 0)
+        return results;
+
+    // Bounding box of the search circle, with a little margin for rounding
+    int64_t latSpan = (int64_t)(meters * 1.01 / METERS_PER_UNIT) + 1;
+    int64_t latLo = std::max<int64_t>(latitude_i - latSpan, -MAX_LATITUDE_I);
+    int64_t latHi = std::min<int64_t>(latitude_i + latSpan, MAX_LATITUDE_I);
+
+    // Lines of longitude converge toward the poles, so the box widens with the highest latitude it reaches
+    double maxAbsLat = std::max(std::abs(latLo), std::abs(latHi)) * 1e-7;
+    double lonScale = cos(maxAbsLat / DEG_CONVERT);
+    int64_t lonSpan = (lonScale > 0.01) ? (int64_t)(latSpan / lonScale) + 1 : MAX_LONGITUDE_I;
+
+    int32_t latCellLo = cellOf(latLo);
+    int32_t latCellHi = cellOf(latHi);
+
+    // Up to two ranges of longitude cells, when the box crosses the antimeridian
+    int32_t lonCellLo[2], lonCellHi[2];
+    uint8_t lonRanges = 1;
+    if (lonSpan >= MAX_LONGITUDE_I) {
+        lonCellLo[0] = cellOf(-MAX_LONGITUDE_I);
+        lonCellHi[0] = cellOf(MAX_LONGITUDE_I);
+    } else {
+        int64_t lonLo = longitude_i - lonSpan;
+        int64_t lonHi = longitude_i + lonSpan;
+        lonCellLo[0] = cellOf(std::max(lonLo, -MAX_LONGITUDE_I));
+        lonCellHi[0] = cellOf(std::min(lonHi, MAX_LONGITUDE_I));
+        if (lonLo < -MAX_LONGITUDE_I) {
+            lonCellLo[1] = cellOf(lonLo + 2 * MAX_LONGITUDE_I);
+            lonCellHi[1] = cellOf(MAX_LONGITUDE_I);
+            lonRanges = 2;
+        } else if (lonHi > MAX_LONGITUDE_I) {
+            lonCellLo[1] = cellOf(-MAX_LONGITUDE_I);
+            lonCellHi[1] = cellOf(lonHi - 2 * MAX_LONGITUDE_I);
+            lonRanges = 2;
+        }
+
+        // Wrapped range reaches back into the first one: just take the full width
+        if (lonRanges == 2 && lonCellLo[1] <= lonCellHi[0] && lonCellHi[1] >= lonCellLo[0]) {
+            lonCellLo[0] = cellOf(-MAX_LONGITUDE_I);
+            lonCellHi[0] = cellOf(MAX_LONGITUDE_I);
+            lonRanges = 1;
+        }
+    }
+
+    size_t boxCells = 0;
+    for (uint8_t r = 0; r < lonRanges; r++)
+        boxCells += (size_t)(latCellHi - latCellLo + 1) * (lonCellHi[r] - lonCellLo[r] + 1);
+
+    if (boxCells > cells.size()) {
+        // Large radius: fewer lookups to walk the occupied cells, than to probe every cell in the box
+        for (const auto &cell : cells)
+            measureCell(cell.second, latitude_i, longitude_i, meters, results);
+    } else {
+        for (uint8_t r = 0; r < lonRanges; r++) {
+            for (int32_t latCell = latCellLo; latCell <= latCellHi; latCell++) {
+                for (int32_t lonCell = lonCellLo[r]; lonCell <= lonCellHi[r]; lonCell++) {
+                    auto cell = cells.find(keyOf(latCell, lonCell));
+                    if (cell != cells.end())
+                        measureCell(cell->second, latitude_i, longitude_i, meters, results);
+                }
+            }
+        }
+    }
+
+    auto nearer = [](const Match &a, const Match &b) { return a.meters < b.meters; };
+    if (results.size() > maxResults) {
+        std::partial_sort(results.begin(), results.begin() + maxResults, results.end(), nearer);
+        results.resize(maxResults);
+    } else {
+        std::sort(results.begin(), results.end(), nearer);
+    }
+    return results;
+}
+
+std::vector<NodePositionIndex::Match> NodePositionIndex::nearest(int32_t latitude_i, int32_t longitude_i, size_t count) const
+{
+    // Widen the search until it holds enough nodes. Everything inside the radius has been measured,
+    // so once there are count matches, no node outside the radius can be closer than them.
+    const float halfCircumference = 6366000 * PI;
+    float radius = 50000;
+    while (true) {
+        if (radius >= halfCircumference)
+            return withinRadius(latitude_i, longitude_i, halfCircumference, count);
+
+        std::vector<Match> results = withinRadius(latitude_i, longitude_i, radius, count);
+        if (results.size() >= count || results.size() == nodes.size())
+            return results;
+
+        radius *= 4;
+    }
+}
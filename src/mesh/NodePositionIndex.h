@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Grid index over node positions, for "which nodes are near here" queries
+ *
+ * Positions are bucketed into cells of 2^22 units of latitude_i / longitude_i (about 0.42 degrees, or 46 km north-south).
+ * A query only measures the nodes in the cells which overlap its bounding box, instead of every node in the NodeDB.
+ * NodeDB builds it on the first query, then keeps it up to date as positions arrive so later queries don't rebuild it.
+ */
+class NodePositionIndex
+{
+  public:
+    struct Match {
+        uint32_t num; // NodeNum
+        float meters; // Distance from the query point
+    };
+
+    // Add or move a node. A position of 0,0 means "no position", and removes the node.
+    void update(uint32_t num, int32_t latitude_i, int32_t longitude_i);
+    void remove(uint32_t num);
+    void clear();
+    size_t size() const { return nodes.size(); }
+
+    // Nodes within radius of a point, nearest first
+    std::vector<Match> withinRadius(int32_t latitude_i, int32_t longitude_i, float meters, size_t maxResults = SIZE_MAX) const;
+
+    // The closest nodes to a point, nearest first
+    std::vector<Match> nearest(int32_t latitude_i, int32_t longitude_i, size_t count) const;
+
+  private:
+    struct Entry {
+        uint32_t num;
+        int32_t latitude_i;
+        int32_t longitude_i;
+    };
+
+    static constexpr uint8_t CELL_SHIFT = 22;
+
+    static int32_t cellOf(int64_t coordinate) { return (int32_t)(coordinate >> CELL_SHIFT); }
+    static uint32_t keyOf(int32_t latCell, int32_t lonCell) { return ((uint32_t)(uint16_t)latCell << 16) | (uint16_t)lonCell; }
+    static uint32_t keyOf(const Entry &e) { return keyOf(cellOf(e.latitude_i), cellOf(e.longitude_i)); }
+
+    void measureCell(const std::vector<Entry> &cell, int32_t latitude_i, int32_t longitude_i, float meters,
+                     std::vector<Match> &results) const;
+
+    std::unordered_map<uint32_t, std::vector<Entry>> cells; // Cell key -> nodes positioned inside it
+    std::unordered_map<uint32_t, Entry> nodes;              // NodeNum -> indexed position, to find a node's cell again
+};
@@ -30,6 +30,7 @@
 #endif
 #include "Throttle.h"
 #include <RTC.h>
+#include <pb_encode.h>
 
 PhoneAPI::PhoneAPI()
 {
@@ -88,7 +89,8 @@ void PhoneAPI::close()
         releaseMqttClientProxyPhonePacket();
         releaseClientNotification();
         onConnectionChanged(false);
-        fromRadioScratch = {};
+        fromRadioSource = {};
+        afterFromRadio = nullptr;
         toRadioScratch = {};
         nodeInfoForPhone = {};
         packetForPhone = NULL;
@@ -188,11 +190,39 @@ bool PhoneAPI::handleToRadio(const uint8_t *buf, size_t bufLength)
 
 size_t PhoneAPI::getFromRadio(uint8_t *buf)
 {
-    if (!available()) {
+    if (!prepareFromRadio())
         return 0;
+
+    // Encapsulate as a FromRadio packet
+    size_t numbytes = encodeFromRadio(buf);
+    // The source may be a pooled packet or a one-shot buffer, only let it go once it has been serialized
+    if (afterFromRadio)
+        (this->*afterFromRadio)();
+
+    // VERY IMPORTANT to not print debug messages while writing to buf - because StreamAPI uses the same buffer for
+    // logging (when we are encapsulating with protobufs)
+    return numbytes;
+}
+
+bool PhoneAPI::getFromRadio(meshtastic_FromRadio &out)
+{
+    if (!prepareFromRadio())
+        return false;
+
+    copyFromRadio(out);
+    if (afterFromRadio)
+        (this->*afterFromRadio)();
+    return true;
+}
+
+bool PhoneAPI::prepareFromRadio()
+{
+    if (!available()) {
+        return false;
     }
     // In case we send a FromRadio packet
-    memset(&fromRadioScratch, 0, sizeof(fromRadioScratch));
+    fromRadioSource = {};
+    afterFromRadio = nullptr;
 
     // Advance states as needed
     switch (state) {
@@ -203,9 +233,8 @@ size_t PhoneAPI::getFromRadio(uint8_t *buf)
         LOG_DEBUG("FromRadio=STATE_SEND_MY_INFO");
         // If the user has specified they don't want our node to share its location, make sure to tell the phone
         // app not to send locations on our behalf.
-        fromRadioScratch.which_payload_variant = meshtastic_FromRadio_my_info_tag;
         strncpy(myNodeInfo.pio_env, optstr(APP_ENV), sizeof(myNodeInfo.pio_env));
-        fromRadioScratch.my_info = myNodeInfo;
+        setFromRadio(meshtastic_FromRadio_my_info_tag, meshtastic_MyNodeInfo_fields, &myNodeInfo);
         state = STATE_SEND_UIDATA;
 
         service->refreshLocalMeshNode(); // Update my NodeInfo because the client will be asking for it soon.
@@ -213,8 +242,7 @@ size_t PhoneAPI::getFromRadio(uint8_t *buf)
 
     case STATE_SEND_UIDATA:
         LOG_INFO("getFromRadio=STATE_SEND_UIDATA");
-        fromRadioScratch.which_payload_variant = meshtastic_FromRadio_deviceuiConfig_tag;
-        fromRadioScratch.deviceuiConfig = uiconfig;
+        setFromRadio(meshtastic_FromRadio_deviceuiConfig_tag, meshtastic_DeviceUIConfig_fields, &uiconfig);
         state = STATE_SEND_OWN_NODEINFO;
         break;
 
@@ -225,10 +253,9 @@ size_t PhoneAPI::getFromRadio(uint8_t *buf)
             nodeInfoForPhone = TypeConversions::ConvertToNodeInfo(us);
             nodeInfoForPhone.has_hops_away = false;
             nodeInfoForPhone.is_favorite = true;
-            fromRadioScratch.which_payload_variant = meshtastic_FromRadio_node_info_tag;
-            fromRadioScratch.node_info = nodeInfoForPhone;
+            setFromRadio(meshtastic_FromRadio_node_info_tag, meshtastic_NodeInfo_fields, &nodeInfoForPhone);
             // Should allow us to resume sending NodeInfo in STATE_SEND_OTHER_NODEINFOS
-            nodeInfoForPhone.num = 0;
+            afterFromRadio = &PhoneAPI::consumeNodeInfoForPhone;
         }
         if (config_nonce == SPECIAL_NONCE_ONLY_NODES) {
             // If client only wants node info, jump directly to sending nodes
@@ -241,14 +268,13 @@ size_t PhoneAPI::getFromRadio(uint8_t *buf)
 
     case STATE_SEND_METADATA:
         LOG_DEBUG("Send device metadata");
-        fromRadioScratch.which_payload_variant = meshtastic_FromRadio_metadata_tag;
-        fromRadioScratch.metadata = getDeviceMetadata();
+        metadataForPhone = getDeviceMetadata();
+        setFromRadio(meshtastic_FromRadio_metadata_tag, meshtastic_DeviceMetadata_fields, &metadataForPhone);
         state = STATE_SEND_CHANNELS;
         break;
 
     case STATE_SEND_CHANNELS:
-        fromRadioScratch.which_payload_variant = meshtastic_FromRadio_channel_tag;
-        fromRadioScratch.channel = channels.getByIndex(config_state);
+        setFromRadio(meshtastic_FromRadio_channel_tag, meshtastic_Channel_fields, &channels.getByIndex(config_state));
         config_state++;
         // Advance when we have sent all of our Channels
         if (config_state >= MAX_NUM_CHANNELS) {
@@ -259,58 +285,51 @@ size_t PhoneAPI::getFromRadio(uint8_t *buf)
         break;
 
     case STATE_SEND_CONFIG:
-        fromRadioScratch.which_payload_variant = meshtastic_FromRadio_config_tag;
         switch (config_state) {
         case meshtastic_Config_device_tag:
             LOG_DEBUG("Send config: device");
-            fromRadioScratch.config.which_payload_variant = meshtastic_Config_device_tag;
-            fromRadioScratch.config.payload_variant.device = config.device;
+            setFromRadioConfig(meshtastic_Config_device_tag, meshtastic_Config_DeviceConfig_fields, &config.device);
             break;
         case meshtastic_Config_position_tag:
             LOG_DEBUG("Send config: position");
-            fromRadioScratch.config.which_payload_variant = meshtastic_Config_position_tag;
-            fromRadioScratch.config.payload_variant.position = config.position;
+            setFromRadioConfig(meshtastic_Config_position_tag, meshtastic_Config_PositionConfig_fields, &config.position);
             break;
         case meshtastic_Config_power_tag:
             LOG_DEBUG("Send config: power");
-            fromRadioScratch.config.which_payload_variant = meshtastic_Config_power_tag;
-            fromRadioScratch.config.payload_variant.power = config.power;
-            fromRadioScratch.config.payload_variant.power.ls_secs = default_ls_secs;
+            powerForPhone = config.power;
+            powerForPhone.ls_secs = default_ls_secs;
+            setFromRadioConfig(meshtastic_Config_power_tag, meshtastic_Config_PowerConfig_fields, &powerForPhone);
             break;
         case meshtastic_Config_network_tag:
             LOG_DEBUG("Send config: network");
-            fromRadioScratch.config.which_payload_variant = meshtastic_Config_network_tag;
-            fromRadioScratch.config.payload_variant.network = config.network;
+            setFromRadioConfig(meshtastic_Config_network_tag, meshtastic_Config_NetworkConfig_fields, &config.network);
             break;
         case meshtastic_Config_display_tag:
             LOG_DEBUG("Send config: display");
-            fromRadioScratch.config.which_payload_variant = meshtastic_Config_display_tag;
-            fromRadioScratch.config.payload_variant.display = config.display;
+            setFromRadioConfig(meshtastic_Config_display_tag, meshtastic_Config_DisplayConfig_fields, &config.display);
             break;
         case meshtastic_Config_lora_tag:
             LOG_DEBUG("Send config: lora");
-            fromRadioScratch.config.which_payload_variant = meshtastic_Config_lora_tag;
-            fromRadioScratch.config.payload_variant.lora = config.lora;
+            setFromRadioConfig(meshtastic_Config_lora_tag, meshtastic_Config_LoRaConfig_fields, &config.lora);
             break;
         case meshtastic_Config_bluetooth_tag:
             LOG_DEBUG("Send config: bluetooth");
-            fromRadioScratch.config.which_payload_variant = meshtastic_Config_bluetooth_tag;
-            fromRadioScratch.config.payload_variant.bluetooth = config.bluetooth;
+            setFromRadioConfig(meshtastic_Config_bluetooth_tag, meshtastic_Config_BluetoothConfig_fields, &config.bluetooth);
             break;
         case meshtastic_Config_security_tag:
             LOG_DEBUG("Send config: security");
-            fromRadioScratch.config.which_payload_variant = meshtastic_Config_security_tag;
-            fromRadioScratch.config.payload_variant.security = config.security;
+            setFromRadioConfig(meshtastic_Config_security_tag, meshtastic_Config_SecurityConfig_fields, &config.security);
             break;
         case meshtastic_Config_sessionkey_tag:
             LOG_DEBUG("Send config: sessionkey");
-            fromRadioScratch.config.which_payload_variant = meshtastic_Config_sessionkey_tag;
+            setFromRadioConfig(meshtastic_Config_sessionkey_tag, meshtastic_Config_SessionkeyConfig_fields, nullptr);
             break;
         case meshtastic_Config_device_ui_tag: // NOOP!
-            fromRadioScratch.config.which_payload_variant = meshtastic_Config_device_ui_tag;
+            setFromRadioConfig(meshtastic_Config_device_ui_tag, meshtastic_DeviceUIConfig_fields, nullptr);
             break;
         default:
             LOG_ERROR("Unknown config type %d", config_state);
+            setFromRadio(meshtastic_FromRadio_config_tag, meshtastic_Config_fields, nullptr);
         }
         // NOTE: The phone app needs to know the ls_secs value so it can properly expect sleep behavior.
         // So even if we internally use 0 to represent 'use default' we still need to send the value we are
@@ -325,75 +344,76 @@ size_t PhoneAPI::getFromRadio(uint8_t *buf)
         break;
 
     case STATE_SEND_MODULECONFIG:
-        fromRadioScratch.which_payload_variant = meshtastic_FromRadio_moduleConfig_tag;
         switch (config_state) {
         case meshtastic_ModuleConfig_mqtt_tag:
             LOG_DEBUG("Send module config: mqtt");
-            fromRadioScratch.moduleConfig.which_payload_variant = meshtastic_ModuleConfig_mqtt_tag;
-            fromRadioScratch.moduleConfig.payload_variant.mqtt = moduleConfig.mqtt;
+            setFromRadioModuleConfig(meshtastic_ModuleConfig_mqtt_tag, meshtastic_ModuleConfig_MQTTConfig_fields,
+                                     &moduleConfig.mqtt);
             break;
         case meshtastic_ModuleConfig_serial_tag:
             LOG_DEBUG("Send module config: serial");
-            fromRadioScratch.moduleConfig.which_payload_variant = meshtastic_ModuleConfig_serial_tag;
-            fromRadioScratch.moduleConfig.payload_variant.serial = moduleConfig.serial;
+            setFromRadioModuleConfig(meshtastic_ModuleConfig_serial_tag, meshtastic_ModuleConfig_SerialConfig_fields,
+                                     &moduleConfig.serial);
             break;
         case meshtastic_ModuleConfig_external_notification_tag:
             LOG_DEBUG("Send module config: ext notification");
-            fromRadioScratch.moduleConfig.which_payload_variant = meshtastic_ModuleConfig_external_notification_tag;
-            fromRadioScratch.moduleConfig.payload_variant.external_notification = moduleConfig.external_notification;
+            setFromRadioModuleConfig(meshtastic_ModuleConfig_external_notification_tag,
+                                     meshtastic_ModuleConfig_ExternalNotificationConfig_fields,
+                                     &moduleConfig.external_notification);
             break;
         case meshtastic_ModuleConfig_store_forward_tag:
             LOG_DEBUG("Send module config: store forward");
-            fromRadioScratch.moduleConfig.which_payload_variant = meshtastic_ModuleConfig_store_forward_tag;
-            fromRadioScratch.moduleConfig.payload_variant.store_forward = moduleConfig.store_forward;
+            setFromRadioModuleConfig(meshtastic_ModuleConfig_store_forward_tag, meshtastic_ModuleConfig_StoreForwardConfig_fields,
+                                     &moduleConfig.store_forward);
             break;
         case meshtastic_ModuleConfig_range_test_tag:
             LOG_DEBUG("Send module config: range test");
-            fromRadioScratch.moduleConfig.which_payload_variant = meshtastic_ModuleConfig_range_test_tag;
-            fromRadioScratch.moduleConfig.payload_variant.range_test = moduleConfig.range_test;
+            setFromRadioModuleConfig(meshtastic_ModuleConfig_range_test_tag, meshtastic_ModuleConfig_RangeTestConfig_fields,
+                                     &moduleConfig.range_test);
             break;
         case meshtastic_ModuleConfig_telemetry_tag:
             LOG_DEBUG("Send module config: telemetry");
-            fromRadioScratch.moduleConfig.which_payload_variant = meshtastic_ModuleConfig_telemetry_tag;
-            fromRadioScratch.moduleConfig.payload_variant.telemetry = moduleConfig.telemetry;
+            setFromRadioModuleConfig(meshtastic_ModuleConfig_telemetry_tag, meshtastic_ModuleConfig_TelemetryConfig_fields,
+                                     &moduleConfig.telemetry);
             break;
         case meshtastic_ModuleConfig_canned_message_tag:
             LOG_DEBUG("Send module config: canned message");
-            fromRadioScratch.moduleConfig.which_payload_variant = meshtastic_ModuleConfig_canned_message_tag;
-            fromRadioScratch.moduleConfig.payload_variant.canned_message = moduleConfig.canned_message;
+            setFromRadioModuleConfig(meshtastic_ModuleConfig_canned_message_tag,
+                                     meshtastic_ModuleConfig_CannedMessageConfig_fields, &moduleConfig.canned_message);
             break;
         case meshtastic_ModuleConfig_audio_tag:
             LOG_DEBUG("Send module config: audio");
-            fromRadioScratch.moduleConfig.which_payload_variant = meshtastic_ModuleConfig_audio_tag;
-            fromRadioScratch.moduleConfig.payload_variant.audio = moduleConfig.audio;
+            setFromRadioModuleConfig(meshtastic_ModuleConfig_audio_tag, meshtastic_ModuleConfig_AudioConfig_fields,
+                                     &moduleConfig.audio);
             break;
         case meshtastic_ModuleConfig_remote_hardware_tag:
             LOG_DEBUG("Send module config: remote hardware");
-            fromRadioScratch.moduleConfig.which_payload_variant = meshtastic_ModuleConfig_remote_hardware_tag;
-            fromRadioScratch.moduleConfig.payload_variant.remote_hardware = moduleConfig.remote_hardware;
+            setFromRadioModuleConfig(meshtastic_ModuleConfig_remote_hardware_tag,
+                                     meshtastic_ModuleConfig_RemoteHardwareConfig_fields, &moduleConfig.remote_hardware);
             break;
         case meshtastic_ModuleConfig_neighbor_info_tag:
             LOG_DEBUG("Send module config: neighbor info");
-            fromRadioScratch.moduleConfig.which_payload_variant = meshtastic_ModuleConfig_neighbor_info_tag;
-            fromRadioScratch.moduleConfig.payload_variant.neighbor_info = moduleConfig.neighbor_info;
+            setFromRadioModuleConfig(meshtastic_ModuleConfig_neighbor_info_tag, meshtastic_ModuleConfig_NeighborInfoConfig_fields,
+                                     &moduleConfig.neighbor_info);
             break;
         case meshtastic_ModuleConfig_detection_sensor_tag:
             LOG_DEBUG("Send module config: detection sensor");
-            fromRadioScratch.moduleConfig.which_payload_variant = meshtastic_ModuleConfig_detection_sensor_tag;
-            fromRadioScratch.moduleConfig.payload_variant.detection_sensor = moduleConfig.detection_sensor;
+            setFromRadioModuleConfig(meshtastic_ModuleConfig_detection_sensor_tag,
+                                     meshtastic_ModuleConfig_DetectionSensorConfig_fields, &moduleConfig.detection_sensor);
             break;
         case meshtastic_ModuleConfig_ambient_lighting_tag:
             LOG_DEBUG("Send module config: ambient lighting");
-            fromRadioScratch.moduleConfig.which_payload_variant = meshtastic_ModuleConfig_ambient_lighting_tag;
-            fromRadioScratch.moduleConfig.payload_variant.ambient_lighting = moduleConfig.ambient_lighting;
+            setFromRadioModuleConfig(meshtastic_ModuleConfig_ambient_lighting_tag,
+                                     meshtastic_ModuleConfig_AmbientLightingConfig_fields, &moduleConfig.ambient_lighting);
             break;
         case meshtastic_ModuleConfig_paxcounter_tag:
             LOG_DEBUG("Send module config: paxcounter");
-            fromRadioScratch.moduleConfig.which_payload_variant = meshtastic_ModuleConfig_paxcounter_tag;
-            fromRadioScratch.moduleConfig.payload_variant.paxcounter = moduleConfig.paxcounter;
+            setFromRadioModuleConfig(meshtastic_ModuleConfig_paxcounter_tag, meshtastic_ModuleConfig_PaxcounterConfig_fields,
+                                     &moduleConfig.paxcounter);
             break;
         default:
             LOG_ERROR("Unknown module config type %d", config_state);
+            setFromRadio(meshtastic_FromRadio_moduleConfig_tag, meshtastic_ModuleConfig_fields, nullptr);
         }
 
         config_state++;
@@ -416,15 +436,14 @@ size_t PhoneAPI::getFromRadio(uint8_t *buf)
         if (nodeInfoForPhone.num != 0) {
             LOG_INFO("nodeinfo: num=0x%x, lastseen=%u, id=%s, name=%s", nodeInfoForPhone.num, nodeInfoForPhone.last_heard,
                      nodeInfoForPhone.user.id, nodeInfoForPhone.user.long_name);
-            fromRadioScratch.which_payload_variant = meshtastic_FromRadio_node_info_tag;
-            fromRadioScratch.node_info = nodeInfoForPhone;
+            setFromRadio(meshtastic_FromRadio_node_info_tag, meshtastic_NodeInfo_fields, &nodeInfoForPhone);
             // Stay in current state until done sending nodeinfos
-            nodeInfoForPhone.num = 0; // We just consumed a nodeinfo, will need a new one next time
+            afterFromRadio = &PhoneAPI::consumeNodeInfoForPhone; // We just consumed a nodeinfo, will need a new one next time
         } else {
             LOG_DEBUG("Done sending nodeinfo");
             state = STATE_SEND_FILEMANIFEST;
             // Go ahead and send that ID right now
-            return getFromRadio(buf);
+            return prepareFromRadio();
         }
         break;
     }
@@ -439,9 +458,9 @@ size_t PhoneAPI::getFromRadio(uint8_t *buf)
             // Skip to complete packet
             sendConfigComplete();
         } else {
-            fromRadioScratch.which_payload_variant = meshtastic_FromRadio_fileInfo_tag;
-            fromRadioScratch.fileInfo = filesManifest.at(config_state);
-            LOG_DEBUG("File: %s (%d) bytes", fromRadioScratch.fileInfo.file_name, fromRadioScratch.fileInfo.size_bytes);
+            const meshtastic_FileInfo &fileInfo = filesManifest.at(config_state);
+            setFromRadio(meshtastic_FromRadio_fileInfo_tag, meshtastic_FileInfo_fields, &fileInfo);
+            LOG_DEBUG("File: %s (%d) bytes", fileInfo.file_name, fileInfo.size_bytes);
             config_state++;
         }
         break;
@@ -456,28 +475,24 @@ size_t PhoneAPI::getFromRadio(uint8_t *buf)
         // Do we have a message from the mesh or packet from the local device?
         LOG_DEBUG("FromRadio=STATE_SEND_PACKETS");
         if (queueStatusPacketForPhone) {
-            fromRadioScratch.which_payload_variant = meshtastic_FromRadio_queueStatus_tag;
-            fromRadioScratch.queueStatus = *queueStatusPacketForPhone;
-            releaseQueueStatusPhonePacket();
+            setFromRadio(meshtastic_FromRadio_queueStatus_tag, meshtastic_QueueStatus_fields, queueStatusPacketForPhone);
+            afterFromRadio = &PhoneAPI::releaseQueueStatusPhonePacket;
         } else if (mqttClientProxyMessageForPhone) {
-            fromRadioScratch.which_payload_variant = meshtastic_FromRadio_mqttClientProxyMessage_tag;
-            fromRadioScratch.mqttClientProxyMessage = *mqttClientProxyMessageForPhone;
-            releaseMqttClientProxyPhonePacket();
+            setFromRadio(meshtastic_FromRadio_mqttClientProxyMessage_tag, meshtastic_MqttClientProxyMessage_fields,
+                         mqttClientProxyMessageForPhone);
+            afterFromRadio = &PhoneAPI::releaseMqttClientProxyPhonePacket;
         } else if (xmodemPacketForPhone.control != meshtastic_XModem_Control_NUL) {
-            fromRadioScratch.which_payload_variant = meshtastic_FromRadio_xmodemPacket_tag;
-            fromRadioScratch.xmodemPacket = xmodemPacketForPhone;
-            xmodemPacketForPhone = meshtastic_XModem_init_zero;
+            setFromRadio(meshtastic_FromRadio_xmodemPacket_tag, meshtastic_XModem_fields, &xmodemPacketForPhone);
+            afterFromRadio = &PhoneAPI::clearXmodemPacketForPhone;
         } else if (clientNotification) {
-            fromRadioScratch.which_payload_variant = meshtastic_FromRadio_clientNotification_tag;
-            fromRadioScratch.clientNotification = *clientNotification;
-            releaseClientNotification();
+            setFromRadio(meshtastic_FromRadio_clientNotification_tag, meshtastic_ClientNotification_fields, clientNotification);
+            afterFromRadio = &PhoneAPI::releaseClientNotification;
         } else if (packetForPhone) {
             printPacket("phone downloaded packet", packetForPhone);
 
             // Encapsulate as a FromRadio packet
-            fromRadioScratch.which_payload_variant = meshtastic_FromRadio_packet_tag;
-            fromRadioScratch.packet = *packetForPhone;
-            releasePhonePacket();
+            setFromRadio(meshtastic_FromRadio_packet_tag, meshtastic_MeshPacket_fields, packetForPhone);
+            afterFromRadio = &PhoneAPI::releasePhonePacket;
         }
         break;
 
@@ -486,24 +501,88 @@ size_t PhoneAPI::getFromRadio(uint8_t *buf)
     }
 
     // Do we have a message from the mesh?
-    if (fromRadioScratch.which_payload_variant != 0) {
-        // Encapsulate as a FromRadio packet
-        size_t numbytes = pb_encode_to_bytes(buf, meshtastic_FromRadio_size, &meshtastic_FromRadio_msg, &fromRadioScratch);
+    if (fromRadioSource.tag != 0)
+        return true;
+
+    LOG_DEBUG("No FromRadio packet available");
+    return false;
+}
 
-        // VERY IMPORTANT to not print debug messages while writing to fromRadioScratch - because we use that same buffer
-        // for logging (when we are encapsulating with protobufs)
-        return numbytes;
+void PhoneAPI::setFromRadio(pb_size_t tag, const pb_msgdesc_t *fields, std::nullptr_t, pb_size_t innerTag)
+{
+    fromRadioSource = {};
+    fromRadioSource.tag = tag;
+    fromRadioSource.innerTag = innerTag;
+    fromRadioSource.fields = fields;
+}
+
+/**
+ * Serialize fromRadioSource into buf.
+ *
+ * A oneof submessage is just its tag and length in front of the encoded message, so we write that header ourselves and let
+ * nanopb encode straight from the source object. This saves copying it into the (large) FromRadio union first. The bytes are
+ * the same as encoding a filled in meshtastic_FromRadio, which leaves id unset.
+ */
+size_t PhoneAPI::encodeFromRadio(uint8_t *buf)
+{
+    const FromRadioSource &s = fromRadioSource;
+    pb_ostream_t stream = pb_ostream_from_buffer(buf, meshtastic_FromRadio_size);
+    bool ok;
+    if (!s.fields) {
+        ok = pb_encode_tag(&stream, PB_WT_VARINT, s.tag) && pb_encode_varint(&stream, s.value);
+    } else {
+        size_t len = 0;
+        ok = !s.src || pb_get_encoded_size(&len, s.fields, s.src);
+        if (ok && s.innerTag) {
+            // Config and ModuleConfig: one more level of oneof around the actual settings
+            pb_ostream_t sizing = PB_OSTREAM_SIZING;
+            pb_encode_tag(&sizing, PB_WT_STRING, s.innerTag);
+            pb_encode_varint(&sizing, len);
+            ok = pb_encode_tag(&stream, PB_WT_STRING, s.tag) && pb_encode_varint(&stream, sizing.bytes_written + len) &&
+                 pb_encode_tag(&stream, PB_WT_STRING, s.innerTag) && pb_encode_varint(&stream, len);
+        } else if (ok) {
+            ok = pb_encode_tag(&stream, PB_WT_STRING, s.tag) && pb_encode_varint(&stream, len);
+        }
+        ok = ok && (!s.src || pb_encode(&stream, s.fields, s.src));
     }
+    if (!ok) {
+        LOG_ERROR("Panic: can't encode protobuf reason='%s'", PB_GET_ERROR(&stream));
+        return 0;
+    }
+    return stream.bytes_written;
+}
 
-    LOG_DEBUG("No FromRadio packet available");
-    return 0;
+/**
+ * Fill out from fromRadioSource, for transports that pass the structure itself. Every FromRadio payload_variant starts at
+ * the same address, as does every Config and ModuleConfig one, so the source object is copied there as it is.
+ */
+void PhoneAPI::copyFromRadio(meshtastic_FromRadio &out)
+{
+    const FromRadioSource &s = fromRadioSource;
+    memset(&out, 0, sizeof(out));
+    out.which_payload_variant = s.tag;
+    if (!s.fields) {
+        out.config_complete_id = s.value;
+        return;
+    }
+    void *dst = &out.packet;
+    if (s.innerTag && s.tag == meshtastic_FromRadio_config_tag) {
+        out.config.which_payload_variant = s.innerTag;
+        dst = &out.config.payload_variant;
+    } else if (s.innerTag && s.tag == meshtastic_FromRadio_moduleConfig_tag) {
+        out.moduleConfig.which_payload_variant = s.innerTag;
+        dst = &out.moduleConfig.payload_variant;
+    }
+    if (s.src)
+        memcpy(dst, s.src, s.size);
 }
 
 void PhoneAPI::sendConfigComplete()
 {
     LOG_INFO("Config Send Complete");
-    fromRadioScratch.which_payload_variant = meshtastic_FromRadio_config_complete_id_tag;
-    fromRadioScratch.config_complete_id = config_nonce;
+    fromRadioSource = {};
+    fromRadioSource.tag = meshtastic_FromRadio_config_complete_id_tag;
+    fromRadioSource.value = config_nonce;
     config_nonce = 0;
     state = STATE_SEND_PACKETS;
     pauseBluetoothLogging = false;
@@ -3,6 +3,7 @@
 #include "Observer.h"
 #include "mesh-pb-constants.h"
 #include "meshtastic/portnums.pb.h"
+#include <cstddef>
 #include <iterator>
 #include <string>
 #include <unordered_map>
@@ -80,6 +81,10 @@ class PhoneAPI
     /// We temporarily keep the nodeInfo here between the call to available and getFromRadio
     meshtastic_NodeInfo nodeInfoForPhone = meshtastic_NodeInfo_init_default;
 
+    /// The settings we adjust before sending, kept here until getFromRadio() has sent them
+    meshtastic_DeviceMetadata metadataForPhone = meshtastic_DeviceMetadata_init_default;
+    meshtastic_Config_PowerConfig powerForPhone = meshtastic_Config_PowerConfig_init_default;
+
     meshtastic_ToRadio toRadioScratch = {
         0}; // this is a static scratch object, any data must be copied elsewhere before returning
 
@@ -130,9 +135,42 @@ class PhoneAPI
     bool isConnected() { return state != STATE_SEND_NOTHING; }
 
   protected:
-    /// Our fromradio packet while it is being assembled
+    /// If the mesh service tells us fromNum has changed, tell the phone
+    virtual int onNotify(uint32_t newValue) override;
+
+    /// Scratch FromRadio for transports that build their own messages (log records, PacketAPI), getFromRadio() doesn't use it
     meshtastic_FromRadio fromRadioScratch = {};
 
+    /**
+     * Get the next packet we want to send to the phone as a FromRadio structure, for transports that pass the structure
+     * itself rather than its encoding. id is left at 0.
+     * Returns false if no packet is available
+     */
+    bool getFromRadio(meshtastic_FromRadio &out);
+
+    /// Set what getFromRadio() sends next, src must stay valid until then
+    template <typename T> void setFromRadio(pb_size_t tag, const pb_msgdesc_t *fields, const T *src, pb_size_t innerTag = 0)
+    {
+        setFromRadio(tag, fields, nullptr, innerTag);
+        fromRadioSource.src = src;
+        fromRadioSource.size = sizeof(T);
+    }
+    void setFromRadio(pb_size_t tag, const pb_msgdesc_t *fields, std::nullptr_t, pb_size_t innerTag = 0);
+    template <typename T> void setFromRadioConfig(pb_size_t tag, const pb_msgdesc_t *fields, T src)
+    {
+        setFromRadio(meshtastic_FromRadio_config_tag, fields, src, tag);
+    }
+    template <typename T> void setFromRadioModuleConfig(pb_size_t tag, const pb_msgdesc_t *fields, T src)
+    {
+        setFromRadio(meshtastic_FromRadio_moduleConfig_tag, fields, src, tag);
+    }
+
+    /// Serialize what was set into buf
+    size_t encodeFromRadio(uint8_t *buf);
+
+    /// Copy what was set into out, giving the same message encodeFromRadio() writes
+    void copyFromRadio(meshtastic_FromRadio &out);
+
     /** the last msec we heard from the client on the other side of this link */
     uint32_t lastContactMsec = 0;
 
@@ -154,6 +192,27 @@ class PhoneAPI
     void handleStartConfig();
 
   private:
+    /// What getFromRadio() is about to send, pointing at the object itself rather than a copy of it
+    struct FromRadioSource {
+        pb_size_t tag;              // FromRadio payload_variant, 0 if there is nothing to send
+        pb_size_t innerTag;         // Config/ModuleConfig payload_variant when src is one of their settings, otherwise 0
+        const pb_msgdesc_t *fields; // NULL for config_complete_id, the only scalar we send
+        const void *src;            // NULL for an empty message
+        size_t size;                // sizeof(*src), to copy it into a meshtastic_FromRadio
+        uint32_t value;
+    };
+    FromRadioSource fromRadioSource = {};
+
+    /// Called once fromRadioSource has been encoded, to release or reset the object it pointed at
+    void (PhoneAPI::*afterFromRadio)() = nullptr;
+
+    /// Advance the state machine and set fromRadioSource to the next packet for the phone. Returns false if there is none
+    bool prepareFromRadio();
+
+    void consumeNodeInfoForPhone() { nodeInfoForPhone.num = 0; }
+
+    void clearXmodemPacketForPhone() { xmodemPacketForPhone = meshtastic_XModem_init_zero; }
+
     void releasePhonePacket();
 
     void releaseQueueStatusPhonePacket();
@@ -169,7 +228,4 @@ class PhoneAPI
      * @return true true if a packet was queued for sending
      */
     bool handleToRadioPacket(meshtastic_MeshPacket &p);
-
-    /// If the mesh service tells us fromNum has changed, tell the phone
-    virtual int onNotify(uint32_t newValue) override;
 };
@@ -196,6 +196,10 @@ class RadioInterface
     uint32_t getPacketTime(const meshtastic_MeshPacket *p);
     uint32_t getPacketTime(uint32_t totalPacketLen);
 
+    /// The modem settings currently applied, bandwidth in kHz
+    float getBandwidth() const { return bw; }
+    uint8_t getSpreadingFactor() const { return sf; }
+
     /**
      * Get the channel we saved.
      */
@@ -283,7 +283,7 @@ void RadioLibInterface::onNotify(uint32_t notification)
                         if (sent) {
                             // Packet has been sent, count it toward our TX airtime utilization.
                             uint32_t xmitMsec = getPacketTime(txp);
-                            airTime->logAirtime(TX_LOG, xmitMsec);
+                            airTime->logTransmitAirtime(txp->from, txp->id, xmitMsec);
                         }
                         LOG_DEBUG("%d packets remain in the TX queue", txQueue.getMaxLen() - txQueue.getFree());
                     }
@@ -474,6 +474,7 @@ void RadioLibInterface::handleReceiveInterrupt()
             printPacket("Lora RX", mp);
 
             airTime->logAirtime(RX_LOG, xmitMsec);
+            airTime->logSenderAirtime(mp->from, xmitMsec);
 
             deliverToReceiver(mp);
         }
@@ -9,6 +9,7 @@
 #include "detect/LoRaRadioType.h"
 #include "main.h"
 #include "mesh-pb-constants.h"
+#include "mesh/compression/unishox2.h"
 #include "meshUtils.h"
 #include "modules/RoutingModule.h"
 #if !MESHTASTIC_EXCLUDE_MQTT
@@ -21,6 +22,8 @@
 #if ENABLE_JSON_LOGGING || ARCH_PORTDUINO
 #include "serialization/MeshPacketSerializer.h"
 #endif
+#include <algorithm>
+#include <vector>
 
 #define MAX_RX_FROMRADIO                                                                                                         \
     4 // max number of packets destined to our queue, we dispatch packets quickly so it doesn't need to be big
@@ -184,6 +187,8 @@ ErrorCode Router::sendLocal(meshtastic_MeshPacket *p, RxSource src)
         // this allows local apps (and PCs) to see broadcasts sourced locally
         if (isBroadcast(p->to)) {
             handleReceived(p, src);
+            // The phone queue may now share p, and send() is about to modify it
+            p = packetPool.makeWritable(p);
         }
 
         // don't override if a channel was requested and no need to set it when PKI is enforced
@@ -274,22 +279,31 @@ ErrorCode Router::send(meshtastic_MeshPacket *p)
     // If the packet is not yet encrypted, do so now
     if (p->which_payload_variant == meshtastic_MeshPacket_decoded_tag) {
         ChannelIndex chIndex = p->channel; // keep as a local because we are about to change it
-        meshtastic_MeshPacket *p_decoded = packetPool.allocCopy(*p);
+        meshtastic_PortNum portnum = p->decoded.portnum;
+        meshtastic_MeshPacket *p_decoded = NULL;
+#if !MESHTASTIC_EXCLUDE_MQTT
+        // Only publish to MQTT if we're the original transmitter of the packet, which needs the decoded form kept aside
+        if (moduleConfig.mqtt.enabled && isFromUs(p) && mqtt)
+            p_decoded = packetPool.allocCopy(*p);
+#endif
 
         auto encodeResult = perhapsEncode(p);
         if (encodeResult != meshtastic_Routing_Error_NONE) {
-            packetPool.release(p_decoded);
+            if (p_decoded)
+                packetPool.release(p_decoded);
             p->channel = 0; // Reset the channel to 0, so we don't use the failing hash again
             abortSendAndNak(encodeResult, p);
             return encodeResult; // FIXME - this isn't a valid ErrorCode
         }
+        // Charged once the radio actually transmits it, see AirTime::logTransmitAirtime()
+        if (airTime)
+            airTime->rememberPortnum(p->from, p->id, portnum);
 #if !MESHTASTIC_EXCLUDE_MQTT
-        // Only publish to MQTT if we're the original transmitter of the packet
-        if (moduleConfig.mqtt.enabled && isFromUs(p) && mqtt) {
+        if (p_decoded) {
             mqtt->onSend(*p, *p_decoded, chIndex);
+            packetPool.release(p_decoded);
         }
 #endif
-        packetPool.release(p_decoded);
     }
 
 #if HAS_UDP_MULTICAST
@@ -328,35 +342,144 @@ void Router::sniffReceived(const meshtastic_MeshPacket *p, const meshtastic_Rout
     // FIXME, update nodedb here for any packet that passes through us
 }
 
-DecodeState perhapsDecode(meshtastic_MeshPacket *p)
+/// Checks done before any decryption attempt, returns false (with the outcome in result) if we should not try to decrypt
+static bool shouldDecode(meshtastic_MeshPacket *p, DecodeState &result)
 {
-    concurrency::LockGuard g(cryptLock);
-
     if (config.device.role == meshtastic_Config_DeviceConfig_Role_REPEATER &&
-        config.device.rebroadcast_mode == meshtastic_Config_DeviceConfig_RebroadcastMode_ALL_SKIP_DECODING)
-        return DecodeState::DECODE_FAILURE;
+        config.device.rebroadcast_mode == meshtastic_Config_DeviceConfig_RebroadcastMode_ALL_SKIP_DECODING) {
+        result = DecodeState::DECODE_FAILURE;
+        return false;
+    }
 
     if (config.device.rebroadcast_mode == meshtastic_Config_DeviceConfig_RebroadcastMode_KNOWN_ONLY &&
         (nodeDB->getMeshNode(p->from) == NULL || !nodeDB->getMeshNode(p->from)->has_user)) {
         LOG_DEBUG("Node 0x%x not in nodeDB-> Rebroadcast mode KNOWN_ONLY will ignore packet", p->from);
+        result = DecodeState::DECODE_FAILURE;
+        return false;
+    }
+
+    if (p->which_payload_variant == meshtastic_MeshPacket_decoded_tag) {
+        result = DecodeState::DECODE_SUCCESS; // If packet was already decoded just return
+        return false;
+    }
+
+    if (p->encrypted.size > sizeof(bytes)) {
+        LOG_ERROR("Packet too large to attempt decryption! (rawSize=%d > 256)", p->encrypted.size);
+        result = DecodeState::DECODE_FATAL;
+        return false;
+    }
+    return true;
+}
+
+#if !(MESHTASTIC_EXCLUDE_PKI)
+static bool isPkiCandidate(const meshtastic_MeshPacket *p)
+{
+    return p->channel == 0 && isToUs(p) && p->to > 0 && !isBroadcast(p->to) && nodeDB->getMeshNode(p->from) != nullptr &&
+           nodeDB->getMeshNode(p->from)->user.public_key.size > 0 && nodeDB->getMeshNode(p->to)->user.public_key.size > 0 &&
+           p->encrypted.size > MESHTASTIC_PKC_OVERHEAD;
+}
+#endif
+
+/// Decode the protobufs of a channel decrypted payload, on success the packet is switched to decoded
+static bool decodeDecrypted(meshtastic_MeshPacket *p, const uint8_t *plaintext, size_t rawSize)
+{
+    // Take those raw bytes and convert them back into a well structured protobuf we can understand
+    meshtastic_Data decodedtmp;
+    memset(&decodedtmp, 0, sizeof(decodedtmp));
+    if (!pb_decode_from_bytes(plaintext, rawSize, &meshtastic_Data_msg, &decodedtmp)) {
+        LOG_ERROR("Invalid protobufs in received mesh packet id=0x%08x (bad psk?)!", p->id);
+    } else if (decodedtmp.portnum == meshtastic_PortNum_UNKNOWN_APP) {
+        LOG_ERROR("Invalid portnum (bad psk?)!");
+    } else {
+        p->decoded = decodedtmp;
+        p->which_payload_variant = meshtastic_MeshPacket_decoded_tag; // change type to decoded
+        return true;
+    }
+    return false;
+}
+
+/// Try the channels whose hash matches the packet, starting at firstChannel
+static bool decodeWithChannels(meshtastic_MeshPacket *p, ChannelIndex firstChannel, ChannelIndex &chIndex)
+{
+    const size_t rawSize = p->encrypted.size;
+    // Try to find a channel that works with this hash
+    for (chIndex = firstChannel; chIndex < channels.getNumChannels(); chIndex++) {
+        // Try to use this hash/channel pair
+        if (channels.decryptForHash(chIndex, p->channel)) {
+            // we have to copy into a scratch buffer, because these bytes are a union with the decoded protobuf. Create a
+            // fresh copy for each decrypt attempt.
+            memcpy(bytes, p->encrypted.bytes, rawSize);
+            // Try to decrypt the packet if we can
+            crypto->decrypt(p->from, p->id, rawSize, bytes);
+
+            // printBytes("plaintext", bytes, p->encrypted.size);
+
+            if (decodeDecrypted(p, bytes, rawSize))
+                return true;
+        }
+    }
+    return false;
+}
+
+/// Expand a TEXT_MESSAGE_COMPRESSED_APP payload in place. On failure the packet is left as it arrived.
+static void decompressText(meshtastic_MeshPacket *p)
+{
+    // unishox2 may look at the byte after the end of its input, give it a zero one rather than whatever follows the payload
+    char in[sizeof(p->decoded.payload.bytes) + 1] = {0};
+    memcpy(in, p->decoded.payload.bytes, p->decoded.payload.size);
+    char text[sizeof(p->decoded.payload.bytes)];
+    int len = unishox2_decompress(in, p->decoded.payload.size, text, sizeof(text), USX_PSET_DFLT);
+    // unishox2 returns olen + 1 when the output did not fit
+    if (len <= 0 || len > (int)sizeof(text)) {
+        LOG_WARN("Can't decompress text message from 0x%x (%u bytes)", p->from, p->decoded.payload.size);
+        return;
+    }
+    memcpy(p->decoded.payload.bytes, text, len);
+    p->decoded.payload.size = len;
+    p->decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
+}
+
+static DecodeState finishDecode(meshtastic_MeshPacket *p, ChannelIndex chIndex, bool decrypted)
+{
+    if (decrypted) {
+        // parsing was successful
+        p->channel = chIndex; // change to store the index instead of the hash
+        if (p->decoded.has_bitfield)
+            p->decoded.want_response |= p->decoded.bitfield & BITFIELD_WANT_RESPONSE_MASK;
+
+        // Text sent to us compressed is expanded here so modules and the phone only ever see TEXT_MESSAGE_APP. Relays leave it
+        // alone so the packet goes back out at its compressed size.
+        if (p->decoded.portnum == meshtastic_PortNum_TEXT_MESSAGE_COMPRESSED_APP && isToUs(p))
+            decompressText(p);
+
+        printPacket("decoded message", p);
+#if ENABLE_JSON_LOGGING
+        LOG_TRACE("%s", MeshPacketSerializer::JsonSerialize(p, false).c_str());
+#elif ARCH_PORTDUINO
+        if (settingsStrings[traceFilename] != "" || settingsMap[logoutputlevel] == level_trace) {
+            LOG_TRACE("%s", MeshPacketSerializer::JsonSerialize(p, false).c_str());
+        }
+#endif
+        return DecodeState::DECODE_SUCCESS;
+    } else {
+        LOG_WARN("No suitable channel found for decoding, hash was 0x%x!", p->channel);
         return DecodeState::DECODE_FAILURE;
     }
+}
 
-    if (p->which_payload_variant == meshtastic_MeshPacket_decoded_tag)
-        return DecodeState::DECODE_SUCCESS; // If packet was already decoded just return
+/// perhapsDecode() without taking cryptLock
+static DecodeState perhapsDecodeLocked(meshtastic_MeshPacket *p)
+{
+    DecodeState result;
+    if (!shouldDecode(p, result))
+        return result;
 
     size_t rawSize = p->encrypted.size;
-    if (rawSize > sizeof(bytes)) {
-        LOG_ERROR("Packet too large to attempt decryption! (rawSize=%d > 256)", rawSize);
-        return DecodeState::DECODE_FATAL;
-    }
     bool decrypted = false;
     ChannelIndex chIndex = 0;
 #if !(MESHTASTIC_EXCLUDE_PKI)
     // Attempt PKI decryption first
-    if (p->channel == 0 && isToUs(p) && p->to > 0 && !isBroadcast(p->to) && nodeDB->getMeshNode(p->from) != nullptr &&
-        nodeDB->getMeshNode(p->from)->user.public_key.size > 0 && nodeDB->getMeshNode(p->to)->user.public_key.size > 0 &&
-        rawSize > MESHTASTIC_PKC_OVERHEAD) {
+    if (isPkiCandidate(p)) {
         LOG_DEBUG("Attempt PKI decryption");
 
         if (crypto->decryptCurve25519(p->from, nodeDB->getMeshNode(p->from)->user.public_key, p->id, rawSize, p->encrypted.bytes,
@@ -386,76 +509,107 @@ DecodeState perhapsDecode(meshtastic_MeshPacket *p)
 #endif
 
     // assert(p->which_payloadVariant == MeshPacket_encrypted_tag);
-    if (!decrypted) {
-        // Try to find a channel that works with this hash
-        for (chIndex = 0; chIndex < channels.getNumChannels(); chIndex++) {
-            // Try to use this hash/channel pair
-            if (channels.decryptForHash(chIndex, p->channel)) {
-                // we have to copy into a scratch buffer, because these bytes are a union with the decoded protobuf. Create a
-                // fresh copy for each decrypt attempt.
-                memcpy(bytes, p->encrypted.bytes, rawSize);
-                // Try to decrypt the packet if we can
-                crypto->decrypt(p->from, p->id, rawSize, bytes);
-
-                // printBytes("plaintext", bytes, p->encrypted.size);
-
-                // Take those raw bytes and convert them back into a well structured protobuf we can understand
-                meshtastic_Data decodedtmp;
-                memset(&decodedtmp, 0, sizeof(decodedtmp));
-                if (!pb_decode_from_bytes(bytes, rawSize, &meshtastic_Data_msg, &decodedtmp)) {
-                    LOG_ERROR("Invalid protobufs in received mesh packet id=0x%08x (bad psk?)!", p->id);
-                } else if (decodedtmp.portnum == meshtastic_PortNum_UNKNOWN_APP) {
-                    LOG_ERROR("Invalid portnum (bad psk?)!");
-                } else {
-                    p->decoded = decodedtmp;
-                    p->which_payload_variant = meshtastic_MeshPacket_decoded_tag; // change type to decoded
-                    decrypted = true;
-                    break;
-                }
-            }
-        }
-    }
-    if (decrypted) {
-        // parsing was successful
-        p->channel = chIndex; // change to store the index instead of the hash
-        if (p->decoded.has_bitfield)
-            p->decoded.want_response |= p->decoded.bitfield & BITFIELD_WANT_RESPONSE_MASK;
-
-        /* Not actually ever used.
-        // Decompress if needed. jm
-        if (p->decoded.portnum == meshtastic_PortNum_TEXT_MESSAGE_COMPRESSED_APP) {
-            // Decompress the payload
-            char compressed_in[meshtastic_Constants_DATA_PAYLOAD_LEN] = {};
-            char decompressed_out[meshtastic_Constants_DATA_PAYLOAD_LEN] = {};
-            int decompressed_len;
-
-            memcpy(compressed_in, p->decoded.payload.bytes, p->decoded.payload.size);
-
-            decompressed_len = unishox2_decompress_simple(compressed_in, p->decoded.payload.size, decompressed_out);
-
-            // LOG_DEBUG("**Decompressed length - %d ", decompressed_len);
+    if (!decrypted)
+        decrypted = decodeWithChannels(p, 0, chIndex);
+    return finishDecode(p, chIndex, decrypted);
+}
 
-            memcpy(p->decoded.payload.bytes, decompressed_out, decompressed_len);
+DecodeState perhapsDecode(meshtastic_MeshPacket *p)
+{
+    concurrency::LockGuard g(cryptLock);
+    return perhapsDecodeLocked(p);
+}
 
-            // Switch the port from PortNum_TEXT_MESSAGE_COMPRESSED_APP to PortNum_TEXT_MESSAGE_APP
-            p->decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
-        } */
+void perhapsDecodeBatch(meshtastic_MeshPacket **packets, size_t numPackets, DecodeState *results)
+{
+    concurrency::LockGuard g(cryptLock);
 
-        printPacket("decoded message", p);
-#if ENABLE_JSON_LOGGING
-        LOG_TRACE("%s", MeshPacketSerializer::JsonSerialize(p, false).c_str());
-#elif ARCH_PORTDUINO
-        if (settingsStrings[traceFilename] != "" || settingsMap[logoutputlevel] == level_trace) {
-            LOG_TRACE("%s", MeshPacketSerializer::JsonSerialize(p, false).c_str());
+    // First try every packet with the first channel whose hash matches, which is the right one unless two of our channels
+    // share a hash. Anything else (PKI, hash collisions, failures) goes through the one at a time path.
+    struct Pending {
+        size_t packet;
+        ChannelIndex chIndex;
+    };
+    std::vector<Pending> pending;
+    std::vector<CryptoKey> keys;
+    for (size_t i = 0; i < numPackets; i++) {
+        meshtastic_MeshPacket *p = packets[i];
+        if (!shouldDecode(p, results[i]))
+            continue;
+#if !(MESHTASTIC_EXCLUDE_PKI)
+        if (isPkiCandidate(p)) {
+            results[i] = perhapsDecodeLocked(p);
+            continue;
         }
 #endif
-        return DecodeState::DECODE_SUCCESS;
-    } else {
-        LOG_WARN("No suitable channel found for decoding, hash was 0x%x!", p->channel);
-        return DecodeState::DECODE_FAILURE;
+        ChannelIndex chIndex = 0;
+        while (chIndex < channels.getNumChannels() && channels.getHash(chIndex) != (ChannelHash)p->channel)
+            chIndex++;
+        if (chIndex == channels.getNumChannels()) {
+            results[i] = finishDecode(p, chIndex, false);
+            continue;
+        }
+        pending.push_back({i, chIndex});
+        keys.push_back(channels.getKey(chIndex));
+    }
+    if (pending.empty())
+        return;
+
+    // Sort by channel so jobs sharing a key are adjacent and reuse the key schedule
+    std::vector<size_t> order(pending.size());
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return pending[a].chIndex < pending[b].chIndex; });
+
+    const size_t slot = sizeof(bytes);
+    std::vector<uint8_t> plaintext(pending.size() * slot);
+    std::vector<CryptoEngine::DecryptJob> jobs(pending.size());
+    for (size_t j = 0; j < order.size(); j++) {
+        const size_t i = order[j];
+        const meshtastic_MeshPacket *p = packets[pending[i].packet];
+        uint8_t *buf = &plaintext[i * slot];
+        memcpy(buf, p->encrypted.bytes, p->encrypted.size);
+        jobs[j] = {&keys[i], p->from, p->id, p->encrypted.size, buf};
     }
+    crypto->decryptBatch(jobs.data(), jobs.size());
+
+    for (size_t i = 0; i < pending.size(); i++) {
+        meshtastic_MeshPacket *p = packets[pending[i].packet];
+        ChannelIndex chIndex = pending[i].chIndex;
+        bool decrypted = decodeDecrypted(p, &plaintext[i * slot], p->encrypted.size);
+        if (!decrypted)
+            decrypted = decodeWithChannels(p, chIndex + 1, chIndex);
+        results[pending[i].packet] = finishDecode(p, chIndex, decrypted);
+    }
+}
+
+bool shouldCompressText(const meshtastic_MeshPacket *p)
+{
+    if (p->decoded.portnum != meshtastic_PortNum_TEXT_MESSAGE_APP || !isFromUs(p) || isBroadcast(p->to) || isToUs(p))
+        return false;
+    const meshtastic_NodeInfoLite *node = nodeDB->getMeshNode(p->to);
+    return node && (node->bitfield & NODEINFO_BITFIELD_CAN_DECOMPRESS_TEXT_MASK);
 }
 
+#if USERPREFS_COMPRESS_TEXT_MESSAGES
+/// Fill out with a TEXT_MESSAGE_COMPRESSED_APP copy of in, returns false if compression wouldn't save anything
+static bool compressText(const meshtastic_Data &in, meshtastic_Data &out)
+{
+    char buf[sizeof(in.payload.bytes)];
+    int len = unishox2_compress_lines((const char *)in.payload.bytes, in.payload.size, buf, sizeof(buf), USX_PSET_DFLT, NULL);
+    // unishox2 returns olen + 1 when the output did not fit
+    if (len <= 0 || len >= (int)in.payload.size)
+        return false;
+
+    out = in;
+    memcpy(out.payload.bytes, buf, len);
+    out.payload.size = len;
+    out.portnum = meshtastic_PortNum_TEXT_MESSAGE_COMPRESSED_APP;
+    LOG_DEBUG("Compressed text message %u -> %d bytes", in.payload.size, len);
+    return true;
+}
+#endif
+
 /** Return 0 for success or a Routing_Error code for failure
  */
 meshtastic_Routing_Error perhapsEncode(meshtastic_MeshPacket *p)
@@ -470,44 +624,21 @@ meshtastic_Routing_Error perhapsEncode(meshtastic_MeshPacket *p)
             p->decoded.has_bitfield = true;
             p->decoded.bitfield |= (config.lora.config_ok_to_mqtt << BITFIELD_OK_TO_MQTT_SHIFT);
             p->decoded.bitfield |= (p->decoded.want_response << BITFIELD_WANT_RESPONSE_SHIFT);
+#if USERPREFS_COMPRESS_TEXT_MESSAGES
+            if (p->decoded.portnum == meshtastic_PortNum_NODEINFO_APP)
+                p->decoded.bitfield |= BITFIELD_CAN_DECOMPRESS_TEXT_MASK;
+#endif
         }
 
-        size_t numbytes = pb_encode_to_bytes(bytes, sizeof(bytes), &meshtastic_Data_msg, &p->decoded);
-
-        /* Not actually used, so save the cycles
-        //  TODO: Allow modules to opt into compression.
-        if (p->decoded.portnum == meshtastic_PortNum_TEXT_MESSAGE_APP) {
-
-            char original_payload[meshtastic_Constants_DATA_PAYLOAD_LEN];
-            memcpy(original_payload, p->decoded.payload.bytes, p->decoded.payload.size);
-
-            char compressed_out[meshtastic_Constants_DATA_PAYLOAD_LEN] = {0};
-
-            int compressed_len;
-            compressed_len = unishox2_compress_simple(original_payload, p->decoded.payload.size, compressed_out);
-
-            LOG_DEBUG("Original length - %d ", p->decoded.payload.size);
-            LOG_DEBUG("Compressed length - %d ", compressed_len);
-            LOG_DEBUG("Original message - %s ", p->decoded.payload.bytes);
-
-            // If the compressed length is greater than or equal to the original size, don't use the compressed form
-            if (compressed_len >= p->decoded.payload.size) {
-
-                LOG_DEBUG("Not using compressing message");
-                // Set the uncompressed payload variant anyway. Shouldn't hurt?
-                // p->decoded.which_payloadVariant = Data_payload_tag;
-
-                // Otherwise we use the compressor
-            } else {
-                LOG_DEBUG("Use compressed message");
-                // Copy the compressed data into the meshpacket
+        const meshtastic_Data *data = &p->decoded;
+#if USERPREFS_COMPRESS_TEXT_MESSAGES
+        // Compress into a copy, p->decoded shares its storage with the encrypted bytes we are about to write
+        meshtastic_Data compressed;
+        if (shouldCompressText(p) && compressText(p->decoded, compressed))
+            data = &compressed;
+#endif
 
-                p->decoded.payload.size = compressed_len;
-                memcpy(p->decoded.payload.bytes, compressed_out, compressed_len);
-
-                p->decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_COMPRESSED_APP;
-            }
-        } */
+        size_t numbytes = pb_encode_to_bytes(bytes, sizeof(bytes), &meshtastic_Data_msg, data);
 
         if (numbytes + MESHTASTIC_HEADER_LENGTH > MAX_LORA_PAYLOAD_LEN)
             return meshtastic_Routing_Error_TOO_LARGE;
@@ -617,8 +748,17 @@ void Router::handleReceived(meshtastic_MeshPacket *p, RxSource src)
     bool skipHandle = false;
     // Also, we should set the time from the ISR and it should have msec level resolution
     p->rx_time = getValidTime(RTCQualityFromNet); // store the arrival timestamp for the phone
-    // Store a copy of encrypted packet for MQTT
-    meshtastic_MeshPacket *p_encrypted = packetPool.allocCopy(*p);
+    // Store a copy of encrypted packet for MQTT, only if we might publish it
+    meshtastic_MeshPacket *p_encrypted = NULL;
+#if !MESHTASTIC_EXCLUDE_MQTT
+    if (moduleConfig.mqtt.enabled && !isFromUs(p) && mqtt)
+        p_encrypted = packetPool.allocCopy(*p);
+#endif
+
+    // Airtime of what we heard, to attribute to the portnum once we know it
+    uint32_t rxAirtimeMsec = 0;
+    if (src == RX_SRC_RADIO && !p->via_mqtt && iface && p->which_payload_variant == meshtastic_MeshPacket_encrypted_tag)
+        rxAirtimeMsec = iface->getPacketTime(p);
 
     // Take those raw bytes and convert them back into a well structured protobuf we can understand
     auto decodedState = perhapsDecode(p);
@@ -628,6 +768,12 @@ void Router::handleReceived(meshtastic_MeshPacket *p, RxSource src)
         cancelSending(p->from, p->id);
         skipHandle = true;
     } else if (decodedState == DecodeState::DECODE_SUCCESS) {
+        if (airTime) {
+            if (rxAirtimeMsec)
+                airTime->logPortnumAirtime(p->decoded.portnum, rxAirtimeMsec);
+            airTime->rememberPortnum(p->from, p->id, p->decoded.portnum); // in case we relay it
+        }
+
         // parsing was successful, queue for our recipient
         if (src == RX_SRC_LOCAL)
             printPacket("handleReceived(LOCAL)", p);
@@ -670,17 +816,20 @@ void Router::handleReceived(meshtastic_MeshPacket *p, RxSource src)
 #if !MESHTASTIC_EXCLUDE_MQTT
         // Mark as pki_encrypted if it is not yet decoded and MQTT encryption is also enabled, hash matches and it's a DM not to
         // us (because we would be able to decrypt it)
-        if (decodedState == DecodeState::DECODE_FAILURE && moduleConfig.mqtt.encryption_enabled && p->channel == 0x00 &&
-            !isBroadcast(p->to) && !isToUs(p))
-            p_encrypted->pki_encrypted = true;
-        // After potentially altering it, publish received message to MQTT if we're not the original transmitter of the packet
-        if ((decodedState == DecodeState::DECODE_SUCCESS || p_encrypted->pki_encrypted) && moduleConfig.mqtt.enabled &&
-            !isFromUs(p) && mqtt)
-            mqtt->onSend(*p_encrypted, *p, p->channel);
+        if (p_encrypted) {
+            if (decodedState == DecodeState::DECODE_FAILURE && moduleConfig.mqtt.encryption_enabled && p->channel == 0x00 &&
+                !isBroadcast(p->to) && !isToUs(p))
+                p_encrypted->pki_encrypted = true;
+            // After potentially altering it, publish received message to MQTT if we're not the original transmitter of the
+            // packet
+            if (decodedState == DecodeState::DECODE_SUCCESS || p_encrypted->pki_encrypted)
+                mqtt->onSend(*p_encrypted, *p, p->channel);
+        }
 #endif
     }
 
-    packetPool.release(p_encrypted); // Release the encrypted packet
+    if (p_encrypted)
+        packetPool.release(p_encrypted); // Release the encrypted packet
 }
 
 void Router::perhapsHandleReceived(meshtastic_MeshPacket *p)
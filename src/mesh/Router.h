@@ -149,17 +149,36 @@ enum DecodeState { DECODE_SUCCESS, DECODE_FAILURE, DECODE_FATAL };
  */
 DecodeState perhapsDecode(meshtastic_MeshPacket *p);
 
+/**
+ * Same as perhapsDecode() for several packets at once (e.g. a burst of MQTT downlink), the channel decryption of all of them
+ * is done with one CryptoEngine::decryptBatch() call.
+ *
+ * @param results receives the DecodeState for each packet
+ */
+void perhapsDecodeBatch(meshtastic_MeshPacket **packets, size_t numPackets, DecodeState *results);
+
 /** Return 0 for success or a Routing_Error code for failure
  */
 meshtastic_Routing_Error perhapsEncode(meshtastic_MeshPacket *p);
 
+/**
+ * Should this text message be sent as TEXT_MESSAGE_COMPRESSED_APP: only text we originate to a single node that has told us
+ * it can decode it. Broadcasts stay plain so older nodes can still read them. perhapsEncode() only asks when built with
+ * USERPREFS_COMPRESS_TEXT_MESSAGES.
+ */
+bool shouldCompressText(const meshtastic_MeshPacket *p);
+
 extern Router *router;
 
 /// Generate a unique packet id
 // FIXME, move this someplace better
 PacketId generatePacketId();
 
+// Not reserved in the protobufs, so it is only sent on NodeInfo by builds with USERPREFS_COMPRESS_TEXT_MESSAGES, and only read
+// from NodeInfo
+#define BITFIELD_CAN_DECOMPRESS_TEXT_SHIFT 2
 #define BITFIELD_WANT_RESPONSE_SHIFT 1
 #define BITFIELD_OK_TO_MQTT_SHIFT 0
+#define BITFIELD_CAN_DECOMPRESS_TEXT_MASK (1 << BITFIELD_CAN_DECOMPRESS_TEXT_SHIFT)
 #define BITFIELD_WANT_RESPONSE_MASK (1 << BITFIELD_WANT_RESPONSE_SHIFT)
 #define BITFIELD_OK_TO_MQTT_MASK (1 << BITFIELD_OK_TO_MQTT_SHIFT)
\ No newline at end of file
@@ -32,7 +32,6 @@ class PacketAPI : public PhoneAPI, public concurrency::OSThread
     bool isConnected;
     bool programmingMode;
     PacketServer *server;
-    uint8_t txBuf[MAX_TO_FROM_RADIO_SIZE] = {0}; // dummy buf to obey PhoneAPI
 };
 
 extern PacketAPI *packetAPI;
\ No newline at end of file
@@ -148,34 +148,30 @@ unsigned int usx_mask[] = {0x80, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC, 0xFE, 0xFF};
 
 /// Appends specified number of bits to the output (out) \n
 /// If maximum limit (olen) is reached, -1 is returned \n
-/// Otherwise clen bits in code are appended to out starting with MSB
+/// Otherwise clen bits in code are appended to out starting with MSB \n
+/// A code is at most 8 bits, so it always lands in one or two output bytes, written without looping over the bits
 int append_bits(char *out, int olen, int ol, uint8_t code, int clen)
 {
 
     // printf("%d,%x,%d,%d\n", ol, code, clen, state);
 
-    while (clen > 0) {
-        int oidx;
-        unsigned char a_byte;
-
-        uint8_t cur_bit = ol % 8;
-        uint8_t blen = clen;
-        a_byte = code & usx_mask[blen - 1];
-        a_byte >>= cur_bit;
-        if (blen + cur_bit > 8)
-            blen = (8 - cur_bit);
-        oidx = ol / 8;
-        if (oidx < 0 || olen <= oidx)
+    if (clen <= 0)
+        return ol;
+    const uint8_t cur_bit = ol % 8;
+    const int oidx = ol / 8;
+    if (oidx < 0 || olen <= oidx)
+        return -1;
+    const uint8_t a_byte = code & usx_mask[clen - 1];
+    if (cur_bit == 0)
+        out[oidx] = a_byte;
+    else
+        out[oidx] |= a_byte >> cur_bit;
+    if (clen + cur_bit > 8) {
+        if (olen <= oidx + 1)
             return -1;
-        if (cur_bit == 0)
-            out[oidx] = a_byte;
-        else
-            out[oidx] |= a_byte;
-        code <<= blen;
-        ol += blen;
-        clen -= blen;
+        out[oidx + 1] = a_byte << (8 - cur_bit);
     }
-    return ol;
+    return ol + clen;
 }
 
 /// This is a safe call to append_bits() making sure it does not write past olen
@@ -346,6 +342,8 @@ int matchOccurance(const char *in, int len, int l, char *out, int olen, int *ol,
     int longest_dist = 0;
     int longest_len = 0;
     for (j = l - NICE_LEN; j >= 0; j--) {
+        if (in[j] != in[l])
+            continue; // can't be a match of NICE_LEN or more, skip the byte by byte comparison
         for (k = l; k < len && j + k - l < l; k++) {
             if (in[k] != in[j + k - l])
                 break;
@@ -397,6 +395,8 @@ int matchLine(const char *in, int len, int l, char *out, int olen, int *ol, stru
         int line_len = (int)strlen(prev_lines->data);
         int limit = (line_ctr == 0 ? l : line_len);
         for (; j < limit; j++) {
+            if (j >= line_len || prev_lines->data[j] != in[l])
+                continue; // can't be a match of NICE_LEN or more, skip the byte by byte comparison
             for (i = l, k = j; k < line_len && i < len; k++, i++) {
                 if (prev_lines->data[k] != in[i])
                     break;
@@ -548,6 +548,19 @@ int unishox2_compress_lines(const char *in, int len, UNISHOX_API_OUT_AND_LEN(cha
 #endif
 
     init_coder();
+
+    // Lengths of the templates and frequent sequences, instead of calling strlen() on them for every input character
+    int template_lens[5] = {0};
+    if (usx_templates != NULL) {
+        for (int i = 0; i < 5; i++)
+            template_lens[i] = usx_templates[i] ? (int)strlen(usx_templates[i]) : 0;
+    }
+    int freq_seq_lens[6] = {0};
+    if (usx_freq_seq != NULL) {
+        for (int i = 0; i < 6; i++)
+            freq_seq_lens[i] = (int)strlen(usx_freq_seq[i]);
+    }
+
     ol = 0;
     prev_uni = 0;
     state = USX_ALPHA;
@@ -656,7 +669,7 @@ int unishox2_compress_lines(const char *in, int len, UNISHOX_API_OUT_AND_LEN(cha
             int i;
             for (i = 0; i < 5; i++) {
                 if (usx_templates[i]) {
-                    int rem = (int)strlen(usx_templates[i]);
+                    int rem = template_lens[i];
                     int j = 0;
                     for (; j < rem && l + j < len; j++) {
                         char c_t = usx_templates[i][j];
@@ -702,7 +715,7 @@ int unishox2_compress_lines(const char *in, int len, UNISHOX_API_OUT_AND_LEN(cha
         if (usx_freq_seq != NULL) {
             int i;
             for (i = 0; i < 6; i++) {
-                int seq_len = (int)strlen(usx_freq_seq[i]);
+                int seq_len = freq_seq_lens[i];
                 if (len - seq_len >= 0 && l <= len - seq_len) {
                     if (memcmp(usx_freq_seq[i], in + l, seq_len) == 0 && usx_hcode_lens[usx_freq_codes[i] >> 5]) {
                         SAFE_APPEND_BITS2(rawolen,
@@ -897,49 +910,40 @@ int read8bitCode(const char *in, int len, int bit_no)
     return code;
 }
 
-/// The list of veritical codes is split into 5 sections. Used by readVCodeIdx()
-#define SECTION_COUNT 5
-/// Used by readVCodeIdx() for finding the section under which the code read using read8bitCode() falls
-uint8_t usx_vsections[] = {0x7F, 0xBF, 0xDF, 0xEF, 0xFF};
-/// Used by readVCodeIdx() for finding the section vertical position offset
-uint8_t usx_vsection_pos[] = {0, 4, 8, 12, 20};
-/// Used by readVCodeIdx() for masking the code read by read8bitCode()
-uint8_t usx_vsection_mask[] = {0x7F, 0x3F, 0x1F, 0x0F, 0x0F};
-/// Used by readVCodeIdx() for shifting the code read by read8bitCode() to obtain the vpos
-uint8_t usx_vsection_shift[] = {5, 4, 3, 1, 0};
-
-/// Vertical decoder lookup table - 3 bits code len, 5 bytes vertical pos
-/// code len is one less as 8 cannot be accommodated in 3 bits
-uint8_t usx_vcode_lookup[36] = {(1 << 5) + 0,  (1 << 5) + 0,  (2 << 5) + 1,  (2 << 5) + 2,  // Section 1
-                                (3 << 5) + 3,  (3 << 5) + 4,  (3 << 5) + 5,  (3 << 5) + 6,  // Section 2
-                                (3 << 5) + 7,  (3 << 5) + 7,  (4 << 5) + 8,  (4 << 5) + 9,  // Section 3
-                                (5 << 5) + 10, (5 << 5) + 10, (5 << 5) + 11, (5 << 5) + 11, // Section 4
-                                (5 << 5) + 12, (5 << 5) + 12, (6 << 5) + 13, (6 << 5) + 14, (6 << 5) + 15, (6 << 5) + 15,
-                                (6 << 5) + 16, (6 << 5) + 16, // Section 5
-                                (6 << 5) + 17, (6 << 5) + 17, (7 << 5) + 18, (7 << 5) + 19, (7 << 5) + 20, (7 << 5) + 21,
-                                (7 << 5) + 22, (7 << 5) + 23, (7 << 5) + 24, (7 << 5) + 25, (7 << 5) + 26, (7 << 5) + 27};
+/// Vertical code for every value of the next 8 bits of input - 3 bits code len, 5 bits vertical pos \n
+/// code len is one less as 8 cannot be accommodated in 3 bits. \n
+/// Vertical codes are 2 to 8 bits long, so every byte starting with a code's bits maps to that code
+/// (e.g. 0x00-0x3F all decode as vpos 0, len 2). Kept const so it stays in flash.
+static const uint8_t usx_vcode_by_byte[256] = {
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41,
+    0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41,
+    0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42,
+    0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42,
+    0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63,
+    0x64, 0x64, 0x64, 0x64, 0x64, 0x64, 0x64, 0x64, 0x64, 0x64, 0x64, 0x64, 0x64, 0x64, 0x64, 0x64,
+    0x65, 0x65, 0x65, 0x65, 0x65, 0x65, 0x65, 0x65, 0x65, 0x65, 0x65, 0x65, 0x65, 0x65, 0x65, 0x65,
+    0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66,
+    0x67, 0x67, 0x67, 0x67, 0x67, 0x67, 0x67, 0x67, 0x67, 0x67, 0x67, 0x67, 0x67, 0x67, 0x67, 0x67,
+    0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89,
+    0xAA, 0xAA, 0xAA, 0xAA, 0xAB, 0xAB, 0xAB, 0xAB, 0xAC, 0xAC, 0xAC, 0xAC, 0xCD, 0xCD, 0xCE, 0xCE,
+    0xCF, 0xCF, 0xD0, 0xD0, 0xD1, 0xD1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 0xFA, 0xFB,
+};
 
 /// Decodes the vertical code from the given bitstream at in \n
-/// This is designed to use less memory using a 36 uint8_t buffer \n
-/// compared to using a 256 uint8_t buffer to decode the next 8 bits read by read8bitCode() \n
-/// by splitting the list of vertical codes. \n
-/// Decoder is designed for using less memory, not speed. \n
 /// Returns the veritical code index or 99 if match could not be found. \n
 /// Also updates bit_no_p with how many ever bits used by the vertical code.
 int readVCodeIdx(const char *in, int len, int *bit_no_p)
 {
     if (*bit_no_p < len) {
-        uint8_t code = read8bitCode(in, len, *bit_no_p);
-        int i = 0;
-        do {
-            if (code <= usx_vsections[i]) {
-                uint8_t vcode = usx_vcode_lookup[usx_vsection_pos[i] + ((code & usx_vsection_mask[i]) >> usx_vsection_shift[i])];
-                (*bit_no_p) += ((vcode >> 5) + 1);
-                if (*bit_no_p > len)
-                    return 99;
-                return vcode & 0x1F;
-            }
-        } while (++i < SECTION_COUNT);
+        uint8_t vcode = usx_vcode_by_byte[(uint8_t)read8bitCode(in, len, *bit_no_p)];
+        (*bit_no_p) += ((vcode >> 5) + 1);
+        if (*bit_no_p > len)
+            return 99;
+        return vcode & 0x1F;
     }
     return 99;
 }
@@ -984,15 +988,24 @@ int getStepCodeIdx(const char *in, int len, int *bit_no_p, int limit)
     return idx;
 }
 
-/// Reads specified number of bits and builds the corresponding integer
+/// Reads specified number of bits and builds the corresponding integer \n
+/// Returns -1 if the input ends first. Takes up to a byte at a time rather than single bits
 int32_t getNumFromBits(const char *in, int len, int bit_no, int count)
 {
+    if (count <= 0)
+        return 0;
+    if (bit_no + count > len)
+        return -1;
     int32_t ret = 0;
-    while (count-- && bit_no < len) {
-        ret += (readBit(in, bit_no) ? 1 << count : 0);
-        bit_no++;
+    while (count > 0) {
+        const int bit_pos = bit_no & 0x07;
+        const int take = count < 8 - bit_pos ? count : 8 - bit_pos;
+        const uint8_t bits = ((uint8_t)in[bit_no >> 3]) >> (8 - bit_pos - take);
+        ret = (ret << take) | (bits & ((1 << take) - 1));
+        bit_no += take;
+        count -= take;
     }
-    return count < 0 ? ret : -1;
+    return ret;
 }
 
 /// Decodes the count from the given bit stream at in. Also updates bit_no_p
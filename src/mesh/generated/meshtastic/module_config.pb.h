@@ -114,6 +114,9 @@ typedef struct _meshtastic_ModuleConfig_MapReportSettings {
     uint32_t position_precision;
     /* Whether we have opted-in to report our location to the map */
     bool should_report_location;
+    /* Report the positions of all nodes heard on channels with uplink enabled in one MapReportBatch per interval,
+ instead of a MapReport for this node only */
+    bool batch_node_positions;
 } meshtastic_ModuleConfig_MapReportSettings;
 
 /* MQTT Client Config */
@@ -507,7 +510,7 @@ extern "C" {
 /* Initializer values for message structs */
 #define meshtastic_ModuleConfig_init_default     {0, {meshtastic_ModuleConfig_MQTTConfig_init_default}}
 #define meshtastic_ModuleConfig_MQTTConfig_init_default {0, "", "", "", 0, 0, 0, "", 0, 0, false, meshtastic_ModuleConfig_MapReportSettings_init_default}
-#define meshtastic_ModuleConfig_MapReportSettings_init_default {0, 0, 0}
+#define meshtastic_ModuleConfig_MapReportSettings_init_default {0, 0, 0, 0}
 #define meshtastic_ModuleConfig_RemoteHardwareConfig_init_default {0, 0, 0, {meshtastic_RemoteHardwarePin_init_default, meshtastic_RemoteHardwarePin_init_default, meshtastic_RemoteHardwarePin_init_default, meshtastic_RemoteHardwarePin_init_default}}
 #define meshtastic_ModuleConfig_NeighborInfoConfig_init_default {0, 0, 0}
 #define meshtastic_ModuleConfig_DetectionSensorConfig_init_default {0, 0, 0, 0, "", 0, _meshtastic_ModuleConfig_DetectionSensorConfig_TriggerType_MIN, 0}
@@ -523,7 +526,7 @@ extern "C" {
 #define meshtastic_RemoteHardwarePin_init_default {0, "", _meshtastic_RemoteHardwarePinType_MIN}
 #define meshtastic_ModuleConfig_init_zero        {0, {meshtastic_ModuleConfig_MQTTConfig_init_zero}}
 #define meshtastic_ModuleConfig_MQTTConfig_init_zero {0, "", "", "", 0, 0, 0, "", 0, 0, false, meshtastic_ModuleConfig_MapReportSettings_init_zero}
-#define meshtastic_ModuleConfig_MapReportSettings_init_zero {0, 0, 0}
+#define meshtastic_ModuleConfig_MapReportSettings_init_zero {0, 0, 0, 0}
 #define meshtastic_ModuleConfig_RemoteHardwareConfig_init_zero {0, 0, 0, {meshtastic_RemoteHardwarePin_init_zero, meshtastic_RemoteHardwarePin_init_zero, meshtastic_RemoteHardwarePin_init_zero, meshtastic_RemoteHardwarePin_init_zero}}
 #define meshtastic_ModuleConfig_NeighborInfoConfig_init_zero {0, 0, 0}
 #define meshtastic_ModuleConfig_DetectionSensorConfig_init_zero {0, 0, 0, 0, "", 0, _meshtastic_ModuleConfig_DetectionSensorConfig_TriggerType_MIN, 0}
@@ -542,6 +545,7 @@ extern "C" {
 #define meshtastic_ModuleConfig_MapReportSettings_publish_interval_secs_tag 1
 #define meshtastic_ModuleConfig_MapReportSettings_position_precision_tag 2
 #define meshtastic_ModuleConfig_MapReportSettings_should_report_location_tag 3
+#define meshtastic_ModuleConfig_MapReportSettings_batch_node_positions_tag 4
 #define meshtastic_ModuleConfig_MQTTConfig_enabled_tag 1
 #define meshtastic_ModuleConfig_MQTTConfig_address_tag 2
 #define meshtastic_ModuleConfig_MQTTConfig_username_tag 3
@@ -706,7 +710,8 @@ X(a, STATIC,   OPTIONAL, MESSAGE,  map_report_settings,  11)
 #define meshtastic_ModuleConfig_MapReportSettings_FIELDLIST(X, a) \
 X(a, STATIC,   SINGULAR, UINT32,   publish_interval_secs,   1) \
 X(a, STATIC,   SINGULAR, UINT32,   position_precision,   2) \
-X(a, STATIC,   SINGULAR, BOOL,     should_report_location,   3)
+X(a, STATIC,   SINGULAR, BOOL,     should_report_location,   3) \
+X(a, STATIC,   SINGULAR, BOOL,     batch_node_positions,   4)
 #define meshtastic_ModuleConfig_MapReportSettings_CALLBACK NULL
 #define meshtastic_ModuleConfig_MapReportSettings_DEFAULT NULL
 
@@ -894,8 +899,8 @@ extern const pb_msgdesc_t meshtastic_RemoteHardwarePin_msg;
 #define meshtastic_ModuleConfig_CannedMessageConfig_size 49
 #define meshtastic_ModuleConfig_DetectionSensorConfig_size 44
 #define meshtastic_ModuleConfig_ExternalNotificationConfig_size 42
-#define meshtastic_ModuleConfig_MQTTConfig_size  224
-#define meshtastic_ModuleConfig_MapReportSettings_size 14
+#define meshtastic_ModuleConfig_MQTTConfig_size  226
+#define meshtastic_ModuleConfig_MapReportSettings_size 16
 #define meshtastic_ModuleConfig_NeighborInfoConfig_size 10
 #define meshtastic_ModuleConfig_PaxcounterConfig_size 30
 #define meshtastic_ModuleConfig_RangeTestConfig_size 10
@@ -903,7 +908,7 @@ extern const pb_msgdesc_t meshtastic_RemoteHardwarePin_msg;
 #define meshtastic_ModuleConfig_SerialConfig_size 28
 #define meshtastic_ModuleConfig_StoreForwardConfig_size 24
 #define meshtastic_ModuleConfig_TelemetryConfig_size 46
-#define meshtastic_ModuleConfig_size             227
+#define meshtastic_ModuleConfig_size             229
 #define meshtastic_RemoteHardwarePin_size        21
 
 #ifdef __cplusplus
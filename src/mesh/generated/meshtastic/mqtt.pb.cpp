@@ -12,4 +12,10 @@ PB_BIND(meshtastic_ServiceEnvelope, meshtastic_ServiceEnvelope, AUTO)
 PB_BIND(meshtastic_MapReport, meshtastic_MapReport, AUTO)
 
 
+PB_BIND(meshtastic_MapReportNode, meshtastic_MapReportNode, AUTO)
+
+
+PB_BIND(meshtastic_MapReportBatch, meshtastic_MapReportBatch, AUTO)
+
+
 
@@ -59,6 +59,32 @@ typedef struct _meshtastic_MapReport {
     bool has_opted_report_location;
 } meshtastic_MapReport;
 
+/* Position of one node in a MapReportBatch */
+typedef struct _meshtastic_MapReportNode {
+    /* The node number */
+    uint32_t num;
+    /* Latitude: multiply by 1e-7 to get degrees in floating point */
+    int32_t latitude_i;
+    /* Longitude: multiply by 1e-7 to get degrees in floating point */
+    int32_t longitude_i;
+    /* Altitude in meters above MSL */
+    int32_t altitude;
+    /* Indicates the bits of precision for latitude and longitude set by the reporting gateway */
+    uint32_t position_precision;
+    /* Time (in secs since 1970) the gateway last heard from this node */
+    uint32_t last_heard;
+} meshtastic_MapReportNode;
+
+/* Positions of the nodes a gateway has heard, reported unencrypted to a map using MQTT in one message per interval.
+ Sent instead of a MapReport when map_report_settings.batch_node_positions is set. */
+typedef struct _meshtastic_MapReportBatch {
+    /* The node ID of the reporting gateway */
+    char gateway_id[16];
+    /* The gateway itself, then the nodes it recently heard on channels with uplink enabled */
+    pb_size_t nodes_count;
+    meshtastic_MapReportNode nodes[12];
+} meshtastic_MapReportBatch;
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -67,8 +93,12 @@ extern "C" {
 /* Initializer values for message structs */
 #define meshtastic_ServiceEnvelope_init_default  {NULL, NULL, NULL}
 #define meshtastic_MapReport_init_default        {"", "", _meshtastic_Config_DeviceConfig_Role_MIN, _meshtastic_HardwareModel_MIN, "", _meshtastic_Config_LoRaConfig_RegionCode_MIN, _meshtastic_Config_LoRaConfig_ModemPreset_MIN, 0, 0, 0, 0, 0, 0, 0}
+#define meshtastic_MapReportNode_init_default    {0, 0, 0, 0, 0, 0}
+#define meshtastic_MapReportBatch_init_default   {"", 0, {meshtastic_MapReportNode_init_default, meshtastic_MapReportNode_init_default, meshtastic_MapReportNode_init_default, meshtastic_MapReportNode_init_default, meshtastic_MapReportNode_init_default, meshtastic_MapReportNode_init_default, meshtastic_MapReportNode_init_default, meshtastic_MapReportNode_init_default, meshtastic_MapReportNode_init_default, meshtastic_MapReportNode_init_default, meshtastic_MapReportNode_init_default, meshtastic_MapReportNode_init_default}}
 #define meshtastic_ServiceEnvelope_init_zero     {NULL, NULL, NULL}
 #define meshtastic_MapReport_init_zero           {"", "", _meshtastic_Config_DeviceConfig_Role_MIN, _meshtastic_HardwareModel_MIN, "", _meshtastic_Config_LoRaConfig_RegionCode_MIN, _meshtastic_Config_LoRaConfig_ModemPreset_MIN, 0, 0, 0, 0, 0, 0, 0}
+#define meshtastic_MapReportNode_init_zero       {0, 0, 0, 0, 0, 0}
+#define meshtastic_MapReportBatch_init_zero      {"", 0, {meshtastic_MapReportNode_init_zero, meshtastic_MapReportNode_init_zero, meshtastic_MapReportNode_init_zero, meshtastic_MapReportNode_init_zero, meshtastic_MapReportNode_init_zero, meshtastic_MapReportNode_init_zero, meshtastic_MapReportNode_init_zero, meshtastic_MapReportNode_init_zero, meshtastic_MapReportNode_init_zero, meshtastic_MapReportNode_init_zero, meshtastic_MapReportNode_init_zero, meshtastic_MapReportNode_init_zero}}
 
 /* Field tags (for use in manual encoding/decoding) */
 #define meshtastic_ServiceEnvelope_packet_tag    1
@@ -88,6 +118,14 @@ extern "C" {
 #define meshtastic_MapReport_position_precision_tag 12
 #define meshtastic_MapReport_num_online_local_nodes_tag 13
 #define meshtastic_MapReport_has_opted_report_location_tag 14
+#define meshtastic_MapReportNode_num_tag         1
+#define meshtastic_MapReportNode_latitude_i_tag  2
+#define meshtastic_MapReportNode_longitude_i_tag 3
+#define meshtastic_MapReportNode_altitude_tag    4
+#define meshtastic_MapReportNode_position_precision_tag 5
+#define meshtastic_MapReportNode_last_heard_tag  6
+#define meshtastic_MapReportBatch_gateway_id_tag 1
+#define meshtastic_MapReportBatch_nodes_tag      2
 
 /* Struct field encoding specification for nanopb */
 #define meshtastic_ServiceEnvelope_FIELDLIST(X, a) \
@@ -116,16 +154,39 @@ X(a, STATIC,   SINGULAR, BOOL,     has_opted_report_location,  14)
 #define meshtastic_MapReport_CALLBACK NULL
 #define meshtastic_MapReport_DEFAULT NULL
 
+#define meshtastic_MapReportNode_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, FIXED32,  num,               1) \
+X(a, STATIC,   SINGULAR, SFIXED32, latitude_i,        2) \
+X(a, STATIC,   SINGULAR, SFIXED32, longitude_i,       3) \
+X(a, STATIC,   SINGULAR, INT32,    altitude,          4) \
+X(a, STATIC,   SINGULAR, UINT32,   position_precision,   5) \
+X(a, STATIC,   SINGULAR, FIXED32,  last_heard,        6)
+#define meshtastic_MapReportNode_CALLBACK NULL
+#define meshtastic_MapReportNode_DEFAULT NULL
+
+#define meshtastic_MapReportBatch_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, STRING,   gateway_id,        1) \
+X(a, STATIC,   REPEATED, MESSAGE,  nodes,             2)
+#define meshtastic_MapReportBatch_CALLBACK NULL
+#define meshtastic_MapReportBatch_DEFAULT NULL
+#define meshtastic_MapReportBatch_nodes_MSGTYPE meshtastic_MapReportNode
+
 extern const pb_msgdesc_t meshtastic_ServiceEnvelope_msg;
 extern const pb_msgdesc_t meshtastic_MapReport_msg;
+extern const pb_msgdesc_t meshtastic_MapReportNode_msg;
+extern const pb_msgdesc_t meshtastic_MapReportBatch_msg;
 
 /* Defines for backwards compatibility with code written before nanopb-0.4.0 */
 #define meshtastic_ServiceEnvelope_fields &meshtastic_ServiceEnvelope_msg
 #define meshtastic_MapReport_fields &meshtastic_MapReport_msg
+#define meshtastic_MapReportNode_fields &meshtastic_MapReportNode_msg
+#define meshtastic_MapReportBatch_fields &meshtastic_MapReportBatch_msg
 
 /* Maximum encoded size of messages (where known) */
 /* meshtastic_ServiceEnvelope_size depends on runtime parameters */
-#define MESHTASTIC_MESHTASTIC_MQTT_PB_H_MAX_SIZE meshtastic_MapReport_size
+#define MESHTASTIC_MESHTASTIC_MQTT_PB_H_MAX_SIZE meshtastic_MapReportBatch_size
+#define meshtastic_MapReportBatch_size           485
+#define meshtastic_MapReportNode_size            37
 #define meshtastic_MapReport_size                110
 
 #ifdef __cplusplus
@@ -11,7 +11,9 @@
 #endif
 #include "Led.h"
 #include "SPILock.h"
+#include "TypeConversions.h"
 #include "power.h"
+#include "serialization/AirtimeSerializer.h"
 #include "serialization/JSON.h"
 #include <FSCommon.h>
 #include <HTTPBodyParser.hpp>
@@ -643,6 +645,9 @@ void handleReport(HTTPRequest *req, HTTPResponse *res)
     jsonObjAirtime["seconds_per_period"] = new JSONValue(int(airTime->getSecondsPerPeriod()));
     jsonObjAirtime["periods_to_log"] = new JSONValue(airTime->getPeriodsToLog());
 
+    // data->airtime->top_senders, data->airtime->top_portnums
+    AirtimeSerializer::addTopTalkers(jsonObjAirtime);
+
     // data->wifi
     JSONObject jsonObjWifi;
     jsonObjWifi["rssi"] = new JSONValue(WiFi.RSSI());
@@ -696,75 +701,131 @@ void handleReport(HTTPRequest *req, HTTPResponse *res)
     delete value;
 }
 
+// Write a JSON string literal, escaping as needed
+static void printJsonString(HTTPResponse *res, const char *str)
+{
+    res->print("\"");
+    for (const char *c = str; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            res->print("\\");
+            res->write((const uint8_t *)c, 1);
+        } else if ((uint8_t)*c < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", (uint8_t)*c);
+            res->print(escaped);
+        } else {
+            res->write((const uint8_t *)c, 1);
+        }
+    }
+    res->print("\"");
+}
+
+static void printNodeJson(HTTPResponse *res, const meshtastic_NodeInfoLite *node)
+{
+    char buf[160];
+    snprintf(buf, sizeof(buf), "{\"id\":\"!%08x\",\"snr\":%g,\"via_mqtt\":\"%s\",\"last_heard\":%u,\"position\":", node->num,
+             node->snr, BoolToString(node->via_mqtt), node->last_heard);
+    res->print(buf);
+
+    if (nodeDB->hasValidPosition(node)) {
+        snprintf(buf, sizeof(buf), "{\"latitude\":%.7f,\"longitude\":%.7f,\"altitude\":%d}",
+                 node->position.latitude_i * 1e-7, node->position.longitude_i * 1e-7, (int)node->position.altitude);
+        res->print(buf);
+    } else {
+        res->print("null");
+    }
+
+    res->print(",\"long_name\":");
+    printJsonString(res, node->user.long_name);
+    res->print(",\"short_name\":");
+    printJsonString(res, node->user.short_name);
+    snprintf(buf, sizeof(buf), ",\"mac_address\":\"%02X:%02X:%02X:%02X:%02X:%02X\",\"hw_model\":%d}", node->user.macaddr[0],
+             node->user.macaddr[1], node->user.macaddr[2], node->user.macaddr[3], node->user.macaddr[4],
+             node->user.macaddr[5], (int)node->user.hw_model);
+    res->print(buf);
+}
+
+/*
+    Node list, written straight from the NodeDB without building a JSON tree.
+
+    Optional query parameters:
+        content=json|binary  json (default) keeps the /json/nodes layout, binary writes one NodeInfo protobuf per
+                             node, each preceded by the same 0x94C3 + length header as the stream API
+        since=T              only nodes with last_heard > T, so dashboards can poll incrementally
+        offset=N, limit=M    page through the matching nodes, X-Next-Offset holds the offset of the next page (0 = done)
+*/
 void handleNodes(HTTPRequest *req, HTTPResponse *res)
 {
     ResourceParameters *params = req->getParams();
     std::string content;
+    std::string value;
 
     if (!params->getQueryParameter("content", content)) {
         content = "json";
     }
 
+    uint32_t since = 0, offset = 0, limit = 0;
+    if (params->getQueryParameter("since", value))
+        since = strtoul(value.c_str(), NULL, 10);
+    if (params->getQueryParameter("offset", value))
+        offset = strtoul(value.c_str(), NULL, 10);
+    if (params->getQueryParameter("limit", value))
+        limit = strtoul(value.c_str(), NULL, 10);
+
+    // Select the page first (pointers only) so the paging header can be sent ahead of the body
+    std::vector<const meshtastic_NodeInfoLite *> page;
+    bool more = false;
+    uint32_t matched = 0;
+    uint32_t readIndex = 0;
+    const meshtastic_NodeInfoLite *tempNodeInfo;
+    while ((tempNodeInfo = nodeDB->readNextMeshNode(readIndex)) != NULL) {
+        if (!tempNodeInfo->has_user || (since && tempNodeInfo->last_heard <= since))
+            continue;
+        if (matched++ < offset)
+            continue;
+        if (limit && page.size() == limit) {
+            more = true;
+            break;
+        }
+        page.push_back(tempNodeInfo);
+    }
+
+    res->setHeader("Access-Control-Allow-Origin", "*");
+    res->setHeader("Access-Control-Allow-Methods", "GET");
+    res->setHeader("Access-Control-Expose-Headers", "X-Next-Offset");
+    res->setHeader("X-Next-Offset", more ? std::to_string(offset + page.size()) : "0");
+
+    if (content == "binary") {
+        res->setHeader("Content-Type", "application/x-protobuf");
+        res->setHeader("X-Protobuf-Schema", "https://raw.githubusercontent.com/meshtastic/protobufs/master/meshtastic/mesh.proto");
+
+        uint8_t buf[4 + meshtastic_NodeInfo_size];
+        for (const meshtastic_NodeInfoLite *node : page) {
+            const meshtastic_NodeInfo info = TypeConversions::ConvertToNodeInfo(node);
+            size_t len = pb_encode_to_bytes(buf + 4, meshtastic_NodeInfo_size, &meshtastic_NodeInfo_msg, &info);
+            buf[0] = 0x94;
+            buf[1] = 0xc3;
+            buf[2] = (len >> 8) & 0xff;
+            buf[3] = len & 0xff;
+            res->write(buf, len + 4);
+        }
+        return;
+    }
+
     if (content == "json") {
         res->setHeader("Content-Type", "application/json");
-        res->setHeader("Access-Control-Allow-Origin", "*");
-        res->setHeader("Access-Control-Allow-Methods", "GET");
     } else {
         res->setHeader("Content-Type", "text/html");
         res->println("<pre>");
     }
 
-    JSONArray nodesArray;
-
-    uint32_t readIndex = 0;
-    const meshtastic_NodeInfoLite *tempNodeInfo = nodeDB->readNextMeshNode(readIndex);
-    while (tempNodeInfo != NULL) {
-        if (tempNodeInfo->has_user) {
-            JSONObject node;
-
-            char id[16];
-            snprintf(id, sizeof(id), "!%08x", tempNodeInfo->num);
-
-            node["id"] = new JSONValue(id);
-            node["snr"] = new JSONValue(tempNodeInfo->snr);
-            node["via_mqtt"] = new JSONValue(BoolToString(tempNodeInfo->via_mqtt));
-            node["last_heard"] = new JSONValue((int)tempNodeInfo->last_heard);
-            node["position"] = new JSONValue();
-
-            if (nodeDB->hasValidPosition(tempNodeInfo)) {
-                JSONObject position;
-                position["latitude"] = new JSONValue((float)tempNodeInfo->position.latitude_i * 1e-7);
-                position["longitude"] = new JSONValue((float)tempNodeInfo->position.longitude_i * 1e-7);
-                position["altitude"] = new JSONValue((int)tempNodeInfo->position.altitude);
-                node["position"] = new JSONValue(position);
-            }
-
-            node["long_name"] = new JSONValue(tempNodeInfo->user.long_name);
-            node["short_name"] = new JSONValue(tempNodeInfo->user.short_name);
-            char macStr[18];
-            snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X", tempNodeInfo->user.macaddr[0],
-                     tempNodeInfo->user.macaddr[1], tempNodeInfo->user.macaddr[2], tempNodeInfo->user.macaddr[3],
-                     tempNodeInfo->user.macaddr[4], tempNodeInfo->user.macaddr[5]);
-            node["mac_address"] = new JSONValue(macStr);
-            node["hw_model"] = new JSONValue(tempNodeInfo->user.hw_model);
-
-            nodesArray.push_back(new JSONValue(node));
-        }
-        tempNodeInfo = nodeDB->readNextMeshNode(readIndex);
+    res->print("{\"data\":{\"nodes\":[");
+    for (size_t i = 0; i < page.size(); i++) {
+        if (i)
+            res->print(",");
+        printNodeJson(res, page[i]);
     }
-
-    // collect data to inner data object
-    JSONObject jsonObjInner;
-    jsonObjInner["nodes"] = new JSONValue(nodesArray);
-
-    // create json output structure
-    JSONObject jsonObjOuter;
-    jsonObjOuter["data"] = new JSONValue(jsonObjInner);
-    jsonObjOuter["status"] = new JSONValue("ok");
-    // serialize and write it to the stream
-    JSONValue *value = new JSONValue(jsonObjOuter);
-    res->print(value->Stringify().c_str());
-    delete value;
+    res->print("]},\"status\":\"ok\"}");
 }
 
 /*
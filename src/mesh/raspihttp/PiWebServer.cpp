@@ -42,9 +42,11 @@ mail:   marchammermann@googlemail.com
 #include "PowerFSM.h"
 #include "RadioLibInterface.h"
 #include "airtime.h"
+#include "concurrency/NotifiedWorkerThread.h"
 #include "graphics/Screen.h"
 #include "main.h"
 #include "mesh/wifi/WiFiAPClient.h"
+#include "serialization/AirtimeSerializer.h"
 #include "sleep.h"
 #include <openssl/bn.h>
 #include <openssl/evp.h>
@@ -56,8 +58,15 @@ mail:   marchammermann@googlemail.com
 #include <ulfius.h>
 #include <yder.h>
 
+#include <algorithm>
+#include <future>
+#include <chrono>
 #include <cstring>
+#include <memory>
 #include <string>
+#include <sys/stat.h>
+#include <unordered_map>
+#include <vector>
 
 #include "PortduinoFS.h"
 #include "platform/portduino/PortduinoGlue.h"
@@ -126,6 +135,159 @@ static void callback_static_file_stream_free(void *cls)
     }
 }
 
+/**
+ * One file held by the static asset cache
+ */
+struct CachedAsset {
+    time_t mtime;
+    off_t size;
+    std::string etag;
+    std::shared_ptr<const std::string> data;
+};
+
+static std::mutex assetCacheLock;
+static std::unordered_map<std::string, CachedAsset> assetCache; // keyed by on disk path, including any .br/.gz suffix
+static size_t assetCacheBytes = 0;
+
+/// Precompressed siblings we look for, in order of preference
+static const struct {
+    const char *suffix;
+    const char *encoding;
+} compressedVariants[] = {{".br", "br"}, {".gz", "gzip"}};
+
+/**
+ * Return true if the Accept-Encoding header lists this content coding (and doesn't disable it with q=0)
+ */
+static bool accepts_encoding(const char *acceptEncoding, const char *coding)
+{
+    const size_t codingLen = strlen(coding);
+    const char *p = acceptEncoding;
+    while (p && *p) {
+        while (*p == ' ' || *p == ',')
+            p++;
+        const char *end = p + strcspn(p, ",");
+        const size_t tokenLen = strcspn(p, ";, ");
+        if (tokenLen == codingLen && strncasecmp(p, coding, codingLen) == 0) {
+            const char *q = strstr(p, "q=");
+            return !(q && q < end && strtod(q + 2, NULL) == 0);
+        }
+        p = end;
+    }
+    return false;
+}
+
+/**
+ * Return true if path resolves to somewhere inside the web root, so a symlink can't be used to serve any other file
+ */
+static bool is_inside_files_path(const char *path)
+{
+    char *real_path = realpath(path, NULL);
+    const bool inside = real_path != NULL && 0 == o_strncmp(configWeb.files_path, real_path, o_strlen(configWeb.files_path));
+    free(real_path); // realpath uses malloc
+    return inside;
+}
+
+/**
+ * Load a file into the asset cache (or find the still valid cached copy)
+ * Returns false if the file can't be read or is too large to be cached.
+ */
+static bool load_cached_asset(const std::string &path, const struct stat &st, CachedAsset &asset)
+{
+    if (st.st_size > STATIC_CACHE_MAX_FILE)
+        return false;
+
+    {
+        std::lock_guard<std::mutex> guard(assetCacheLock);
+        auto it = assetCache.find(path);
+        if (it != assetCache.end() && it->second.mtime == st.st_mtime && it->second.size == st.st_size) {
+            asset = it->second;
+            return true;
+        }
+    }
+
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f)
+        return false;
+    std::string *data = new std::string(st.st_size, '\0');
+    size_t readSize = fread(&(*data)[0], 1, st.st_size, f);
+    fclose(f);
+    if (readSize != (size_t)st.st_size) {
+        delete data;
+        return false;
+    }
+
+    asset.mtime = st.st_mtime;
+    asset.size = st.st_size;
+    asset.data.reset(data);
+    char etag[48];
+    snprintf(etag, sizeof(etag), "\"%lx-%lx\"", (unsigned long)st.st_size, (unsigned long)st.st_mtime);
+    asset.etag = etag;
+
+    std::lock_guard<std::mutex> guard(assetCacheLock);
+    auto it = assetCache.find(path);
+    if (it != assetCache.end()) {
+        assetCacheBytes -= it->second.size;
+        assetCache.erase(it);
+    }
+    // Make room, the web UI is small enough that we rarely get here
+    while (!assetCache.empty() && assetCacheBytes + asset.size > STATIC_CACHE_MAX_BYTES) {
+        assetCacheBytes -= assetCache.begin()->second.size;
+        assetCache.erase(assetCache.begin());
+    }
+    assetCache[path] = asset;
+    assetCacheBytes += asset.size;
+    return true;
+}
+
+/**
+ * Serve a static file from the in memory asset cache, preferring a precompressed .br/.gz sibling the client accepts.
+ * Answers If-None-Match with 304 when the ETag still matches.
+ * Returns false if the file should be streamed from disk instead.
+ */
+static bool serve_static_file_cached(const struct _u_request *request, struct _u_response *response, const char *file_path)
+{
+    const char *acceptEncoding = u_map_get_case(request->map_header, "Accept-Encoding");
+    const char *encoding = NULL;
+    std::string path;
+    struct stat st;
+
+    if (acceptEncoding) {
+        for (const auto &variant : compressedVariants) {
+            path = std::string(file_path) + variant.suffix;
+            // The requested file was checked by our caller, its sibling could still be a symlink out of the web root
+            if (accepts_encoding(acceptEncoding, variant.encoding) && stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode) &&
+                is_inside_files_path(path.c_str())) {
+                encoding = variant.encoding;
+                break;
+            }
+        }
+    }
+    if (!encoding) {
+        path = file_path;
+        if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+            return false;
+    }
+
+    CachedAsset asset;
+    if (!load_cached_asset(path, st, asset))
+        return false;
+
+    ulfius_add_header_to_response(response, "ETag", asset.etag.c_str());
+    ulfius_add_header_to_response(response, "Cache-Control", "no-cache"); // always revalidate, answered with a cheap 304
+    ulfius_add_header_to_response(response, "Vary", "Accept-Encoding");
+    if (encoding)
+        ulfius_add_header_to_response(response, "Content-Encoding", encoding);
+
+    const char *ifNoneMatch = u_map_get_case(request->map_header, "If-None-Match");
+    if (ifNoneMatch && (strstr(ifNoneMatch, asset.etag.c_str()) || strcmp(ifNoneMatch, "*") == 0)) {
+        response->status = 304;
+        return true;
+    }
+
+    ulfius_set_binary_body_response(response, 200, asset.data->data(), asset.data->size());
+    return true;
+}
+
 /**
  * static file callback endpoint that delivers the content for WebServer calls
  */
@@ -170,23 +332,26 @@ int callback_static_file(const struct _u_request *request, struct _u_response *r
         real_path = realpath(file_path, NULL);
         if (0 == o_strncmp(configWeb.files_path, real_path, o_strlen(configWeb.files_path))) {
             if (access(file_path, F_OK) != -1) {
-                f = fopen(file_path, "rb");
-                if (f) {
-                    fseek(f, 0, SEEK_END);
-                    length = ftell(f);
-                    fseek(f, 0, SEEK_SET);
-
-                    content_type = u_map_get_case(&configWeb.mime_types, get_filename_ext(file_requested));
-                    if (content_type == NULL) {
-                        content_type = u_map_get(&configWeb.mime_types, "*");
-                        LOG_DEBUG("Static File Server - Unknown mime type for extension %s ", get_filename_ext(file_requested));
-                    }
-                    u_map_put(response->map_header, "Content-Type", content_type);
-                    u_map_copy_into(response->map_header, &configWeb.map_header);
-
-                    if (ulfius_set_stream_response(response, 200, callback_static_file_stream, callback_static_file_stream_free,
-                                                   length, STATIC_FILE_CHUNK, f) != U_OK) {
-                        LOG_DEBUG("callback_static_file - Error ulfius_set_stream_response");
+                content_type = u_map_get_case(&configWeb.mime_types, get_filename_ext(file_requested));
+                if (content_type == NULL) {
+                    content_type = u_map_get(&configWeb.mime_types, "*");
+                    LOG_DEBUG("Static File Server - Unknown mime type for extension %s ", get_filename_ext(file_requested));
+                }
+                u_map_put(response->map_header, "Content-Type", content_type);
+                u_map_copy_into(response->map_header, &configWeb.map_header);
+
+                // Too large for the cache, stream it from disk
+                if (!serve_static_file_cached(request, response, file_path)) {
+                    f = fopen(file_path, "rb");
+                    if (f) {
+                        fseek(f, 0, SEEK_END);
+                        length = ftell(f);
+                        fseek(f, 0, SEEK_SET);
+
+                        if (ulfius_set_stream_response(response, 200, callback_static_file_stream,
+                                                       callback_static_file_stream_free, length, STATIC_FILE_CHUNK, f) != U_OK) {
+                            LOG_DEBUG("callback_static_file - Error ulfius_set_stream_response");
+                        }
                     }
                 }
             } else {
@@ -218,6 +383,156 @@ int callback_static_file(const struct _u_request *request, struct _u_response *r
 
 static void handleWebResponse() {}
 
+/**
+ * Runs work from the ulfius connection threads on the main loop.
+ * Observables, the router and MeshService are only ever used from there, so a ToRadio from a connection thread, and the
+ * observe()/unobserve() that want_config, disconnect or deleting a WebSocketAPI bring, are queued up for us.
+ */
+class WebServerMainLoopTasks : public concurrency::NotifiedWorkerThread
+{
+  public:
+    WebServerMainLoopTasks() : NotifiedWorkerThread("WebServerTasks") {}
+
+    /// Callable from any thread, tasks run in the order they were posted
+    void post(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> guard(tasksLock);
+            tasks.push_back(std::move(task));
+        }
+        notify(1, true);
+    }
+
+  protected:
+    virtual void onNotify(uint32_t notification) override
+    {
+        std::vector<std::function<void()>> pending;
+        {
+            std::lock_guard<std::mutex> guard(tasksLock);
+            pending.swap(tasks);
+        }
+        for (auto &task : pending)
+            task();
+    }
+
+  private:
+    std::mutex tasksLock;
+    std::vector<std::function<void()>> tasks;
+};
+
+static WebServerMainLoopTasks *mainLoopTasks;
+
+size_t HttpAPI::getFromRadioLocked(uint8_t *buf)
+{
+    std::lock_guard<std::recursive_mutex> guard(apiLock);
+    return getFromRadio(buf);
+}
+
+void HttpAPI::queueToRadio(const uint8_t *buf, size_t len)
+{
+    std::string toRadio((const char *)buf, len);
+    mainLoopTasks->post([this, toRadio]() {
+        {
+            std::lock_guard<std::recursive_mutex> guard(apiLock);
+            handleToRadio((const uint8_t *)toRadio.data(), toRadio.size());
+        }
+        // e.g. want_config_id makes data available without PhoneAPI notifying us
+        signalData();
+    });
+}
+
+void HttpAPI::signalData()
+{
+    {
+        std::lock_guard<std::mutex> guard(dataLock);
+        dataSeq++;
+    }
+    dataReady.notify_all();
+}
+
+void HttpAPI::onNowHasData(uint32_t fromRadioNum)
+{
+    signalData();
+}
+
+int HttpAPI::onNotify(uint32_t newValue)
+{
+    std::lock_guard<std::recursive_mutex> guard(apiLock);
+    return PhoneAPI::onNotify(newValue);
+}
+
+bool HttpAPI::waitForData(uint32_t timeoutMsec, bool drained)
+{
+    std::unique_lock<std::mutex> lock(dataLock);
+    const uint32_t seen = dataSeq;
+    lock.unlock();
+
+    if (!drained) {
+        // During the config download PhoneAPI has data without ever notifying us
+        std::lock_guard<std::recursive_mutex> guard(apiLock);
+        if (available())
+            return true;
+    }
+
+    lock.lock();
+    return dataReady.wait_for(lock, std::chrono::milliseconds(timeoutMsec), [&] { return dataSeq != seen; });
+}
+
+/**
+ * State of one streaming fromradio request
+ */
+struct FromRadioStream {
+    HttpAPI *api;
+    uint32_t startMsec;
+    uint8_t buf[MAX_STREAM_BUF_SIZE];
+    size_t len = 0; // bytes of the current frame in buf
+    size_t pos = 0; // bytes of the current frame already handed to ulfius
+};
+
+/**
+ * Streaming callback for fromradio?stream=true. Uses the same 0x94C3 + length framing as StreamAPI, so clients can reuse
+ * their serial/TCP parser. Runs in the ulfius connection thread, so it is allowed to block while waiting for data.
+ */
+static ssize_t callback_fromradio_stream(void *cls, uint64_t pos, char *buf, size_t max)
+{
+    (void)(pos);
+    FromRadioStream *stream = (FromRadioStream *)cls;
+
+    // Returning 0 makes ulfius call us straight back, so wait here until there is a frame to hand over
+    bool drained = false;
+    while (stream->pos == stream->len) {
+        if (millis() - stream->startMsec > FROMRADIO_STREAM_HOLD_MSEC)
+            return U_STREAM_END; // Let the client reconnect, so dead connections don't pile up
+
+        if (!stream->api->waitForData(FROMRADIO_STREAM_WAIT_MSEC, drained)) {
+            drained = false; // Look at available() again now and then, the config download never notifies
+            continue;
+        }
+
+        size_t len = stream->api->getFromRadioLocked(stream->buf + 4);
+        drained = len == 0;
+        if (drained)
+            continue;
+
+        stream->buf[0] = 0x94;
+        stream->buf[1] = 0xc3;
+        stream->buf[2] = (len >> 8) & 0xff;
+        stream->buf[3] = len & 0xff;
+        stream->len = len + 4;
+        stream->pos = 0;
+    }
+
+    size_t n = std::min(max, stream->len - stream->pos);
+    memcpy(buf, stream->buf + stream->pos, n);
+    stream->pos += n;
+    return n;
+}
+
+static void callback_fromradio_stream_free(void *cls)
+{
+    delete (FromRadioStream *)cls;
+}
+
 /*
  * Adapt the radioapi to the Webservice handleAPIv1ToRadio
  * Trigger : WebGui(SAVE)->WebServcice->phoneApi
@@ -248,7 +563,7 @@ int handleAPIv1ToRadio(const struct _u_request *req, struct _u_response *res, vo
     portduinoVFS->mountpoint(configWeb.rootPath);
 
     LOG_DEBUG("Received %d bytes from PUT request", s);
-    static_cast<HttpAPI *>(user_data)->handleToRadio(buffer, s);
+    static_cast<HttpAPI *>(user_data)->queueToRadio(buffer, s);
     LOG_DEBUG("end web->radio  ");
     return U_CALLBACK_COMPLETE;
 }
@@ -256,12 +571,17 @@ int handleAPIv1ToRadio(const struct _u_request *req, struct _u_response *res, vo
 /*
  * Adapt the radioapi to the Webservice handleAPIv1FromRadio
  * Trigger : WebGui(POLL)->handleAPIv1FromRadio->phoneapi->Meshtastic(Radio) events
+ *
+ * ?all=true returns every queued protobuf back to back, ?stream=true holds the connection open and pushes framed
+ * FromRadio messages (see callback_fromradio_stream) as they become available.
  */
 int handleAPIv1FromRadio(const struct _u_request *req, struct _u_response *res, void *user_data)
 {
 
     // LOG_DEBUG("handleAPIv1FromRadio radio -> web");
-    std::string valueAll;
+    HttpAPI *api = static_cast<HttpAPI *>(user_data);
+    const char *valueAll = u_map_get(req->map_url, "all");
+    const char *valueStream = u_map_get(req->map_url, "stream");
 
     // Status code is 200 OK by default.
     ulfius_add_header_to_response(res, "Content-Type", "application/x-protobuf");
@@ -278,19 +598,25 @@ int handleAPIv1FromRadio(const struct _u_request *req, struct _u_response *res,
     uint8_t txBuf[MAX_STREAM_BUF_SIZE];
     uint32_t len = 1;
 
-    if (valueAll == "true") {
-        while (len) {
-            len = static_cast<HttpAPI *>(user_data)->getFromRadio(txBuf);
-            ulfius_set_response_properties(res, U_OPT_STATUS, 200, U_OPT_BINARY_BODY, txBuf, len);
-            const char *tmpa = (const char *)txBuf;
-            ulfius_set_string_body_response(res, 200, tmpa);
-            // LOG_DEBUG("\n----webAPI response all:----");
-            // LOG_DEBUG(tmpa);
-            // LOG_DEBUG("");
+    if (valueStream && strcmp(valueStream, "true") == 0) {
+        FromRadioStream *stream = new FromRadioStream;
+        stream->api = api;
+        stream->startMsec = millis();
+        ulfius_add_header_to_response(res, "Cache-Control", "no-cache");
+        if (ulfius_set_stream_response(res, 200, callback_fromradio_stream, callback_fromradio_stream_free,
+                                       U_STREAM_SIZE_UNKNOWN, MAX_STREAM_BUF_SIZE, stream) != U_OK) {
+            LOG_DEBUG("handleAPIv1FromRadio - Error ulfius_set_stream_response");
+            delete stream;
+            return U_CALLBACK_ERROR;
         }
+    } else if (valueAll && strcmp(valueAll, "true") == 0) {
+        std::string body;
+        while ((len = api->getFromRadioLocked(txBuf)) != 0)
+            body.append((const char *)txBuf, len);
+        ulfius_set_binary_body_response(res, 200, body.data(), body.size());
         // Otherwise, just return one protobuf
     } else {
-        len = static_cast<HttpAPI *>(user_data)->getFromRadio(txBuf);
+        len = api->getFromRadioLocked(txBuf);
         const char *tmpa = (const char *)txBuf;
         ulfius_set_binary_body_response(res, 200, tmpa, len);
         // LOG_DEBUG("\n----webAPI response:");
@@ -302,6 +628,120 @@ int handleAPIv1FromRadio(const struct _u_request *req, struct _u_response *res,
     return U_CALLBACK_COMPLETE;
 }
 
+/*
+ * Channel utilization and the senders and portnums using the most airtime, in the shape of data->airtime of the ESP32
+ * /json/report
+ */
+int handleJsonAirtime(const struct _u_request *req, struct _u_response *res, void *user_data)
+{
+    ulfius_add_header_to_response(res, "Content-Type", "application/json");
+    ulfius_add_header_to_response(res, "Access-Control-Allow-Methods", "GET");
+
+    // AirTime is only updated from the main loop, so take the snapshot there
+    auto report = std::make_shared<std::promise<std::string>>();
+    std::future<std::string> body = report->get_future();
+    mainLoopTasks->post([report]() {
+        JSONObject jsonObjAirtime;
+        jsonObjAirtime["channel_utilization"] = new JSONValue(airTime->channelUtilizationPercent());
+        jsonObjAirtime["utilization_tx"] = new JSONValue(airTime->utilizationTXPercent());
+        jsonObjAirtime["seconds_per_period"] = new JSONValue(int(airTime->getSecondsPerPeriod()));
+        AirtimeSerializer::addTopTalkers(jsonObjAirtime);
+
+        JSONObject jsonObjInner;
+        jsonObjInner["airtime"] = new JSONValue(jsonObjAirtime);
+        JSONObject jsonObjOuter;
+        jsonObjOuter["data"] = new JSONValue(jsonObjInner);
+        jsonObjOuter["status"] = new JSONValue("ok");
+        JSONValue *value = new JSONValue(jsonObjOuter);
+        report->set_value(value->Stringify());
+        delete value;
+    });
+
+    if (body.wait_for(std::chrono::seconds(5)) != std::future_status::ready) {
+        ulfius_set_string_body_response(res, 503, "{\"status\":\"Error\"}");
+        return U_CALLBACK_COMPLETE;
+    }
+    ulfius_set_string_body_response(res, 200, body.get().c_str());
+    return U_CALLBACK_COMPLETE;
+}
+
+#ifndef U_DISABLE_WEBSOCKET
+/**
+ * Runs in its own thread for the lifetime of the websocket, pushing FromRadio protobufs to the client as they become available
+ */
+static void websocket_fromradio_manager(const struct _u_request *request, struct _websocket_manager *manager, void *user_data)
+{
+    (void)(request);
+    WebSocketAPI *api = static_cast<WebSocketAPI *>(user_data);
+    uint8_t txBuf[MAX_STREAM_BUF_SIZE];
+
+    bool drained = false;
+    while (ulfius_websocket_status(manager) == U_WEBSOCKET_STATUS_OPEN) {
+        if (!api->waitForData(FROMRADIO_STREAM_WAIT_MSEC, drained)) {
+            drained = false;
+            continue;
+        }
+
+        size_t len;
+        drained = true; // Unless we get something, don't trust available() until the next notification
+        while ((len = api->getFromRadioLocked(txBuf)) != 0) {
+            drained = false;
+            if (ulfius_websocket_send_message(manager, U_WEBSOCKET_OPCODE_BINARY, len, (const char *)txBuf) != U_OK) {
+                LOG_DEBUG("websocket_fromradio_manager - Error sending message");
+                break;
+            }
+        }
+    }
+    api->setOpen(false);
+}
+
+/**
+ * Each binary websocket message is one ToRadio protobuf
+ */
+static void websocket_toradio_incoming(const struct _u_request *request, struct _websocket_manager *manager,
+                                       const struct _websocket_message *message, void *user_data)
+{
+    (void)(request);
+    (void)(manager);
+    if (message->opcode != U_WEBSOCKET_OPCODE_BINARY)
+        return;
+    if (message->data_len > MAX_TO_FROM_RADIO_SIZE) {
+        LOG_WARN("Websocket ToRadio message too large (%u bytes), drop", message->data_len);
+        return;
+    }
+    static_cast<WebSocketAPI *>(user_data)->queueToRadio((const uint8_t *)message->data, message->data_len);
+}
+
+static void websocket_onclose(const struct _u_request *request, struct _websocket_manager *manager, void *user_data)
+{
+    (void)(request);
+    (void)(manager);
+    LOG_INFO("Websocket API client disconnected");
+    WebSocketAPI *api = static_cast<WebSocketAPI *>(user_data);
+    api->setOpen(false);
+    // After any ToRadio still queued for it
+    mainLoopTasks->post([api]() { delete api; });
+}
+
+/*
+ * Full duplex alternative to handleAPIv1FromRadio/handleAPIv1ToRadio: every websocket gets its own PhoneAPI instance
+ */
+int handleAPIv1WebSocket(const struct _u_request *req, struct _u_response *res, void *user_data)
+{
+    (void)(user_data);
+    LOG_INFO("Websocket API client connected");
+
+    WebSocketAPI *api = new WebSocketAPI();
+    if (ulfius_set_websocket_response(res, NULL, NULL, &websocket_fromradio_manager, api, &websocket_toradio_incoming, api,
+                                      &websocket_onclose, api) != U_OK) {
+        LOG_ERROR("handleAPIv1WebSocket - Error ulfius_set_websocket_response");
+        delete api;
+        return U_CALLBACK_ERROR;
+    }
+    return U_CALLBACK_COMPLETE;
+}
+#endif
+
 /*
 OpenSSL RSA Key Gen
 */
@@ -466,6 +906,9 @@ PiWebServerThread::PiWebServerThread()
         webservport = 9443;
     }
 
+    // Created here, on the main loop, before any connection thread can post to it
+    mainLoopTasks = new WebServerMainLoopTasks();
+
     // Web Content Service Instance
     if (ulfius_init_instance(&instanceWeb, webservport, NULL, DEFAULT_REALM) != U_OK) {
         LOG_ERROR("Webserver couldn't be started, abort execution");
@@ -503,6 +946,10 @@ PiWebServerThread::PiWebServerThread()
         ulfius_add_endpoint_by_val(&instanceWeb, "OPTIONS", PREFIX, "/api/v1/fromradio/*", 1, &handleAPIv1FromRadio, &webAPI);
         ulfius_add_endpoint_by_val(&instanceWeb, "PUT", PREFIX, "/api/v1/toradio/*", 1, &handleAPIv1ToRadio, &webAPI);
         ulfius_add_endpoint_by_val(&instanceWeb, "OPTIONS", PREFIX, "/api/v1/toradio/*", 1, &handleAPIv1ToRadio, &webAPI);
+        ulfius_add_endpoint_by_val(&instanceWeb, "GET", PREFIX, "/json/airtime", 1, &handleJsonAirtime, NULL);
+#ifndef U_DISABLE_WEBSOCKET
+        ulfius_add_endpoint_by_val(&instanceWeb, "GET", PREFIX, "/api/v1/ws", 1, &handleAPIv1WebSocket, NULL);
+#endif
 
         // Add callback function to all endpoints for the Web Server
         ulfius_add_endpoint_by_val(&instanceWeb, "GET", NULL, "/*", 2, &callback_static_file, &configWeb);
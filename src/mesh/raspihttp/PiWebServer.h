@@ -5,9 +5,21 @@
 #include "ulfius-cfg.h"
 #include "ulfius.h"
 #include <Arduino.h>
+#include <atomic>
+#include <condition_variable>
 #include <functional>
+#include <mutex>
 
 #define STATIC_FILE_CHUNK 256
+// Files larger than this are streamed from disk instead of being held in the asset cache
+#define STATIC_CACHE_MAX_FILE (2 * 1024 * 1024)
+// Total size of the in memory asset cache
+#define STATIC_CACHE_MAX_BYTES (16 * 1024 * 1024)
+
+// How long a streaming fromradio request is held open before the client has to reconnect
+#define FROMRADIO_STREAM_HOLD_MSEC (30 * 1000)
+// How long a single wait for new fromradio data blocks the connection thread
+#define FROMRADIO_STREAM_WAIT_MSEC 1000
 
 void initWebServer();
 void createSSLCert();
@@ -27,16 +39,63 @@ class HttpAPI : public PhoneAPI
 {
 
   public:
-    // Nothing here yet
+    /// getFromRadio() serialized against the other ulfius connection threads
+    size_t getFromRadioLocked(uint8_t *buf);
+
+    /**
+     * Hand a ToRadio protobuf to handleToRadio() on the main loop. Callable from the ulfius connection threads, which must
+     * not observe MeshService or send packets themselves.
+     */
+    void queueToRadio(const uint8_t *buf, size_t len);
+
+    /**
+     * Block the calling (ulfius connection) thread until PhoneAPI has something for us to send, or timeoutMsec passed.
+     * Pass drained if the last getFromRadioLocked() came back empty even though data was reported, so we wait for the next
+     * notification instead of trusting available() again.
+     * @return true if data is available
+     */
+    bool waitForData(uint32_t timeoutMsec, bool drained = false);
 
   private:
-    // Nothing here yet
+    // Held for anything touching PhoneAPI state, from the connection threads and from the main loop (onNotify).
+    // Recursive because sending a ToRadio packet can deliver to the phone, and notify us, before returning.
+    std::recursive_mutex apiLock;
+    std::mutex dataLock;
+    std::condition_variable dataReady;
+    uint32_t dataSeq = 0; // bumped each time waiters should look for new data
+
+    void signalData();
 
   protected:
     /// Check the current underlying physical link to see if the client is currently connected
     virtual bool checkIsConnected() override { return true; } // FIXME, be smarter about this
+
+    /// Wake up any streaming fromradio requests
+    virtual void onNowHasData(uint32_t fromRadioNum) override;
+
+    /// Called by MeshService on the main loop, can close the connection underneath a connection thread unless locked
+    virtual int onNotify(uint32_t newValue) override;
 };
 
+#ifndef U_DISABLE_WEBSOCKET
+/**
+ * The PhoneAPI of a single websocket connection. ToRadio and FromRadio protobufs are carried one per binary message.
+ * Created by handleAPIv1WebSocket(), and deleted on the main loop once the websocket is closed, since deleting a PhoneAPI
+ * stops it observing MeshService.
+ */
+class WebSocketAPI : public HttpAPI
+{
+  public:
+    void setOpen(bool isOpen) { open = isOpen; }
+
+  private:
+    std::atomic<bool> open{true};
+
+  protected:
+    virtual bool checkIsConnected() override { return open; }
+};
+#endif
+
 class PiWebServerThread
 {
   private:
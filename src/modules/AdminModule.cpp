@@ -346,6 +346,7 @@ bool AdminModule::handleReceivedProtobuf(const meshtastic_MeshPacket &mp, meshta
             node->is_ignored = true;
             node->has_device_metrics = false;
             node->has_position = false;
+            nodeDB->reindexPosition(node);
             node->user.public_key.size = 0;
             node->user.public_key.bytes[0] = 0;
             saveChanges(SEGMENT_NODEDATABASE, false);
@@ -366,6 +367,7 @@ bool AdminModule::handleReceivedProtobuf(const meshtastic_MeshPacket &mp, meshta
         meshtastic_NodeInfoLite *node = nodeDB->getMeshNode(nodeDB->getNodeNum());
         node->has_position = true;
         node->position = TypeConversions::ConvertToPositionLite(r->set_fixed_position);
+        nodeDB->reindexPosition(node);
         nodeDB->setLocalPosition(r->set_fixed_position);
         config.position.fixed_position = true;
         saveChanges(SEGMENT_NODEDATABASE | SEGMENT_CONFIG, false);
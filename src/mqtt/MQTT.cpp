@@ -4,6 +4,8 @@
 #include "PowerFSM.h"
 #include "ServiceEnvelope.h"
 #include "configuration.h"
+#include "gps/GeoCoord.h"
+#include "gps/RTC.h"
 #include "main.h"
 #include "mesh/Channels.h"
 #include "mesh/Router.h"
@@ -31,6 +33,7 @@
 #include <Throttle.h>
 #include <assert.h>
 #include <utility>
+#include <vector>
 
 #include <IPAddress.h>
 #if defined(ARCH_PORTDUINO)
@@ -51,14 +54,38 @@ static uint8_t bytes[meshtastic_MqttClientProxyMessage_size + 30]; // 12 for cha
 
 static bool isMqttServerAddressPrivate = false;
 
-inline void onReceiveProto(char *topic, byte *payload, size_t length)
+// Channel encrypted downlink waiting to be decrypted, collected while reading so a burst is decrypted as one batch
+constexpr size_t downlinkBatchMax = 16;
+static std::vector<meshtastic_MeshPacket *> pendingDownlink;
+
+static void decodePendingDownlink()
+{
+    if (pendingDownlink.empty())
+        return;
+    std::vector<DecodeState> results(pendingDownlink.size());
+    perhapsDecodeBatch(pendingDownlink.data(), pendingDownlink.size(), results.data());
+    for (size_t i = 0; i < pendingDownlink.size(); i++) {
+        if (router && results[i] == DecodeState::DECODE_SUCCESS)
+            router->enqueueReceivedMessage(pendingDownlink[i]);
+        else
+            packetPool.release(pendingDownlink[i]); // ignore messages if we don't have the channel key
+    }
+    pendingDownlink.clear();
+}
+
+inline void onReceiveProto(char *topic, byte *payload, size_t length, const TopicTrie::Match &match)
 {
     const DecodedServiceEnvelope e(payload, length);
     if (!e.validDecode || e.channel_id == NULL || e.gateway_id == NULL || e.packet == NULL) {
         LOG_ERROR("Invalid MQTT service envelope, topic %s, len %u!", topic, length);
         return;
     }
-    const meshtastic_Channel &ch = channels.getByName(e.channel_id);
+    // The envelope's channel_id decides the channel, not the topic it arrived on. The topic trie already resolved the
+    // channel for topics we subscribed to, so only look it up by name when channel_id names another channel or the topic is
+    // one we didn't subscribe to (e.g. forwarded by a client proxy)
+    const bool topicMatchesEnvelope =
+        match.kind == TopicTrie::Kind::ENCRYPTED && strcmp(e.channel_id, channels.getGlobalId(match.channel)) == 0;
+    const meshtastic_Channel &ch = topicMatchesEnvelope ? channels.getByIndex(match.channel) : channels.getByName(e.channel_id);
     if (strcmp(e.gateway_id, owner.id) == 0) {
         // Generate an implicit ACK towards ourselves (handled and processed only locally!) for this message.
         // We do this because packets are not rebroadcasted back into MQTT anymore and we assume that at least one node
@@ -115,11 +142,16 @@ inline void onReceiveProto(char *topic, byte *payload, size_t length)
         const meshtastic_NodeInfoLite *rx = nodeDB->getMeshNode(p->to);
         // Only accept PKI messages to us, or if we have both the sender and receiver in our nodeDB, as then it's
         // likely they discovered each other via a channel we have downlink enabled for
-        if (isToUs(p.get()) || (tx && tx->has_user && rx && rx->has_user))
+        if (isToUs(p.get()) || (tx && tx->has_user && rx && rx->has_user)) {
+            decodePendingDownlink(); // keep the order packets arrived in
             router->enqueueReceivedMessage(p.release());
-    } else if (router &&
-               perhapsDecode(p.get()) == DecodeState::DECODE_SUCCESS) // ignore messages if we don't have the channel key
+        }
+    } else if (router && p->which_payload_variant == meshtastic_MeshPacket_encrypted_tag) {
+        pendingDownlink.push_back(p.release()); // decrypted by decodePendingDownlink()
+    } else if (router && perhapsDecode(p.get()) == DecodeState::DECODE_SUCCESS) {
+        decodePendingDownlink();
         router->enqueueReceivedMessage(p.release());
+    }
 }
 
 #if !defined(ARCH_NRF52) || NRF52_USE_JSON
@@ -337,6 +369,7 @@ void MQTT::mqttCallback(char *topic, byte *payload, unsigned int length)
 void MQTT::onClientProxyReceive(meshtastic_MqttClientProxyMessage msg)
 {
     onReceive(msg.topic, msg.payload_variant.data.bytes, msg.payload_variant.data.size);
+    decodePendingDownlink();
 }
 
 void MQTT::onReceive(char *topic, byte *payload, size_t length)
@@ -346,16 +379,13 @@ void MQTT::onReceive(char *topic, byte *payload, size_t length)
         return;
     }
 
-    // check if this is a json payload message by comparing the topic start
-    if (moduleConfig.mqtt.json_enabled && (strncmp(topic, jsonTopic.c_str(), jsonTopic.length()) == 0)) {
+    const TopicTrie::Match match = topics.match(topic);
+
+    // check if this is a json payload message
+    if (moduleConfig.mqtt.json_enabled && match.kind == TopicTrie::Kind::JSON) {
 #if !defined(ARCH_NRF52) || NRF52_USE_JSON
-        // parse the channel name from the topic string
-        // the topic has been checked above for having jsonTopic prefix, so just move past it
-        char *channelName = topic + jsonTopic.length();
-        // if another "/" was added, parse string up to that character
-        channelName = strtok(channelName, "/") ? strtok(channelName, "/") : channelName;
         // We allow downlink JSON packets only on a channel named "mqtt"
-        const meshtastic_Channel &sendChannel = channels.getByName(channelName);
+        const meshtastic_Channel &sendChannel = channels.getByIndex(match.channel);
         if (!(strncasecmp(channels.getGlobalId(sendChannel.index), Channels::mqttChannel, strlen(Channels::mqttChannel)) == 0 &&
               sendChannel.settings.downlink_enabled)) {
             LOG_WARN("JSON downlink received on channel not called 'mqtt' or without downlink enabled");
@@ -366,7 +396,7 @@ void MQTT::onReceive(char *topic, byte *payload, size_t length)
         return;
     }
 
-    onReceiveProto(topic, payload, length);
+    onReceiveProto(topic, payload, length, match);
 }
 
 void mqttInit()
@@ -392,13 +422,16 @@ MQTT::MQTT() : concurrency::OSThread("mqtt"), mqttQueue(MAX_MQTT_QUEUE)
             cryptTopic = moduleConfig.mqtt.root + cryptTopic;
             jsonTopic = moduleConfig.mqtt.root + jsonTopic;
             mapTopic = moduleConfig.mqtt.root + mapTopic;
+            mapBatchTopic = moduleConfig.mqtt.root + mapBatchTopic;
             isConfiguredForDefaultRootTopic = isDefaultRootTopic(moduleConfig.mqtt.root);
         } else {
             cryptTopic = "msh" + cryptTopic;
             jsonTopic = "msh" + jsonTopic;
             mapTopic = "msh" + mapTopic;
+            mapBatchTopic = "msh" + mapBatchTopic;
             isConfiguredForDefaultRootTopic = true;
         }
+        rebuildTopics();
 
         if (moduleConfig.mqtt.map_reporting_enabled && moduleConfig.mqtt.has_map_report_settings) {
             map_position_precision = Default::getConfiguredOrDefault(moduleConfig.mqtt.map_report_settings.position_precision,
@@ -525,22 +558,52 @@ void MQTT::reconnect()
     }
 }
 
+void MQTT::rebuildTopics()
+{
+    topics.clear();
+    channelTopics.clear();
+
+    pkiTopic = cryptTopic + "PKI/+";
+    // Inserted first so that a channel named "PKI" can't shadow it, same as the check order in onReceiveProto()
+    topics.insert(pkiTopic, {TopicTrie::Kind::PKI, 0});
+
+    size_t numChan = channels.getNumChannels();
+    channelTopics.reserve(numChan);
+    for (size_t i = 0; i < numChan; i++) {
+        const char *channelId = channels.getGlobalId(i);
+        ChannelTopics t;
+        t.crypt = cryptTopic + channelId + "/+";
+        t.json = jsonTopic + channelId + "/+";
+        topics.insert(t.crypt, {TopicTrie::Kind::ENCRYPTED, (uint8_t)i});
+        topics.insert(t.json, {TopicTrie::Kind::JSON, (uint8_t)i});
+        channelTopics.push_back(std::move(t));
+    }
+}
+
+void MQTT::onChannelsChanged()
+{
+    rebuildTopics();
+    // Subscribing again to a topic is harmless, and picks up newly downlink enabled channels without a reconnect
+    if (isConnectedDirectly())
+        sendSubscriptions();
+}
+
 void MQTT::sendSubscriptions()
 {
 #if HAS_NETWORKING
     bool hasDownlink = false;
-    size_t numChan = channels.getNumChannels();
+    size_t numChan = std::min<size_t>(channels.getNumChannels(), channelTopics.size());
     for (size_t i = 0; i < numChan; i++) {
         const auto &ch = channels.getByIndex(i);
         if (ch.settings.downlink_enabled) {
             hasDownlink = true;
-            std::string topic = cryptTopic + channels.getGlobalId(i) + "/+";
+            const std::string &topic = channelTopics[i].crypt;
             LOG_INFO("Subscribe to %s", topic.c_str());
             pubSub.subscribe(topic.c_str(), 1); // FIXME, is QOS 1 right?
 #if !defined(ARCH_NRF52) ||                                                                                                      \
     defined(NRF52_USE_JSON) // JSON is not supported on nRF52, see issue #2804 ### Fixed by using ArduinoJSON ###
             if (moduleConfig.mqtt.json_enabled == true) {
-                std::string topicDecoded = jsonTopic + channels.getGlobalId(i) + "/+";
+                const std::string &topicDecoded = channelTopics[i].json;
                 LOG_INFO("Subscribe to %s", topicDecoded.c_str());
                 pubSub.subscribe(topicDecoded.c_str(), 1); // FIXME, is QOS 1 right?
             }
@@ -549,9 +612,8 @@ void MQTT::sendSubscriptions()
     }
 #if !MESHTASTIC_EXCLUDE_PKI
     if (hasDownlink) {
-        std::string topic = cryptTopic + "PKI/+";
-        LOG_INFO("Subscribe to %s", topic.c_str());
-        pubSub.subscribe(topic.c_str(), 1);
+        LOG_INFO("Subscribe to %s", pkiTopic.c_str());
+        pubSub.subscribe(pkiTopic.c_str(), 1);
     }
 #endif
 #endif
@@ -585,6 +647,12 @@ int32_t MQTT::runOnce()
                 return 30000;
         }
     } else {
+        // Keep reading while encrypted downlink keeps arriving, then decrypt all of it at once
+        size_t queued = pendingDownlink.size();
+        while (queued && queued < downlinkBatchMax && pubSub.loop() && pendingDownlink.size() > queued)
+            queued = pendingDownlink.size();
+        decodePendingDownlink();
+
         // we are connected to server, check often for new requests on the TCP port
         if (!wantConnection) {
             LOG_INFO("MQTT link not needed, drop");
@@ -793,6 +861,12 @@ void MQTT::perhapsReportToMap()
         return;
     }
 
+    if (moduleConfig.mqtt.map_report_settings.batch_node_positions) {
+        reportBatchToMap();
+        last_report_to_map = millis();
+        return;
+    }
+
     // Allocate MeshPacket and fill it
     meshtastic_MeshPacket *mp = packetPool.allocZeroed();
     mp->which_payload_variant = meshtastic_MeshPacket_decoded_tag;
@@ -813,10 +887,9 @@ void MQTT::perhapsReportToMap()
     mapReport.has_opted_report_location = true;
 
     // Set position with precision (same as in PositionModule)
-    mapReport.latitude_i = localPosition.latitude_i & (UINT32_MAX << (32 - map_position_precision));
-    mapReport.longitude_i = localPosition.longitude_i & (UINT32_MAX << (32 - map_position_precision));
-    mapReport.latitude_i += (1 << (31 - map_position_precision));
-    mapReport.longitude_i += (1 << (31 - map_position_precision));
+    mapReport.latitude_i = localPosition.latitude_i;
+    mapReport.longitude_i = localPosition.longitude_i;
+    GeoCoord::applyPrecision(mapReport.latitude_i, mapReport.longitude_i, map_position_precision);
 
     mapReport.altitude = localPosition.altitude;
     mapReport.position_precision = map_position_precision;
@@ -842,4 +915,39 @@ void MQTT::perhapsReportToMap()
 
     // Update the last report time
     last_report_to_map = millis();
+}
+
+void MQTT::reportBatchToMap()
+{
+    static_assert(meshtastic_MapReportBatch_size <= sizeof(bytes), "MapReportBatch does not fit in the publish buffer");
+
+    meshtastic_MapReportBatch batch = meshtastic_MapReportBatch_init_zero;
+    strncpy(batch.gateway_id, owner.id, sizeof(batch.gateway_id) - 1);
+
+    auto addNode = [&](NodeNum num, int32_t latitude_i, int32_t longitude_i, int32_t altitude, uint32_t lastHeard) {
+        meshtastic_MapReportNode &node = batch.nodes[batch.nodes_count++];
+        node.num = num;
+        node.latitude_i = latitude_i;
+        node.longitude_i = longitude_i;
+        GeoCoord::applyPrecision(node.latitude_i, node.longitude_i, map_position_precision);
+        node.altitude = altitude;
+        node.position_precision = map_position_precision;
+        node.last_heard = lastHeard;
+    };
+    addNode(nodeDB->getNodeNum(), localPosition.latitude_i, localPosition.longitude_i, localPosition.altitude, getTime());
+
+    const size_t maxNodes = sizeof(batch.nodes) / sizeof(batch.nodes[0]);
+    for (size_t i = 0; i < nodeDB->getNumMeshNodes() && batch.nodes_count < maxNodes; i++) {
+        const meshtastic_NodeInfoLite *n = nodeDB->getMeshNodeByIndex(i);
+        // Only positions heard over LoRa in the last two hours, on a channel we would uplink them from anyway
+        if (n->num == nodeDB->getNodeNum() || n->via_mqtt || n->is_ignored || !nodeDB->hasValidPosition(n) ||
+            sinceLastSeen(n) >= 2 * 60 * 60 || !channels.getByIndex(n->channel).settings.uplink_enabled)
+            continue;
+        addNode(n->num, n->position.latitude_i, n->position.longitude_i, n->position.altitude, n->last_heard);
+    }
+
+    size_t numBytes = pb_encode_to_bytes(bytes, sizeof(bytes), &meshtastic_MapReportBatch_msg, &batch);
+
+    LOG_INFO("MQTT Publish map report of %u nodes to %s", batch.nodes_count, mapBatchTopic.c_str());
+    publish(mapBatchTopic.c_str(), bytes, numBytes, false);
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "configuration.h"
 
 #include "concurrency/OSThread.h"
+#include "TopicTrie.h"
 #include "mesh/Channels.h"
 #include "mesh/generated/meshtastic/mqtt.pb.h"
 #if !defined(ARCH_NRF52) || NRF52_USE_JSON
@@ -56,6 +57,9 @@ class MQTT : private concurrency::OSThread
 
     bool isEnabled() { return this->enabled; };
 
+    /// Called by Channels when the channel table changed, recompiles our topic trie and subscriptions
+    void onChannelsChanged();
+
     void start() { setIntervalFromNow(0); };
 
     bool isUsingDefaultServer() { return isConfiguredForDefaultServer; }
@@ -101,9 +105,21 @@ class MQTT : private concurrency::OSThread
     explicit MQTT(std::unique_ptr<MQTTClient> mqttClient);
 #endif
 
-    std::string cryptTopic = "/2/e/";   // msh/2/e/CHANNELID/NODEID
-    std::string jsonTopic = "/2/json/"; // msh/2/json/CHANNELID/NODEID
-    std::string mapTopic = "/2/map/";   // For protobuf-encoded MapReport messages
+    std::string cryptTopic = "/2/e/";            // msh/2/e/CHANNELID/NODEID
+    std::string jsonTopic = "/2/json/";          // msh/2/json/CHANNELID/NODEID
+    std::string mapTopic = "/2/map/";            // For protobuf-encoded MapReport messages
+    std::string mapBatchTopic = "/2/map_batch/"; // For protobuf-encoded MapReportBatch messages
+
+    /// Downlink topic filters for each channel, precomputed by rebuildTopics()
+    struct ChannelTopics {
+        std::string crypt; // cryptTopic + channel id + "/+"
+        std::string json;  // jsonTopic + channel id + "/+"
+    };
+    std::vector<ChannelTopics> channelTopics;
+    std::string pkiTopic; // cryptTopic + "PKI/+"
+
+    /// Maps inbound topics to (channel index, encrypted/json/PKI), see rebuildTopics()
+    TopicTrie topics;
 
     // For map reporting (only applies when enabled)
     const uint32_t default_map_position_precision = 14; // defaults to max. offset of ~1459m
@@ -119,6 +135,10 @@ class MQTT : private concurrency::OSThread
      */
     void sendSubscriptions();
 
+    /** Recompute the per channel topic filters and the topic trie from the current channel table
+     */
+    void rebuildTopics();
+
     /// Callback for direct mqtt subscription messages
     static void mqttCallback(char *topic, byte *payload, unsigned int length);
 
@@ -134,6 +154,9 @@ class MQTT : private concurrency::OSThread
     // Check if we should report unencrypted information about our node for consumption by a map
     void perhapsReportToMap();
 
+    // Report our position and those of the nodes we heard on uplink channels in one MapReportBatch
+    void reportBatchToMap();
+
     /// Return 0 if sleep is okay, veto sleep if we are connected to pubsub server
     // int preflightSleepCb(void *unused = NULL) { return pubSub.connected() ? 1 : 0; }
 };
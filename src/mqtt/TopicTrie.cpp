@@ -0,0 +1,122 @@
+#include "TopicTrie.h"
+
+#include <string.h>
+
+namespace
+{
+inline bool levelEquals(const std::string &level, const char *s, size_t len)
+{
+    return level.length() == len && memcmp(level.data(), s, len) == 0;
+}
+
+inline bool isWildcard(const std::string &level)
+{
+    return level.length() == 1 && (level[0] == '+' || level[0] == '#');
+}
+} // namespace
+
+void TopicTrie::clear()
+{
+    nodes.clear();
+}
+
+int16_t TopicTrie::findChild(int16_t parent, const char *level, size_t len) const
+{
+    for (int16_t c = nodes[parent].firstChild; c != NO_NODE; c = nodes[c].nextSibling)
+        if (levelEquals(nodes[c].level, level, len))
+            return c;
+    return NO_NODE;
+}
+
+int16_t TopicTrie::addChild(int16_t parent, const char *level, size_t len)
+{
+    Node n;
+    n.level.assign(level, len);
+    n.nextSibling = nodes[parent].firstChild;
+    nodes.push_back(std::move(n));
+    nodes[parent].firstChild = nodes.size() - 1;
+    return nodes.size() - 1;
+}
+
+void TopicTrie::insert(const std::string &filter, Match value)
+{
+    if (nodes.empty())
+        nodes.emplace_back(); // root
+
+    int16_t node = 0;
+    const char *level = filter.c_str();
+    while (true) {
+        const char *end = strchr(level, '/');
+        const size_t len = end ? end - level : strlen(level);
+
+        int16_t child = findChild(node, level, len);
+        if (child == NO_NODE)
+            child = addChild(node, level, len);
+        node = child;
+
+        if (!end)
+            break;
+        level = end + 1;
+    }
+
+    if (!nodes[node].terminal) {
+        nodes[node].terminal = true;
+        nodes[node].value = value;
+    }
+}
+
+TopicTrie::Match TopicTrie::match(const char *topic) const
+{
+    Match out;
+    if (!topic || nodes.empty())
+        return out;
+    matchFrom(0, topic, out);
+    return out;
+}
+
+bool TopicTrie::matchFrom(int16_t node, const char *topic, Match &out) const
+{
+    const char *end = strchr(topic, '/');
+    const size_t len = end ? end - topic : strlen(topic);
+
+    // Exact levels take priority over "+", which takes priority over "#"
+    int16_t exact = NO_NODE, plus = NO_NODE, hash = NO_NODE;
+    for (int16_t c = nodes[node].firstChild; c != NO_NODE; c = nodes[c].nextSibling) {
+        const std::string &level = nodes[c].level;
+        if (isWildcard(level)) {
+            if (level[0] == '+')
+                plus = c;
+            else
+                hash = c;
+        } else if (levelEquals(level, topic, len)) {
+            exact = c;
+        }
+    }
+
+    for (int16_t c : {exact, plus}) {
+        if (c == NO_NODE)
+            continue;
+        if (end) {
+            if (matchFrom(c, end + 1, out))
+                return true;
+        } else {
+            if (nodes[c].terminal) {
+                out = nodes[c].value;
+                return true;
+            }
+            // "a/#" also matches "a"
+            for (int16_t h = nodes[c].firstChild; h != NO_NODE; h = nodes[h].nextSibling) {
+                if (nodes[h].terminal && levelEquals(nodes[h].level, "#", 1)) {
+                    out = nodes[h].value;
+                    return true;
+                }
+            }
+        }
+    }
+
+    if (hash != NO_NODE && nodes[hash].terminal) {
+        out = nodes[hash].value;
+        return true;
+    }
+    return false;
+}
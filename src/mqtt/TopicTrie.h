@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * A precompiled matcher for the MQTT topic filters we subscribe to.
+ *
+ * Filters are split on '/' into levels and stored as a trie, so an inbound topic is resolved to its channel in a single
+ * left-to-right pass without allocating or copying the topic.  A level of "+" matches exactly one topic level, a final level
+ * of "#" matches any remaining levels.  The trie is only rebuilt when the channel configuration changes.
+ */
+class TopicTrie
+{
+  public:
+    enum class Kind : uint8_t {
+        NONE,      // topic does not match any filter
+        ENCRYPTED, // <root>/2/e/<channel id>/<gateway id>, protobuf ServiceEnvelope
+        JSON,      // <root>/2/json/<channel id>/<gateway id>
+        PKI,       // <root>/2/e/PKI/<gateway id>
+    };
+
+    struct Match {
+        Kind kind = Kind::NONE;
+        uint8_t channel = 0; // channel index, only meaningful for ENCRYPTED and JSON
+    };
+
+    /// Remove all filters
+    void clear();
+
+    /** Add a topic filter. If the same filter was already added the first value is kept, matching the
+     * first-wins behaviour of Channels::getByName().
+     */
+    void insert(const std::string &filter, Match value);
+
+    /// Find the value for the filter matching this topic, or a Match with Kind::NONE
+    Match match(const char *topic) const;
+
+    bool empty() const { return nodes.size() <= 1; }
+
+  private:
+    static constexpr int16_t NO_NODE = -1;
+
+    struct Node {
+        std::string level;
+        int16_t firstChild = NO_NODE;
+        int16_t nextSibling = NO_NODE;
+        bool terminal = false;
+        Match value;
+    };
+
+    /// nodes[0] is the (unlabeled) root, children are linked through firstChild/nextSibling
+    std::vector<Node> nodes;
+
+    int16_t findChild(int16_t parent, const char *level, size_t len) const;
+    int16_t addChild(int16_t parent, const char *level, size_t len);
+    bool matchFrom(int16_t node, const char *topic, Match &out) const;
+};
@@ -0,0 +1,514 @@
+#include "MeshSimulator.h"
+#include "Channels.h"
+#include "CryptoEngine.h"
+#include "MeshRadio.h"
+#include "MeshService.h"
+#include "NextHopRouter.h"
+#include "PortduinoGlue.h"
+#include "TypeConversions.h"
+#include "configuration.h"
+#include "modules/RoutingModule.h"
+
+#include <algorithm>
+#include <math.h>
+
+// Free space path loss at 1 m for the sub-GHz ISM bands
+#define PATH_LOSS_AT_1M_DB 32.0f
+// Receiver noise figure used to derive the noise floor from the bandwidth
+#define NOISE_FIGURE_DB 6.0f
+// The SNR the radio reports saturates, strong signals don't read higher than this
+#define MAX_REPORTED_SNR_DB 10.0f
+// Node numbers of the virtual nodes, well away from the MAC derived ones
+#define SIM_FIRST_NODENUM 0x51d00001
+
+namespace
+{
+/// The router of a virtual node, run by the simulator instead of the main thread scheduler
+class NodeRouter : public NextHopRouter
+{
+  public:
+    NodeRouter() { concurrency::mainController.remove(this); }
+
+    ~NodeRouter()
+    {
+        for (auto &it : pending)
+            packetPool.release(it.second.packet);
+    }
+};
+
+/// Router's constructor creates cryptLock and insists it is the only one to do so, the virtual nodes share the existing lock
+Router *newNodeRouter()
+{
+    concurrency::Lock *sharedLock = cryptLock;
+    cryptLock = NULL;
+    Router *r = new NodeRouter();
+    if (sharedLock) {
+        delete cryptLock;
+        cryptLock = sharedLock;
+    }
+    return r;
+}
+} // namespace
+
+void MeshSimulator::NodeScope::swapGlobals()
+{
+    std::swap(nodeDB, node.nodeDB);
+    std::swap(router, node.router);
+    std::swap(::config, node.config);
+    std::swap(moduleConfig, node.moduleConfig);
+    std::swap(devicestate, node.devicestate);
+    std::swap(nodeDatabase, node.nodeDatabase);
+}
+
+MeshSimulator::NodeRadio::~NodeRadio()
+{
+    meshtastic_MeshPacket *p;
+    while ((p = txQueue.dequeue()) != NULL)
+        packetPool.release(p);
+}
+
+ErrorCode MeshSimulator::NodeRadio::send(meshtastic_MeshPacket *p)
+{
+    if (!::config.lora.tx_enabled) {
+        packetPool.release(p);
+        return ERRNO_DISABLED;
+    }
+    if (!txQueue.enqueue(p)) {
+        packetPool.release(p);
+        return ERRNO_UNKNOWN;
+    }
+    setTransmitDelay();
+    return ERRNO_OK;
+}
+
+meshtastic_QueueStatus MeshSimulator::NodeRadio::getQueueStatus()
+{
+    meshtastic_QueueStatus qs;
+    qs.res = qs.mesh_packet_id = 0;
+    qs.free = txQueue.getFree();
+    qs.maxlen = txQueue.getMaxLen();
+    return qs;
+}
+
+bool MeshSimulator::NodeRadio::cancelSending(NodeNum from, PacketId id)
+{
+    meshtastic_MeshPacket *p = txQueue.remove(from, id);
+    if (p)
+        packetPool.release(p);
+    return p != NULL;
+}
+
+bool MeshSimulator::NodeRadio::findInTxQueue(NodeNum from, PacketId id)
+{
+    return txQueue.find(from, id);
+}
+
+void MeshSimulator::NodeRadio::setTransmitDelay()
+{
+    meshtastic_MeshPacket *p = txQueue.getFront();
+    if (!p || timerPending)
+        return;
+
+    // Locally generated packets have neither SNR nor RSSI, relayed ones get the SNR weighted contention window
+    uint32_t delay = (p->rx_snr == 0 && p->rx_rssi == 0) ? getTxDelayMsec() : getTxDelayMsecWeighted(p->rx_snr);
+    timerPending = true;
+    sim.schedule(sim.now + delay, EventType::TX_ATTEMPT, node);
+}
+
+meshtastic_MeshPacket *MeshSimulator::NodeRadio::onTransmitTimer(bool channelBusy)
+{
+    timerPending = false;
+    if (channelBusy) {
+        // Same as RadioLibInterface: back off for a new random delay and try again
+        setTransmitDelay();
+        return NULL;
+    }
+    return txQueue.dequeue();
+}
+
+MeshSimulator::MeshSimulator(RadioInterface &radio, const Config &config) : radio(radio), config(config), rng(config.seed) {}
+
+MeshSimulator::~MeshSimulator()
+{
+    for (auto &n : nodes) {
+        delete n.router;
+        delete n.radio;
+        delete n.nodeDB;
+    }
+    for (auto &tx : transmissions)
+        if (tx.packet)
+            packetPool.release(tx.packet);
+}
+
+void MeshSimulator::placeNodes()
+{
+    std::uniform_real_distribution<float> coord(0, config.areaMeters);
+    std::uniform_real_distribution<float> unit(0, 1);
+    std::normal_distribution<float> shadowing(0, config.shadowingDb);
+
+    nodes.resize(config.numNodes);
+    for (size_t i = 0; i < nodes.size(); i++) {
+        Node &n = nodes[i];
+        n.num = SIM_FIRST_NODENUM + i;
+        n.x = coord(rng);
+        n.y = coord(rng);
+        float r = unit(rng);
+        if (r < config.routerFraction)
+            n.role = meshtastic_Config_DeviceConfig_Role_ROUTER;
+        else if (r < config.routerFraction + config.muteFraction)
+            n.role = meshtastic_Config_DeviceConfig_Role_CLIENT_MUTE;
+        else
+            n.role = meshtastic_Config_DeviceConfig_Role_CLIENT;
+    }
+
+    const size_t count = nodes.size();
+    linkLossDb.assign(count * count, 0);
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = i + 1; j < count; j++) {
+            float d = std::max(1.0f, hypotf(nodes[i].x - nodes[j].x, nodes[i].y - nodes[j].y));
+            float loss = PATH_LOSS_AT_1M_DB + 10 * config.pathLossExponent * log10f(d) + shadowing(rng);
+            linkLossDb[i * count + j] = linkLossDb[j * count + i] = loss;
+        }
+    }
+}
+
+void MeshSimulator::buildNodes()
+{
+    // Constructing a NodeDB loads the saved preferences, put back the ones all nodes share afterwards
+    const meshtastic_ChannelFile sharedChannels = channelFile;
+    const meshtastic_DeviceUIConfig sharedUIConfig = uiconfig;
+    const meshtastic_Config_LoRaConfig lora = ::config.lora;
+
+    for (uint16_t i = 0; i < nodes.size(); i++) {
+        Node &n = nodes[i];
+        n.radio = new NodeRadio(*this, i);
+
+        NodeScope scope(n);
+        nodeDB = new NodeDB();
+        channelFile = sharedChannels;
+        uiconfig = sharedUIConfig;
+
+        ::config.device.role = n.role;
+        ::config.device.rebroadcast_mode = meshtastic_Config_DeviceConfig_RebroadcastMode_ALL;
+        ::config.lora = lora;
+        ::config.lora.hop_limit = config.hopLimit;
+        ::config.lora.tx_enabled = true;
+        ::config.lora.override_duty_cycle = true; // airtime accounting is shared, it can't enforce a per node duty cycle
+        moduleConfig.mqtt.enabled = false;        // keep simulated traffic off the uplink
+
+        myNodeInfo.my_node_num = n.num;
+        snprintf(owner.id, sizeof(owner.id), "!%08x", n.num);
+        snprintf(owner.long_name, sizeof(owner.long_name), "Simulated %u", i);
+        snprintf(owner.short_name, sizeof(owner.short_name), "%04x", n.num & 0xffff);
+        owner.role = n.role;
+
+        // Ourselves first, as NodeDB keeps it, then everybody else that fits
+        const meshtastic_NodeInfoLite empty = meshtastic_NodeInfoLite_init_default;
+        nodeDatabase.nodes.assign(MAX_NUM_NODES, empty);
+        size_t known = 0;
+        for (size_t k = 0; k < nodes.size() && known < nodeDatabase.nodes.size(); k++) {
+            const Node &other = nodes[(i + k) % nodes.size()];
+            meshtastic_NodeInfoLite &info = nodeDatabase.nodes[known++];
+            info.num = other.num;
+            info.has_user = true;
+            if (k == 0)
+                info.user = TypeConversions::ConvertToUserLite(owner);
+            else
+                info.user.role = other.role;
+        }
+        nodeDB->numMeshNodes = known;
+
+        router = newNodeRouter();
+        router->addInterface(n.radio);
+        initRegion(); // NodeDB set it up for the saved region
+        n.radio->reconfigure();
+    }
+
+    // Each NodeDB reapplied the saved channels, go back to the live ones
+    channels.onConfigChanged();
+    initRegion();
+}
+
+void MeshSimulator::schedule(uint64_t atMsec, EventType type, uint16_t node, uint32_t index)
+{
+    events.push(Event{atMsec, nextSeq++, type, node, index});
+}
+
+bool MeshSimulator::isChannelActive(const Node &n) const
+{
+    // We only track arrivals strong enough to demodulate, which is also what CAD would detect
+    return !n.hearing.empty();
+}
+
+void MeshSimulator::collectDeliveries(const Node &n)
+{
+    meshtastic_MeshPacket *p;
+    while ((p = service->getForPhone()) != NULL) {
+        auto it = packetStats.find(p->id);
+        if (it != packetStats.end() && it->second.origin == p->from && p->from != n.num) {
+            it->second.reached++;
+            latencies.push_back(now - it->second.originMsec);
+        }
+        service->releaseToPool(p);
+    }
+}
+
+void MeshSimulator::onOriginate(uint16_t node)
+{
+    Node &n = nodes[node];
+    NodeScope scope(n);
+
+    // Built by hand rather than with Router::allocForSending(), whose packet ids depend on how many came before
+    meshtastic_MeshPacket *p = packetPool.allocZeroed();
+    p->from = n.num;
+    p->to = NODENUM_BROADCAST;
+    p->id = packetStats.size() + 1;
+    p->hop_limit = config.hopLimit;
+    p->which_payload_variant = meshtastic_MeshPacket_decoded_tag;
+    p->decoded.portnum = meshtastic_PortNum_PRIVATE_APP;
+    p->decoded.payload.size = std::min<size_t>(config.payloadLen, sizeof(p->decoded.payload.bytes));
+
+    PacketStats stats;
+    stats.origin = n.num;
+    stats.originMsec = now;
+    packetStats[p->id] = stats;
+    results.originated++;
+
+    router->sendLocal(p, RX_SRC_LOCAL);
+    collectDeliveries(n);
+}
+
+void MeshSimulator::onTxAttempt(uint16_t node)
+{
+    Node &n = nodes[node];
+    meshtastic_MeshPacket *p;
+    {
+        NodeScope scope(n);
+        p = n.radio->onTransmitTimer(n.transmitting || isChannelActive(n));
+    }
+    if (p)
+        transmit(node, p);
+}
+
+void MeshSimulator::transmit(uint16_t node, meshtastic_MeshPacket *p)
+{
+    Node &n = nodes[node];
+    const uint32_t airtimeMsec = n.radio->getPacketTime(p);
+
+    Transmission tx;
+    tx.packet = p;
+    tx.sender = node;
+    tx.startMsec = now;
+    tx.endMsec = now + airtimeMsec;
+
+    // Half duplex: anything we were in the middle of receiving is lost
+    for (uint32_t other : n.hearing) {
+        for (auto &r : transmissions[other].receptions) {
+            if (r.node == node && r.lost == Loss::NONE)
+                r.lost = Loss::HALF_DUPLEX;
+        }
+    }
+    n.hearing.clear();
+    n.transmitting = true;
+    n.busyMsec += airtimeMsec;
+
+    const uint32_t txIndex = transmissions.size();
+    const size_t count = nodes.size();
+    for (size_t j = 0; j < count; j++) {
+        if (j == node)
+            continue;
+        float rssi = config.txPowerDbm - linkLossDb[node * count + j];
+        float snr = rssi - noiseFloorDbm;
+        if (snr < snrThreshold)
+            continue;
+
+        Node &receiver = nodes[j];
+        if (receiver.transmitting) {
+            results.rxHalfDuplex++;
+            continue;
+        }
+
+        Reception rx;
+        rx.node = j;
+        rx.snr = snr;
+        rx.rssi = rssi;
+
+        // Overlapping arrivals collide unless one is strong enough to capture the receiver
+        for (uint32_t other : receiver.hearing) {
+            for (auto &r : transmissions[other].receptions) {
+                if (r.node != j)
+                    continue;
+                if (rssi < r.rssi + CAPTURE_DB)
+                    rx.lost = Loss::COLLISION;
+                if (r.rssi < rssi + CAPTURE_DB && r.lost == Loss::NONE)
+                    r.lost = Loss::COLLISION;
+            }
+        }
+
+        receiver.hearing.push_back(txIndex);
+        receiver.busyMsec += airtimeMsec;
+        tx.receptions.push_back(rx);
+    }
+
+    auto stats = packetStats.find(p->id);
+    if (p->from != n.num && stats != packetStats.end())
+        stats->second.relays++;
+    results.transmissions++;
+
+    transmissions.push_back(std::move(tx));
+    schedule(now + airtimeMsec, EventType::TX_END, node, txIndex);
+}
+
+void MeshSimulator::onTxEnd(uint32_t txIndex)
+{
+    Node &sender = nodes[transmissions[txIndex].sender];
+    sender.transmitting = false;
+
+    // Take what we need out, delivering may start more transmissions
+    meshtastic_MeshPacket *p = transmissions[txIndex].packet;
+    transmissions[txIndex].packet = NULL;
+    const std::vector<Reception> receptions = transmissions[txIndex].receptions;
+    for (const auto &r : receptions) {
+        auto &hearing = nodes[r.node].hearing;
+        hearing.erase(std::remove(hearing.begin(), hearing.end(), txIndex), hearing.end());
+
+        if (r.lost == Loss::COLLISION) {
+            results.rxCollided++;
+        } else if (r.lost == Loss::HALF_DUPLEX) {
+            results.rxHalfDuplex++;
+        } else {
+            results.rxGood++;
+            deliver(r.node, p, r);
+        }
+    }
+    packetPool.release(p);
+
+    NodeScope scope(sender);
+    sender.radio->setTransmitDelay();
+}
+
+void MeshSimulator::deliver(uint16_t node, const meshtastic_MeshPacket *sent, const Reception &rx)
+{
+    Node &n = nodes[node];
+    NodeScope scope(n);
+
+    // Only what went over the air, rebuilt the way RadioLibInterface::handleReceiveInterrupt() does
+    meshtastic_MeshPacket *p = packetPool.allocZeroed();
+    p->from = sent->from;
+    p->to = sent->to;
+    p->id = sent->id;
+    p->channel = sent->channel;
+    p->hop_limit = sent->hop_limit;
+    p->hop_start = sent->hop_start;
+    p->want_ack = sent->want_ack;
+    p->via_mqtt = sent->via_mqtt;
+    p->next_hop = p->hop_start == 0 ? NO_NEXT_HOP_PREFERENCE : sent->next_hop;
+    p->relay_node = p->hop_start == 0 ? NO_RELAY_NODE : sent->relay_node;
+    p->rx_snr = std::min(rx.snr, MAX_REPORTED_SNR_DB);
+    p->rx_rssi = lround(rx.rssi);
+    p->which_payload_variant = meshtastic_MeshPacket_encrypted_tag;
+    p->encrypted.size = sent->encrypted.size;
+    memcpy(p->encrypted.bytes, sent->encrypted.bytes, sent->encrypted.size);
+
+    router->enqueueReceivedMessage(p);
+    router->runOnce();
+    collectDeliveries(n);
+
+    n.radio->setTransmitDelay();
+}
+
+MeshSimulator::Results MeshSimulator::run()
+{
+    results = Results();
+    // Relaying starts in RoutingModule and deliveries are counted at the MeshService
+    if (!service || !routingModule) {
+        LOG_ERROR("Mesh simulation needs the mesh service and routing module");
+        return results;
+    }
+    noiseFloorDbm = -174 + 10 * log10f(radio.getBandwidth() * 1000) + NOISE_FIGURE_DB;
+    snrThreshold = -7.5f - 2.5f * (radio.getSpreadingFactor() - 7); // demodulation floor from the SX126x datasheet
+
+    placeNodes();
+    buildNodes();
+    // The contention window helpers use random(), seed it too so runs are reproducible
+    randomSeed(config.seed);
+
+    std::exponential_distribution<double> interval(1.0 / std::max<uint32_t>(1, config.packetIntervalMsec));
+    std::uniform_int_distribution<uint16_t> pickNode(0, config.numNodes - 1);
+    double t = 0;
+    for (uint32_t i = 0; i < config.numPackets; i++) {
+        t += interval(rng);
+        schedule((uint64_t)t, EventType::ORIGINATE, pickNode(rng));
+    }
+
+    while (!events.empty()) {
+        Event e = events.top();
+        events.pop();
+        now = e.atMsec;
+
+        switch (e.type) {
+        case EventType::ORIGINATE:
+            onOriginate(e.node);
+            break;
+        case EventType::TX_ATTEMPT:
+            onTxAttempt(e.node);
+            break;
+        case EventType::TX_END:
+            onTxEnd(e.index);
+            break;
+        }
+    }
+
+    results.durationMsec = now;
+    for (auto &n : nodes) {
+        results.relaysCanceled += n.router->txRelayCanceled;
+        results.rxDupe += n.router->rxDupe;
+    }
+    if (!packetStats.empty()) {
+        float coverage = 0, relays = 0;
+        for (auto &it : packetStats) {
+            coverage += config.numNodes > 1 ? float(it.second.reached) / (config.numNodes - 1) : 0;
+            relays += it.second.relays;
+        }
+        results.meanCoverage = coverage / packetStats.size();
+        results.meanRelaysPerPacket = relays / packetStats.size();
+    }
+    if (now > 0 && !nodes.empty()) {
+        float util = 0;
+        for (auto &n : nodes)
+            util += std::min(1.0f, float(n.busyMsec) / now);
+        results.meanChannelUtilization = util / nodes.size();
+    }
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        results.latencyP50Msec = latencies[latencies.size() / 2];
+        results.latencyP95Msec = latencies[latencies.size() * 95 / 100];
+        results.latencyMaxMsec = latencies.back();
+    }
+    return results;
+}
+
+void MeshSimulator::logResults(const Config &config, const Results &r)
+{
+    LOG_INFO("Mesh simulation: %u nodes in %.1f km square, %u packets, hop limit %u", config.numNodes,
+             config.areaMeters / 1000, config.numPackets, config.hopLimit);
+    LOG_INFO("  simulated %.1f s, %u transmissions, %.2f relays/packet, %u relays canceled", r.durationMsec / 1000.0,
+             r.transmissions, r.meanRelaysPerPacket, r.relaysCanceled);
+    LOG_INFO("  coverage %.1f%%, channel utilization %.1f%%", r.meanCoverage * 100, r.meanChannelUtilization * 100);
+    LOG_INFO("  rx good %u, collided %u, half-duplex %u, dupes %u", r.rxGood, r.rxCollided, r.rxHalfDuplex, r.rxDupe);
+    LOG_INFO("  latency p50 %u ms, p95 %u ms, max %u ms", r.latencyP50Msec, r.latencyP95Msec, r.latencyMaxMsec);
+}
+
+void runMeshSimulation(RadioInterface &radio, uint16_t numNodes)
+{
+    MeshSimulator::Config config;
+    config.numNodes = numNodes;
+
+    // Every node's router and NodeDB logs as it goes, only let warnings through while the simulation runs
+    int logLevel = settingsMap[logoutputlevel];
+    settingsMap[logoutputlevel] = std::min(logLevel, (int)level_warn);
+    MeshSimulator::Results results = MeshSimulator(radio, config).run();
+    settingsMap[logoutputlevel] = logLevel;
+
+    MeshSimulator::logResults(config, results);
+}
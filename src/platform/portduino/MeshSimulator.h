@@ -0,0 +1,215 @@
+#pragma once
+
+#include "MeshPacketQueue.h"
+#include "NodeDB.h"
+#include "RadioInterface.h"
+#include "Router.h"
+
+#include <queue>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * An in-process discrete-event simulation of a whole mesh.
+ *
+ * Unlike SimRadio, which bridges this one node to an external simulator, this instantiates many virtual nodes inside the
+ * process and runs them in virtual time, as fast as the host can step the event queue.  Every virtual node runs the firmware's
+ * own routing code: a NextHopRouter (with its PacketHistory) and a NodeDB of its own, on top of a virtual RadioInterface that
+ * queues and times transmissions like RadioLibInterface does.  So dupe detection, rebroadcast decisions, dupe cancellation and
+ * the SNR weighted contention window are the real ones, and a change to Router shows up here.
+ *
+ * The firmware keeps a node's identity and settings in globals (config, moduleConfig, devicestate, nodeDatabase, nodeDB and
+ * router), so NodeScope swaps a virtual node's copies in while that node handles an event.  Each NodeDB starts from the saved
+ * preferences, then gets its own node number and role.  Channels, modules, the MeshService and airtime accounting are shared by
+ * all nodes.  Each node knows every other node from the start, like a mesh that has been up for a while, so no NodeInfo
+ * exchanges are simulated.
+ *
+ * Timers inside the firmware, such as PacketHistory expiry and NextHopRouter retransmissions, run on the host clock rather
+ * than in virtual time, so next-hop fallback and ACK retransmissions are not exercised.  Nodes only originate broadcasts, and
+ * ROUTER_LATE's late rebroadcast window is not modelled.
+ *
+ * The radio channel is a log-distance path loss model with per-link shadowing, half-duplex radios, carrier sense before
+ * transmit, and collisions with capture (the stronger packet survives if it is CAPTURE_DB above the other).  The noise floor and
+ * demodulation threshold come from the live RadioInterface, and every node radio is configured from the same LoRa settings, so
+ * the current modem preset is what gets simulated.
+ */
+class MeshSimulator
+{
+  public:
+    struct Config {
+        uint16_t numNodes = 100;
+        float areaMeters = 15000;       // nodes are placed uniformly in a square of this side
+        float routerFraction = 0.05;    // fraction of nodes with the ROUTER role
+        float muteFraction = 0.0;       // fraction of nodes with the CLIENT_MUTE role
+        uint32_t numPackets = 200;      // packets originated by random nodes over the run
+        uint32_t packetIntervalMsec = 15000; // mean time between originated packets
+        uint8_t hopLimit = 3;
+        uint8_t payloadLen = 40; // application payload, encoding and the LoRa packet header add to this on air
+        float txPowerDbm = 20;
+        float pathLossExponent = 2.9;
+        float shadowingDb = 6; // standard deviation of per-link shadowing
+        uint32_t seed = 1;
+    };
+
+    struct Results {
+        uint32_t originated = 0;
+        uint32_t transmissions = 0;
+        uint32_t relaysCanceled = 0;
+        uint32_t rxGood = 0;
+        uint32_t rxCollided = 0;   // lost because another packet overlapped at the receiver
+        uint32_t rxHalfDuplex = 0; // lost because the receiver started transmitting
+        uint32_t rxDupe = 0;
+        uint64_t durationMsec = 0;
+        float meanCoverage = 0;          // fraction of the other nodes each packet reached
+        float meanRelaysPerPacket = 0;
+        float meanChannelUtilization = 0; // fraction of time a node's channel was busy, averaged over nodes
+        uint32_t latencyP50Msec = 0, latencyP95Msec = 0, latencyMaxMsec = 0; // first delivery, per receiving node
+    };
+
+    MeshSimulator(RadioInterface &radio, const Config &config);
+    ~MeshSimulator();
+
+    /**
+     * Build the nodes, run the whole scenario in virtual time and return the collected statistics.  Call once per instance,
+     * after the MeshService and the RoutingModule have been set up.
+     */
+    Results run();
+
+    /// Log the results in human readable form
+    static void logResults(const Config &config, const Results &results);
+
+  private:
+    static constexpr float CAPTURE_DB = 6;
+
+    enum class EventType : uint8_t { ORIGINATE, TX_ATTEMPT, TX_END };
+
+    struct Event {
+        uint64_t atMsec;
+        uint32_t seq; // FIFO order for events at the same time
+        EventType type;
+        uint16_t node;
+        uint32_t index; // transmission for TX_END
+    };
+
+    struct EventLater {
+        bool operator()(const Event &a, const Event &b) const
+        {
+            return a.atMsec != b.atMsec ? a.atMsec > b.atMsec : a.seq > b.seq;
+        }
+    };
+
+    /// The radio of a virtual node: a TX queue with the same contention window timing as RadioLibInterface
+    class NodeRadio : public RadioInterface
+    {
+      public:
+        NodeRadio(MeshSimulator &sim, uint16_t node) : sim(sim), node(node) {}
+        virtual ~NodeRadio();
+
+        virtual ErrorCode send(meshtastic_MeshPacket *p) override;
+        virtual meshtastic_QueueStatus getQueueStatus() override;
+        virtual bool cancelSending(NodeNum from, PacketId id) override;
+        virtual bool findInTxQueue(NodeNum from, PacketId id) override;
+
+        /// Like RadioLibInterface::setTransmitDelay(), start the transmit timer for the packet at the front of the queue
+        void setTransmitDelay();
+
+        /// The transmit timer went off, take the next packet to send if the channel is free
+        meshtastic_MeshPacket *onTransmitTimer(bool channelBusy);
+
+      private:
+        MeshSimulator &sim;
+        uint16_t node;
+        MeshPacketQueue txQueue = MeshPacketQueue(MAX_TX_QUEUE);
+        bool timerPending = false;
+    };
+
+    enum class Loss : uint8_t { NONE, COLLISION, HALF_DUPLEX };
+
+    struct Reception {
+        uint16_t node;
+        float snr;
+        float rssi;
+        Loss lost = Loss::NONE;
+    };
+
+    struct Transmission {
+        meshtastic_MeshPacket *packet; // owned until the transmission ends
+        uint16_t sender;
+        uint64_t startMsec, endMsec;
+        std::vector<Reception> receptions;
+    };
+
+    struct Node {
+        float x, y;
+        meshtastic_Config_DeviceConfig_Role role;
+        NodeNum num;
+        NodeRadio *radio = NULL;
+
+        // This node's copies of the firmware globals, swapped in by NodeScope
+        NodeDB *nodeDB = NULL;
+        Router *router = NULL;
+        meshtastic_LocalConfig config = meshtastic_LocalConfig_init_zero;
+        meshtastic_LocalModuleConfig moduleConfig = meshtastic_LocalModuleConfig_init_zero;
+        meshtastic_DeviceState devicestate = meshtastic_DeviceState_init_zero;
+        meshtastic_NodeDatabase nodeDatabase = {};
+
+        bool transmitting = false;
+        std::vector<uint32_t> hearing; // transmissions currently arriving at this node
+        uint64_t busyMsec = 0;
+    };
+
+    /// While in scope, the node's NodeDB, router and settings are the ones the firmware sees in its globals
+    class NodeScope
+    {
+      public:
+        explicit NodeScope(Node &node) : node(node) { swapGlobals(); }
+        ~NodeScope() { swapGlobals(); }
+
+      private:
+        Node &node;
+        void swapGlobals();
+    };
+
+    struct PacketStats {
+        NodeNum origin;
+        uint64_t originMsec;
+        uint32_t reached = 0;
+        uint32_t relays = 0;
+    };
+
+    RadioInterface &radio;
+    Config config;
+    Results results;
+
+    std::mt19937 rng;
+    std::vector<Node> nodes;
+    std::vector<float> linkLossDb; // numNodes x numNodes, symmetric
+    std::vector<Transmission> transmissions;
+    std::unordered_map<PacketId, PacketStats> packetStats;
+    std::vector<uint32_t> latencies;
+
+    std::priority_queue<Event, std::vector<Event>, EventLater> events;
+    uint32_t nextSeq = 0;
+    uint64_t now = 0;
+
+    float noiseFloorDbm = 0, snrThreshold = 0;
+
+    void placeNodes();
+    void buildNodes();
+    void schedule(uint64_t atMsec, EventType type, uint16_t node, uint32_t index = 0);
+
+    void onOriginate(uint16_t node);
+    void onTxAttempt(uint16_t node);
+    void onTxEnd(uint32_t txIndex);
+    void transmit(uint16_t node, meshtastic_MeshPacket *p);
+    void deliver(uint16_t node, const meshtastic_MeshPacket *sent, const Reception &rx);
+
+    /// Count the packets the node's router handed to the phone as delivered
+    void collectDeliveries(const Node &n);
+
+    bool isChannelActive(const Node &n) const;
+};
+
+/// Entry point for --sim-mesh, runs a scenario with the given number of nodes and logs the results
+void runMeshSimulation(RadioInterface &radio, uint16_t numNodes);
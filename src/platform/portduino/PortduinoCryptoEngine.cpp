@@ -0,0 +1,272 @@
+#include "CryptoEngine.h"
+#include "configuration.h"
+
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define AES_HW_X86 1
+#define AES_HW_TARGET __attribute__((target("aes,sse2")))
+#elif defined(__aarch64__) && defined(__linux__)
+#include <arm_neon.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#define AES_HW_ARM 1
+#if defined(__clang__)
+#define AES_HW_TARGET __attribute__((target("aes")))
+#else
+#define AES_HW_TARGET __attribute__((target("+crypto")))
+#endif
+#endif
+
+#define AES_BLOCK 16
+#define AES_MAX_ROUNDS 14
+// Counter blocks encrypted per call, enough to keep the pipelined AES units of current cores busy
+#define AES_LANES 8
+
+/**
+ * CryptoEngine for meshtasticd that uses the CPU's AES instructions (AES-NI on x86, the ARMv8 Crypto Extensions on aarch64).
+ *
+ * Support is detected at runtime, so one binary runs everywhere; on CPUs without AES instructions (or other architectures)
+ * every call goes to the portable CryptoEngine implementation.  The hardware path covers both the channel AES-CTR and the
+ * single block aesEncrypt() that aes-ccm.cpp builds PKI encryption on, and keeps its key schedule inline instead of
+ * allocating a new cipher object per packet.
+ */
+class PortduinoCryptoEngine : public CryptoEngine
+{
+  public:
+    PortduinoCryptoEngine() : hwAes(detectHwAes()) {}
+
+    ~PortduinoCryptoEngine() { clearSchedule(ccmSchedule); }
+
+    virtual void encryptAESCtr(CryptoKey _key, uint8_t *_nonce, size_t numBytes, uint8_t *bytes) override
+    {
+        if (!hwAes) {
+            CryptoEngine::encryptAESCtr(_key, _nonce, numBytes, bytes);
+            return;
+        }
+        if (_key.length != 16 && _key.length != 32)
+            return;
+
+        Schedule schedule;
+        expandKey(schedule, _key.bytes, _key.length);
+        ctrXor(schedule, _nonce, numBytes, bytes);
+        clearSchedule(schedule);
+    }
+
+    virtual void decryptBatch(DecryptJob *jobs, size_t numJobs) override
+    {
+        if (!hwAes) {
+            CryptoEngine::decryptBatch(jobs, numJobs);
+            return;
+        }
+
+        // Counter blocks from all packets sharing a key go through the AES units together, not one packet at a time
+        Schedule schedule;
+        const CryptoKey *installed = nullptr;
+        Lanes lanes;
+        for (size_t i = 0; i < numJobs; i++) {
+            DecryptJob &job = jobs[i];
+            if ((job.key->length != 16 && job.key->length != 32) || job.numBytes > MAX_BLOCKSIZE)
+                continue;
+
+            if (!installed || installed->length != job.key->length || memcmp(installed->bytes, job.key->bytes, job.key->length)) {
+                lanes.flush(schedule);
+                expandKey(schedule, job.key->bytes, job.key->length);
+                installed = job.key;
+            }
+
+            initNonce(job.fromNode, job.packetId);
+            lanes.add(schedule, nonce, job.numBytes, job.bytes);
+        }
+        lanes.flush(schedule);
+        clearSchedule(schedule);
+    }
+
+#if !(MESHTASTIC_EXCLUDE_PKI)
+    virtual void aesSetKey(const uint8_t *key_bytes, size_t key_len) override
+    {
+        if (!hwAes) {
+            CryptoEngine::aesSetKey(key_bytes, key_len);
+            return;
+        }
+        clearSchedule(ccmSchedule);
+        if (key_len == 16 || key_len == 32)
+            expandKey(ccmSchedule, key_bytes, key_len);
+    }
+
+    virtual void aesEncrypt(uint8_t *in, uint8_t *out) override
+    {
+        if (!hwAes) {
+            CryptoEngine::aesEncrypt(in, out);
+            return;
+        }
+        if (ccmSchedule.rounds == 0)
+            return;
+        encryptBlocks(ccmSchedule, in, out, 1);
+    }
+#endif
+
+  private:
+    struct Schedule {
+        uint8_t roundKeys[(AES_MAX_ROUNDS + 1) * AES_BLOCK];
+        uint8_t rounds = 0;
+    };
+
+    const bool hwAes;
+    Schedule ccmSchedule;
+
+    static bool detectHwAes()
+    {
+#if defined(AES_HW_X86)
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+            return false;
+        return (ecx & bit_AES) && (edx & bit_SSE2);
+#elif defined(AES_HW_ARM)
+        return getauxval(AT_HWCAP) & HWCAP_AES;
+#else
+        return false;
+#endif
+    }
+
+    static void clearSchedule(Schedule &s)
+    {
+        volatile uint8_t *p = s.roundKeys;
+        for (size_t i = 0; i < sizeof(s.roundKeys); i++)
+            p[i] = 0;
+        s.rounds = 0;
+    }
+
+    /// FIPS-197 key expansion, the round keys are stored as plain bytes so both instruction sets can load them directly
+    static void expandKey(Schedule &s, const uint8_t *key, size_t keyLen)
+    {
+        static const uint8_t sbox[256] = {
+            0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76, 0xca, 0x82, 0xc9,
+            0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0, 0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f,
+            0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15, 0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07,
+            0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75, 0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3,
+            0x29, 0xe3, 0x2f, 0x84, 0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58,
+            0xcf, 0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8, 0x51, 0xa3,
+            0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2, 0xcd, 0x0c, 0x13, 0xec, 0x5f,
+            0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73, 0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88,
+            0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb, 0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac,
+            0x62, 0x91, 0x95, 0xe4, 0x79, 0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a,
+            0xae, 0x08, 0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a, 0x70,
+            0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e, 0xe1, 0xf8, 0x98, 0x11,
+            0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf, 0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42,
+            0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16};
+        static const uint8_t rcon[10] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36};
+
+        const size_t nk = keyLen / 4;
+        s.rounds = nk + 6;
+        const size_t words = 4 * (s.rounds + 1);
+        uint8_t *w = s.roundKeys;
+        memcpy(w, key, keyLen);
+        for (size_t i = nk; i < words; i++) {
+            uint8_t t[4];
+            memcpy(t, w + 4 * (i - 1), 4);
+            if (i % nk == 0) {
+                const uint8_t t0 = t[0];
+                t[0] = sbox[t[1]] ^ rcon[i / nk - 1];
+                t[1] = sbox[t[2]];
+                t[2] = sbox[t[3]];
+                t[3] = sbox[t0];
+            } else if (nk > 6 && i % nk == 4) {
+                for (auto &b : t)
+                    b = sbox[b];
+            }
+            for (size_t j = 0; j < 4; j++)
+                w[4 * i + j] = w[4 * (i - nk) + j] ^ t[j];
+        }
+    }
+
+    /// Same counter handling as CTR<> with setCounterSize(4): the last 4 bytes of the IV are a big endian block counter
+    static void incrementCounter(uint8_t *counter)
+    {
+        for (int i = AES_BLOCK - 1; i >= AES_BLOCK - 4; i--)
+            if (++counter[i])
+                break;
+    }
+
+    /// Collects counter blocks, possibly from several packets, and XORs their keystream into the data AES_LANES at a time
+    struct Lanes {
+        uint8_t blocks[AES_LANES * AES_BLOCK];
+        uint8_t keystream[AES_LANES * AES_BLOCK];
+        uint8_t *dest[AES_LANES];
+        uint8_t len[AES_LANES];
+        size_t count = 0;
+
+        void add(const Schedule &s, const uint8_t *iv, size_t numBytes, uint8_t *bytes)
+        {
+            uint8_t counter[AES_BLOCK];
+            memcpy(counter, iv, AES_BLOCK);
+            for (size_t offset = 0; offset < numBytes; offset += AES_BLOCK) {
+                memcpy(blocks + count * AES_BLOCK, counter, AES_BLOCK);
+                dest[count] = bytes + offset;
+                len[count] = numBytes - offset < AES_BLOCK ? numBytes - offset : AES_BLOCK;
+                incrementCounter(counter);
+                if (++count == AES_LANES)
+                    flush(s);
+            }
+        }
+
+        void flush(const Schedule &s)
+        {
+            if (!count)
+                return;
+            encryptBlocks(s, blocks, keystream, count);
+            for (size_t i = 0; i < count; i++)
+                for (size_t j = 0; j < len[i]; j++)
+                    dest[i][j] ^= keystream[i * AES_BLOCK + j];
+            count = 0;
+        }
+    };
+
+    static void ctrXor(const Schedule &s, const uint8_t *iv, size_t numBytes, uint8_t *bytes)
+    {
+        Lanes lanes;
+        lanes.add(s, iv, numBytes, bytes);
+        lanes.flush(s);
+    }
+
+#if defined(AES_HW_X86)
+    AES_HW_TARGET static void encryptBlocks(const Schedule &s, const uint8_t *in, uint8_t *out, size_t n)
+    {
+        const __m128i *rk = (const __m128i *)s.roundKeys;
+        __m128i b[AES_LANES];
+        for (size_t i = 0; i < n; i++)
+            b[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(in + i * AES_BLOCK)), _mm_loadu_si128(rk));
+        for (uint8_t r = 1; r < s.rounds; r++) {
+            const __m128i k = _mm_loadu_si128(rk + r);
+            for (size_t i = 0; i < n; i++)
+                b[i] = _mm_aesenc_si128(b[i], k);
+        }
+        const __m128i last = _mm_loadu_si128(rk + s.rounds);
+        for (size_t i = 0; i < n; i++)
+            _mm_storeu_si128((__m128i *)(out + i * AES_BLOCK), _mm_aesenclast_si128(b[i], last));
+    }
+#elif defined(AES_HW_ARM)
+    AES_HW_TARGET static void encryptBlocks(const Schedule &s, const uint8_t *in, uint8_t *out, size_t n)
+    {
+        // AESE does AddRoundKey before SubBytes/ShiftRows, so the last round key is a plain XOR
+        uint8x16_t b[AES_LANES];
+        for (size_t i = 0; i < n; i++)
+            b[i] = vld1q_u8(in + i * AES_BLOCK);
+        for (uint8_t r = 0; r < s.rounds - 1; r++) {
+            const uint8x16_t k = vld1q_u8(s.roundKeys + r * AES_BLOCK);
+            for (size_t i = 0; i < n; i++)
+                b[i] = vaesmcq_u8(vaeseq_u8(b[i], k));
+        }
+        const uint8x16_t k = vld1q_u8(s.roundKeys + (s.rounds - 1) * AES_BLOCK);
+        const uint8x16_t last = vld1q_u8(s.roundKeys + s.rounds * AES_BLOCK);
+        for (size_t i = 0; i < n; i++)
+            vst1q_u8(out + i * AES_BLOCK, veorq_u8(vaeseq_u8(b[i], k), last));
+    }
+#else
+    static void encryptBlocks(const Schedule &, const uint8_t *, uint8_t *, size_t) {}
+#endif
+};
+
+CryptoEngine *crypto = new PortduinoCryptoEngine();
@@ -35,6 +35,7 @@ char *configPath = nullptr;
 char *optionMac = nullptr;
 bool forceSimulated = false;
 bool verboseEnabled = false;
+int simMeshNodes = 0;
 
 const char *argp_program_version = optstr(APP_VERSION);
 
@@ -74,6 +75,11 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state)
     case 'v':
         verboseEnabled = true;
         break;
+    case 'm':
+        if (sscanf(arg, "%d", &simMeshNodes) < 1 || simMeshNodes < 2 || simMeshNodes > UINT16_MAX)
+            return ARGP_ERR_UNKNOWN;
+        forceSimulated = true;
+        break;
     case ARGP_KEY_ARG:
         return 0;
     default:
@@ -89,6 +95,8 @@ void portduinoCustomInit()
                                            {"hwid", 'h', "HWID", 0, "The mac address to assign to this virtual machine"},
                                            {"sim", 's', 0, 0, "Run in Simulated radio mode"},
                                            {"verbose", 'v', 0, 0, "Set log level to full debug"},
+                                           {"sim-mesh", 'm', "NODES", 0,
+                                            "Simulate a mesh of NODES virtual nodes in virtual time, log the results and exit"},
                                            {0}};
     static void *childArguments;
     static char doc[] = "Meshtastic native build.";
@@ -472,6 +480,7 @@ bool loadConfig(const char *configPath)
                 // Default is !isatty(1) but can be set explicitly in config.yaml
                 settingsMap[ascii_logs] = yamlConfig["Logging"]["AsciiLogs"].as<bool>();
             }
+            settingsMap[deferred_logs] = yamlConfig["Logging"]["Deferred"].as<bool>(false);
         }
         if (yamlConfig["Lora"]) {
             const struct {
@@ -104,6 +104,7 @@ enum configNames {
     maxtophone,
     maxnodes,
     ascii_logs,
+    deferred_logs,
     config_directory,
     available_directory,
     mac_address,
@@ -121,6 +122,7 @@ extern std::map<configNames, int> settingsMap;
 extern std::map<configNames, std::string> settingsStrings;
 extern std::ofstream traceFile;
 extern Ch341Hal *ch341Hal;
+extern int simMeshNodes;
 int initGPIOPin(int pinNum, std::string gpioChipname, int line);
 bool loadConfig(const char *configPath);
 static bool ends_with(std::string_view str, std::string_view suffix);
@@ -8,6 +8,9 @@
 
 #define HW_VENDOR meshtastic_HardwareModel_PORTDUINO
 
+#ifndef HAS_CUSTOM_CRYPTO_ENGINE
+#define HAS_CUSTOM_CRYPTO_ENGINE 1
+#endif
 #ifndef HAS_BUTTON
 #define HAS_BUTTON 1
 #endif
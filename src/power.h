@@ -136,6 +136,8 @@ class Power : private concurrency::OSThread
     uint8_t low_voltage_counter;
 #ifdef DEBUG_HEAP
     uint32_t lastheap;
+    uint32_t lastPacketsShared = 0;
+    uint32_t lastPacketStatsMsec = 0;
 #endif
 };
 
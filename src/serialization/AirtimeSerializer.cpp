@@ -0,0 +1,26 @@
+#include "AirtimeSerializer.h"
+#include "airtime.h"
+
+namespace
+{
+template <size_t N> JSONValue *topTalkersToJson(const AirtimeTopTalkers<N> &talkers, const char *keyName)
+{
+    typename AirtimeTopTalkers<N>::Entry top[N];
+    size_t numTop = talkers.getSorted(top, N);
+    JSONArray values;
+    for (size_t i = 0; i < numTop; i++) {
+        JSONObject entry;
+        entry[keyName] = new JSONValue((unsigned int)top[i].key);
+        entry["airtime_ms"] = new JSONValue((unsigned int)top[i].airtimeMs);
+        entry["error_ms"] = new JSONValue((unsigned int)top[i].errorMs);
+        values.push_back(new JSONValue(entry));
+    }
+    return new JSONValue(values);
+}
+} // namespace
+
+void AirtimeSerializer::addTopTalkers(JSONObject &jsonObjAirtime)
+{
+    jsonObjAirtime["top_senders"] = topTalkersToJson(airTime->topSenders, "node");
+    jsonObjAirtime["top_portnums"] = topTalkersToJson(airTime->topPortnums, "portnum");
+}
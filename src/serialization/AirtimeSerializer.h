@@ -0,0 +1,11 @@
+#pragma once
+
+#include "serialization/JSON.h"
+
+/// JSON views of the airtime statistics, shared by the web servers
+class AirtimeSerializer
+{
+  public:
+    /// Add the top_senders and top_portnums arrays to an airtime report object
+    static void addTopTalkers(JSONObject &jsonObjAirtime);
+};
@@ -0,0 +1,145 @@
+#include "DebugConfiguration.h"
+#include "TestUtil.h"
+#include "airtime.h"
+#include "meshtastic/portnums.pb.h"
+#include <unity.h>
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_ranksByAirtime(void)
+{
+    AirtimeTopTalkers<4> talkers;
+    talkers.add(1, 100);
+    talkers.add(2, 300);
+    talkers.add(3, 200);
+    talkers.add(1, 250);
+    TEST_ASSERT_EQUAL(850, talkers.getTotal());
+
+    AirtimeTopTalkers<4>::Entry top[4];
+    TEST_ASSERT_EQUAL(3, talkers.getSorted(top, 4));
+    TEST_ASSERT_EQUAL(1, top[0].key);
+    TEST_ASSERT_EQUAL(350, top[0].airtimeMs);
+    TEST_ASSERT_EQUAL(2, top[1].key);
+    TEST_ASSERT_EQUAL(300, top[1].airtimeMs);
+    TEST_ASSERT_EQUAL(3, top[2].key);
+    TEST_ASSERT_EQUAL(200, top[2].airtimeMs);
+
+    // Asking for fewer gives the largest ones
+    TEST_ASSERT_EQUAL(2, talkers.getSorted(top, 2));
+    TEST_ASSERT_EQUAL(1, top[0].key);
+    TEST_ASSERT_EQUAL(2, top[1].key);
+}
+
+// Once the table is full a new key takes over the smallest slot, and its count is an overestimate by at most errorMs
+void test_newKeyReplacesSmallest(void)
+{
+    AirtimeTopTalkers<2> talkers;
+    talkers.add(1, 100);
+    talkers.add(2, 50);
+    talkers.add(3, 10);
+
+    AirtimeTopTalkers<2>::Entry top[2];
+    TEST_ASSERT_EQUAL(2, talkers.getSorted(top, 2));
+    TEST_ASSERT_EQUAL(1, top[0].key);
+    TEST_ASSERT_EQUAL(0, top[0].errorMs);
+    TEST_ASSERT_EQUAL(3, top[1].key);
+    TEST_ASSERT_EQUAL(60, top[1].airtimeMs);
+    TEST_ASSERT_EQUAL(50, top[1].errorMs);
+    TEST_ASSERT_EQUAL(160, talkers.getTotal());
+}
+
+// A key with more than 1/N of the airtime stays listed, however many small senders come and go
+void test_heavyHitterSurvivesChurn(void)
+{
+    AirtimeTopTalkers<4> talkers;
+    for (uint32_t key = 100; key < 300; key++) {
+        talkers.add(1, 20);
+        talkers.add(key, 10);
+    }
+
+    AirtimeTopTalkers<4>::Entry top[4];
+    TEST_ASSERT_EQUAL(4, talkers.getSorted(top, 4));
+    TEST_ASSERT_EQUAL(1, top[0].key);
+    TEST_ASSERT_EQUAL(4000, top[0].airtimeMs);
+    TEST_ASSERT_EQUAL(0, top[0].errorMs);
+}
+
+// Counts halve every period, so a sender that went quiet drops down and then out of the ranking
+void test_decayExpiresOldTalkers(void)
+{
+    AirtimeTopTalkers<4> talkers;
+    talkers.add(1, 1000);
+    talkers.decay();
+    talkers.decay();
+    talkers.add(2, 300);
+
+    AirtimeTopTalkers<4>::Entry top[4];
+    TEST_ASSERT_EQUAL(2, talkers.getSorted(top, 4));
+    TEST_ASSERT_EQUAL(2, top[0].key);
+    TEST_ASSERT_EQUAL(1, top[1].key);
+    TEST_ASSERT_EQUAL(250, top[1].airtimeMs);
+    TEST_ASSERT_EQUAL(550, talkers.getTotal());
+
+    // 250 ms takes 8 more halvings to reach zero, 300 ms takes 9
+    for (int i = 0; i < 8; i++)
+        talkers.decay();
+    TEST_ASSERT_EQUAL(1, talkers.getSorted(top, 4));
+    TEST_ASSERT_EQUAL(2, top[0].key);
+
+    talkers.decay();
+    TEST_ASSERT_EQUAL(0, talkers.getSorted(top, 4));
+}
+
+// Transmissions are charged to the portnum remembered for them when they were encoded or decoded, if any
+void test_transmitChargesRememberedPortnum(void)
+{
+    AirTime a;
+    a.rememberPortnum(1, 100, meshtastic_PortNum_TEXT_MESSAGE_APP);
+    a.logTransmitAirtime(1, 100, 50);
+    a.logTransmitAirtime(2, 101, 20); // relayed without being decoded
+
+    AirtimeTopTalkers<AIRTIME_TOP_PORTNUMS>::Entry portnums[AIRTIME_TOP_PORTNUMS];
+    TEST_ASSERT_EQUAL(1, a.topPortnums.getSorted(portnums, AIRTIME_TOP_PORTNUMS));
+    TEST_ASSERT_EQUAL(meshtastic_PortNum_TEXT_MESSAGE_APP, portnums[0].key);
+    TEST_ASSERT_EQUAL(50, portnums[0].airtimeMs);
+    TEST_ASSERT_EQUAL(70, a.topSenders.getTotal());
+
+    // Only the most recent packets are remembered
+    for (uint32_t id = 200; id < 200 + AIRTIME_KNOWN_PORTNUMS; id++)
+        a.rememberPortnum(1, id, meshtastic_PortNum_POSITION_APP);
+    a.logTransmitAirtime(1, 100, 50);
+    TEST_ASSERT_EQUAL(50, a.topPortnums.getTotal());
+}
+
+void test_formatTopSenders(void)
+{
+    airTime->topSenders.add(0xa1b2c3d4, 300);
+    airTime->topSenders.add(0x0badf00d, 100);
+
+    char buf[64];
+    airTime->formatTopSenders(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("!a1b2c3d4 75% !0badf00d 25%", buf);
+
+    airTime->formatTopSenders(buf, sizeof(buf), 1);
+    TEST_ASSERT_EQUAL_STRING("!a1b2c3d4 75%", buf);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    if (!airTime)
+        airTime = new AirTime();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_ranksByAirtime);
+    RUN_TEST(test_newKeyReplacesSmallest);
+    RUN_TEST(test_heavyHitterSurvivesChurn);
+    RUN_TEST(test_decayExpiresOldTalkers);
+    RUN_TEST(test_transmitChargesRememberedPortnum);
+    RUN_TEST(test_formatTopSenders);
+    exit(UNITY_END());
+}
+
+void loop() {}
@@ -178,6 +178,81 @@ void test_AES_CTR(void)
     TEST_ASSERT_EQUAL_MEMORY(expected, plain, 16);
 }
 
+// crypto may be a hardware accelerated subclass, it must produce the same bytes as the portable implementation
+void test_AES_CTR_matches_software(void)
+{
+    CryptoEngine software;
+    uint8_t hw[MAX_BLOCKSIZE], sw[MAX_BLOCKSIZE];
+    uint8_t nonce[16];
+    CryptoKey k;
+
+    for (int8_t keyLen : {16, 32}) {
+        k.length = keyLen;
+        for (size_t i = 0; i < sizeof(k.bytes); i++)
+            k.bytes[i] = i * 7 + keyLen;
+        for (size_t numBytes = 0; numBytes <= MAX_BLOCKSIZE; numBytes += 13) {
+            for (size_t i = 0; i < numBytes; i++)
+                hw[i] = sw[i] = i ^ numBytes;
+            // Start near the end of the 32 bit block counter to cover wrap around
+            HexToBytes(nonce, "0102030405060708090A0B0CFFFFFFFA");
+            crypto->encryptAESCtr(k, nonce, numBytes, hw);
+            HexToBytes(nonce, "0102030405060708090A0B0CFFFFFFFA");
+            software.encryptAESCtr(k, nonce, numBytes, sw);
+            TEST_ASSERT_EQUAL_MEMORY(sw, hw, numBytes);
+        }
+    }
+}
+
+void test_AES_CTR_benchmark(void)
+{
+    CryptoEngine software;
+    uint8_t bytes[MAX_BLOCKSIZE] = {0};
+    uint8_t nonce[16] = {0};
+    CryptoKey k = {{0}, 32};
+    const uint32_t iterations = 2000;
+
+    for (size_t numBytes : {16, 64, 128, 237}) {
+        uint32_t start = micros();
+        for (uint32_t i = 0; i < iterations; i++)
+            crypto->encryptAESCtr(k, nonce, numBytes, bytes);
+        uint32_t engineUsec = micros() - start;
+
+        start = micros();
+        for (uint32_t i = 0; i < iterations; i++)
+            software.encryptAESCtr(k, nonce, numBytes, bytes);
+        uint32_t softwareUsec = micros() - start;
+
+        char msg[96];
+        snprintf(msg, sizeof(msg), "AES256-CTR %u bytes: %.3f us/packet, portable %.3f us/packet", (unsigned)numBytes,
+                 (float)engineUsec / iterations, (float)softwareUsec / iterations);
+        TEST_MESSAGE(msg);
+    }
+}
+
+void test_decryptBatch(void)
+{
+    CryptoKey keys[2] = {{{0}, 16}, {{0}, 32}};
+    for (size_t i = 0; i < sizeof(keys[1].bytes); i++)
+        keys[0].bytes[i] = keys[1].bytes[i] = i;
+
+    const size_t numJobs = 6;
+    uint8_t batch[numJobs][64], single[numJobs][64];
+    CryptoEngine::DecryptJob jobs[numJobs];
+    for (size_t i = 0; i < numJobs; i++) {
+        for (size_t j = 0; j < sizeof(batch[i]); j++)
+            batch[i][j] = single[i][j] = i + j;
+        // Jobs are grouped by key, the way callers are expected to pass them
+        jobs[i] = {&keys[i / 4], (uint32_t)(0x1000 + i), 0x12345678 + i, 10 + i * 9, batch[i]};
+    }
+    crypto->decryptBatch(jobs, numJobs);
+
+    for (size_t i = 0; i < numJobs; i++) {
+        crypto->setKey(keys[i / 4]);
+        crypto->decrypt(jobs[i].fromNode, jobs[i].packetId, jobs[i].numBytes, single[i]);
+        TEST_ASSERT_EQUAL_MEMORY(single[i], batch[i], sizeof(batch[i]));
+    }
+}
+
 void setup()
 {
     // NOTE!!! Wait for >2 secs
@@ -191,6 +266,9 @@ void setup()
     RUN_TEST(test_ECB_AES256);
     RUN_TEST(test_DH25519);
     RUN_TEST(test_AES_CTR);
+    RUN_TEST(test_AES_CTR_matches_software);
+    RUN_TEST(test_AES_CTR_benchmark);
+    RUN_TEST(test_decryptBatch);
     RUN_TEST(test_PKC);
     exit(UNITY_END()); // stop unit testing
 }
@@ -0,0 +1,123 @@
+#include "DebugConfiguration.h"
+#include "TestUtil.h"
+#include <unity.h>
+
+#ifdef ARCH_PORTDUINO
+#include "RedirectablePrint.h"
+#include "platform/portduino/PortduinoGlue.h"
+#include <string>
+
+namespace
+{
+class CapturePrint : public Print
+{
+  public:
+    std::string text;
+
+    virtual size_t write(uint8_t c) override
+    {
+        text += (char)c;
+        return 1;
+    }
+};
+
+// Records what would have gone to syslog and BLE, which are no-ops on native
+class CaptureLog : public RedirectablePrint
+{
+  public:
+    std::string syslogText;
+    std::string bleText;
+
+    explicit CaptureLog(Print *dest) : RedirectablePrint(dest) {}
+
+  protected:
+    virtual void log_to_syslog(const char *logLevel, const char *format, va_list arg) override
+    {
+        syslogText += vformat(format, arg);
+    }
+    virtual void log_to_ble(const char *logLevel, const char *format, va_list arg) override { bleText += vformat(format, arg); }
+
+  private:
+    static std::string vformat(const char *format, va_list arg)
+    {
+        char buf[128];
+        va_list copy;
+        va_copy(copy, arg);
+        vsnprintf(buf, sizeof(buf), format, copy);
+        va_end(copy);
+        return buf;
+    }
+};
+
+// The deferred writer thread keeps a reference to its RedirectablePrint, so these are never freed
+CaptureLog *makeLog(CapturePrint *dest, bool deferred)
+{
+    settingsMap[deferred_logs] = deferred;
+    CaptureLog *out = new CaptureLog(dest);
+    out->rpInit();
+    return out;
+}
+} // namespace
+
+void setUp(void)
+{
+    settingsMap[logoutputlevel] = level_debug;
+    settingsMap[ascii_logs] = true;
+}
+
+void tearDown(void)
+{
+    settingsMap[deferred_logs] = false;
+}
+
+void test_immediateLogReachesAllSinks(void)
+{
+    CapturePrint *serial = new CapturePrint();
+    CaptureLog *out = makeLog(serial, false);
+    out->log(MESHTASTIC_LOG_LEVEL_INFO, "immediate %d", 42);
+
+    TEST_ASSERT_EQUAL_STRING("immediate 42\n", serial->text.c_str() + serial->text.find("immediate"));
+    TEST_ASSERT_EQUAL_STRING("immediate 42\n", out->syslogText.c_str());
+    TEST_ASSERT_EQUAL_STRING("immediate 42\n", out->bleText.c_str());
+}
+
+// Only the console write moves to the writer thread, syslog and BLE still see every record
+void test_deferredLogReachesAllSinks(void)
+{
+    CapturePrint *serial = new CapturePrint();
+    CaptureLog *out = makeLog(serial, true);
+    out->log(MESHTASTIC_LOG_LEVEL_INFO, "deferred %d", 42);
+    out->log(MESHTASTIC_LOG_LEVEL_WARN, "deferred %s", "again");
+
+    TEST_ASSERT_EQUAL_STRING("deferred 42\ndeferred again\n", out->syslogText.c_str());
+    TEST_ASSERT_EQUAL_STRING("deferred 42\ndeferred again\n", out->bleText.c_str());
+
+    out->flushDeferredLog();
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, serial->text.find("deferred 42\n"));
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, serial->text.find("deferred again\n"));
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_immediateLogReachesAllSinks);
+    RUN_TEST(test_deferredLogReachesAllSinks);
+    exit(UNITY_END());
+}
+
+#else
+void setUp(void) {}
+void tearDown(void) {}
+
+void setup()
+{
+    initializeTestEnvironment();
+    LOG_WARN("This test requires ARCH_PORTDUINO");
+    UNITY_BEGIN();
+    UNITY_END();
+}
+#endif
+
+void loop() {}
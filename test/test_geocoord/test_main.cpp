@@ -0,0 +1,75 @@
+#include "DebugConfiguration.h"
+#include "TestUtil.h"
+#include "gps/GeoCoord.h"
+#include <unity.h>
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// Precision 0 (not set) and 32 (full) leave the position alone
+void test_fullPrecisionUnchanged(void)
+{
+    for (uint32_t precision : {0u, 32u, 33u}) {
+        int32_t latitude = -338688000, longitude = 1512093000;
+        GeoCoord::applyPrecision(latitude, longitude, precision);
+        TEST_ASSERT_EQUAL(-338688000, latitude);
+        TEST_ASSERT_EQUAL(1512093000, longitude);
+    }
+}
+
+// One bit only keeps the hemisphere, the result is the middle of it
+void test_oneBit(void)
+{
+    int32_t latitude = 473977420, longitude = -1224194000;
+    GeoCoord::applyPrecision(latitude, longitude, 1);
+    TEST_ASSERT_EQUAL(1 << 30, latitude);
+    TEST_ASSERT_EQUAL(-(1 << 30), longitude);
+}
+
+// 31 bits clears the lowest bit and moves to the middle of the two possible values
+void test_thirtyOneBits(void)
+{
+    int32_t latitude = 473977420, longitude = -1224194000;
+    GeoCoord::applyPrecision(latitude, longitude, 31);
+    TEST_ASSERT_EQUAL(473977421, latitude);
+    TEST_ASSERT_EQUAL(-1224193999, longitude);
+
+    latitude = 473977421;
+    longitude = -1224194001;
+    GeoCoord::applyPrecision(latitude, longitude, 31);
+    TEST_ASSERT_EQUAL(473977421, latitude);
+    TEST_ASSERT_EQUAL(-1224194001, longitude);
+}
+
+// Negative coordinates are truncated towards minus infinity like positive ones, so both land in the middle of their cell
+void test_negativeCoordinates(void)
+{
+    int32_t latitude = -338688000, longitude = -1224194000;
+    GeoCoord::applyPrecision(latitude, longitude, 14);
+    TEST_ASSERT_EQUAL(-338558976, latitude);
+    TEST_ASSERT_EQUAL(-1224081408, longitude);
+
+    // 14 bits leaves cells of 2^18, the latitude lies in the one starting at -1292 * 2^18
+    TEST_ASSERT_EQUAL(-1292 * (1 << 18) + (1 << 17), latitude);
+
+    latitude = 473977420;
+    longitude = 85455570;
+    GeoCoord::applyPrecision(latitude, longitude, 14);
+    TEST_ASSERT_EQUAL(474087424, latitude);
+    TEST_ASSERT_EQUAL(85327872, longitude);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_fullPrecisionUnchanged);
+    RUN_TEST(test_oneBit);
+    RUN_TEST(test_thirtyOneBits);
+    RUN_TEST(test_negativeCoordinates);
+    exit(UNITY_END());
+}
+
+void loop() {}
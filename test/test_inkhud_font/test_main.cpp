@@ -0,0 +1,198 @@
+#include "DebugConfiguration.h"
+#include "TestUtil.h"
+#include <unity.h>
+
+#if defined(MESHTASTIC_INCLUDE_INKHUD) || defined(MESHTASTIC_INCLUDE_INKHUD_FONT)
+#include "graphics/niche/InkHUD/AppletFont.h"
+
+#include <string.h>
+#include <string>
+
+using namespace NicheGraphics;
+
+// A chat message with a mix of plain ASCII and Western European accents, the usual case
+static const char *message = "Grüezi mitenand! Treffpunkt ist um 14:00 bei der Brücke, südlich vom Café. "
+                             "Bitte Funkgerät mitnehmen und auf Kanal 2 bleiben, wir melden uns beim Eintreffen.";
+
+// Central European, most letters are ASCII but many words have a diacritic
+static const char *messageCzech = "Sraz je ve 14:00 u mostu, jižně od kavárny. Vezměte si vysílačku, zůstaňte na kanálu 2 "
+                                  "a ozvěte se, až dorazíte. Přijďte včas, čekáme jen čtvrt hodiny.";
+
+// Cyrillic, almost every char takes two bytes
+static const char *messageRussian = "Встречаемся в 14:00 у моста, к югу от кафе. Возьмите рацию, оставайтесь на канале 2 "
+                                    "и сообщите, когда прибудете.";
+
+static InkHUD::AppletFont font;     // Windows-1252
+static InkHUD::AppletFont font1250; // Windows-1250
+static InkHUD::AppletFont font1251; // Windows-1251
+
+// The decoder as it was before it worked in place: a std::string per UTF-8 char, appended to the result one char at a time.
+// Each char is remapped through the buffer overload, which does the same toUtf32() and applyEncoding() as the old code did.
+static std::string decodeUTF8PerChar(InkHUD::AppletFont &f, const std::string &encoded)
+{
+    std::string decoded;
+    std::string utf8Char;
+    uint8_t utf8CharSize = 0;
+
+    for (const char &c : encoded) {
+        if (utf8Char.empty()) {
+            if ((c & 0x80)) {
+                char c1 = c;
+                while (c1 & 0x80) {
+                    c1 <<= 1;
+                    utf8CharSize++;
+                }
+            }
+        }
+        utf8Char += c;
+        if (utf8Char.length() < utf8CharSize)
+            continue;
+
+        char remapped;
+        if (f.decodeUTF8(utf8Char.data(), utf8Char.length(), &remapped) == 1)
+            decoded += remapped;
+        utf8Char.clear();
+        utf8CharSize = 0;
+    }
+    return decoded;
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_decodesWin1252(void)
+{
+    char out[16];
+    size_t length = font.decodeUTF8("Br\xC3\xBC"
+                                    "cke",
+                                    7, out);
+    TEST_ASSERT_EQUAL(6, length);
+    TEST_ASSERT_EQUAL_MEMORY("Br\xFC"
+                             "cke",
+                             out, 6);
+}
+
+void test_decodesWin1250(void)
+{
+    char out[16];
+    size_t length = font1250.decodeUTF8("\xC5\x81\xC3\xB3" // Łó
+                                        "d"
+                                        "\xC5\xBA", // ź
+                                        7, out);
+    TEST_ASSERT_EQUAL(4, length);
+    TEST_ASSERT_EQUAL_MEMORY("\xA3\xF3"
+                             "d"
+                             "\x9F",
+                             out, 4);
+}
+
+void test_decodesWin1251(void)
+{
+    char out[16];
+    size_t length = font1251.decodeUTF8("\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82", 12, out); // Привет
+    TEST_ASSERT_EQUAL(6, length);
+    TEST_ASSERT_EQUAL_MEMORY("\xCF\xF0\xE8\xE2\xE5\xF2", out, 6);
+}
+
+// Characters the font doesn't have become SUB, which is how Applet::isPrintable spots them
+void test_unmappedBecomesSub(void)
+{
+    char out[8];
+    size_t length = font.decodeUTF8("\xE4\xB8\xAD", 3, out); // CJK, no 8-bit font has it
+    TEST_ASSERT_EQUAL(1, length);
+    TEST_ASSERT_EQUAL_HEX8(0x1A, out[0]);
+}
+
+// A char cut short at the end of the text is dropped, rather than read past the end
+void test_truncatedCharIsDropped(void)
+{
+    char out[8];
+    size_t length = font.decodeUTF8("ab\xC3", 3, out);
+    TEST_ASSERT_EQUAL(2, length);
+}
+
+// Applet::parse() decodes into the same buffer it reads from
+void test_decodesInPlace(void)
+{
+    std::string text = message;
+    text.resize(font.decodeUTF8(text.data(), text.length(), &text[0]));
+    TEST_ASSERT_EQUAL_STRING(font.decodeUTF8(std::string(message)).c_str(), text.c_str());
+}
+
+// Same output as the old per-char decoder, for every corpus
+void test_matchesPerCharDecoder(void)
+{
+    TEST_ASSERT_EQUAL_STRING(decodeUTF8PerChar(font, message).c_str(), font.decodeUTF8(std::string(message)).c_str());
+    TEST_ASSERT_EQUAL_STRING(decodeUTF8PerChar(font1250, messageCzech).c_str(),
+                             font1250.decodeUTF8(std::string(messageCzech)).c_str());
+    TEST_ASSERT_EQUAL_STRING(decodeUTF8PerChar(font1251, messageRussian).c_str(),
+                             font1251.decodeUTF8(std::string(messageRussian)).c_str());
+}
+
+static void benchmarkDecode(const char *name, InkHUD::AppletFont &f, const char *text)
+{
+    const uint32_t iterations = 10000;
+    const size_t length = strlen(text);
+    const std::string encoded = text;
+    char out[512];
+    TEST_ASSERT_TRUE(length <= sizeof(out));
+    size_t total = 0;
+
+    uint32_t start = micros();
+    for (uint32_t i = 0; i < iterations; i++)
+        total += decodeUTF8PerChar(f, encoded).length();
+    const uint32_t perChar = micros() - start;
+
+    start = micros();
+    for (uint32_t i = 0; i < iterations; i++)
+        total += f.decodeUTF8(encoded).length();
+    const uint32_t withString = micros() - start;
+
+    start = micros();
+    for (uint32_t i = 0; i < iterations; i++)
+        total += f.decodeUTF8(text, length, out);
+    const uint32_t withBuffer = micros() - start;
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "%s, %u bytes: per char %.2f us, std::string %.2f us, buffer %.2f us (%u)", name,
+             (unsigned)length, (float)perChar / iterations, (float)withString / iterations, (float)withBuffer / iterations,
+             (unsigned)total);
+    TEST_MESSAGE(msg);
+}
+
+void test_benchmarkDecode(void)
+{
+    benchmarkDecode("Windows-1252", font, message);
+    benchmarkDecode("Windows-1250", font1250, messageCzech);
+    benchmarkDecode("Windows-1251", font1251, messageRussian);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    font = FREESANS_9PT_WIN1252;
+    font1250 = FREESANS_9PT_WIN1250;
+    font1251 = FREESANS_9PT_WIN1251;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_decodesWin1252);
+    RUN_TEST(test_decodesWin1250);
+    RUN_TEST(test_decodesWin1251);
+    RUN_TEST(test_unmappedBecomesSub);
+    RUN_TEST(test_truncatedCharIsDropped);
+    RUN_TEST(test_decodesInPlace);
+    RUN_TEST(test_matchesPerCharDecoder);
+    RUN_TEST(test_benchmarkDecode);
+    exit(UNITY_END());
+}
+#else
+void setup()
+{
+    initializeTestEnvironment();
+    LOG_WARN("This test requires MESHTASTIC_INCLUDE_INKHUD or MESHTASTIC_INCLUDE_INKHUD_FONT (env:coverage)");
+    UNITY_BEGIN();
+    UNITY_END();
+}
+#endif
+void loop() {}
@@ -0,0 +1,113 @@
+#include "TestUtil.h"
+#include "mesh/MemoryPool.h"
+#include <unity.h>
+
+#if ARCH_PORTDUINO
+#include <thread>
+#include <vector>
+#endif
+
+struct Packet {
+    uint32_t id;
+    uint8_t payload[32];
+};
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_retainSharesStorage(void)
+{
+    MemoryDynamic<Packet> pool;
+    Packet *p = pool.allocZeroed();
+    TEST_ASSERT_FALSE(pool.isShared(p));
+
+    Packet *q = pool.retain(p);
+    TEST_ASSERT_TRUE(q == p);
+    TEST_ASSERT_TRUE(pool.isShared(p));
+    TEST_ASSERT_EQUAL(1, pool.getNumShared());
+
+    pool.release(q);
+    TEST_ASSERT_FALSE(pool.isShared(p));
+    pool.release(p);
+}
+
+void test_makeWritableUnsharedIsInPlace(void)
+{
+    MemoryDynamic<Packet> pool;
+    Packet *p = pool.allocZeroed();
+    TEST_ASSERT_TRUE(pool.makeWritable(p) == p);
+    TEST_ASSERT_EQUAL(0, pool.getNumCopiedOnWrite());
+    pool.release(p);
+}
+
+// The writer gets a private copy and the other owner keeps seeing the original
+void test_makeWritableSharedCopies(void)
+{
+    MemoryDynamic<Packet> pool;
+    Packet *p = pool.allocZeroed();
+    p->id = 42;
+    Packet *other = pool.retain(p);
+
+    Packet *w = pool.makeWritable(p);
+    TEST_ASSERT_TRUE(w != other);
+    TEST_ASSERT_EQUAL(42, w->id);
+    TEST_ASSERT_EQUAL(1, pool.getNumCopiedOnWrite());
+
+    w->id = 7;
+    TEST_ASSERT_EQUAL(42, other->id);
+    TEST_ASSERT_FALSE(pool.isShared(other)); // makeWritable dropped the writer's reference
+    TEST_ASSERT_FALSE(pool.isShared(w));
+
+    pool.release(w);
+    pool.release(other);
+}
+
+// Objects are kept at malloc()'s alignment, in spite of the count in front of them
+void test_objectIsAligned(void)
+{
+    MemoryDynamic<Packet> pool;
+    Packet *p = pool.allocZeroed();
+    TEST_ASSERT_EQUAL(0, (uintptr_t)p % alignof(max_align_t));
+    pool.release(p);
+}
+
+#if ARCH_PORTDUINO
+// Like the web server's phone API threads, several threads taking and dropping references to packets from the main loop
+void test_concurrentRetainRelease(void)
+{
+    const int threads = 4, rounds = 20000;
+    MemoryDynamic<Packet> pool;
+    Packet *p = pool.allocZeroed();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&]() {
+            for (int i = 0; i < rounds; i++)
+                pool.release(pool.retain(p));
+        });
+    }
+    for (auto &w : workers)
+        w.join();
+
+    TEST_ASSERT_FALSE(pool.isShared(p));
+    TEST_ASSERT_EQUAL(threads * rounds, pool.getNumShared());
+    pool.release(p);
+}
+#endif
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_retainSharesStorage);
+    RUN_TEST(test_makeWritableUnsharedIsInPlace);
+    RUN_TEST(test_makeWritableSharedCopies);
+    RUN_TEST(test_objectIsAligned);
+#if ARCH_PORTDUINO
+    RUN_TEST(test_concurrentRetainRelease);
+#endif
+    exit(UNITY_END());
+}
+
+void loop() {}
@@ -0,0 +1,171 @@
+#include "DebugConfiguration.h"
+#include "TestUtil.h"
+#include <unity.h>
+
+#ifdef ARCH_PORTDUINO
+#include "FloodingRouter.h"
+#include "MeshRadio.h"
+#include "MeshService.h"
+#include "airtime.h"
+#include "mesh/Channels.h"
+#include "modules/RoutingModule.h"
+#include "platform/portduino/MeshSimulator.h"
+
+namespace
+{
+// The simulator only asks the live radio for timing, nothing is ever sent on it
+class NullRadio : public RadioInterface
+{
+  public:
+    virtual ErrorCode send(meshtastic_MeshPacket *p) override
+    {
+        packetPool.release(p);
+        return ERRNO_OK;
+    }
+};
+
+NullRadio *radio;
+
+// Two nodes a few meters apart, so every transmission is heard
+MeshSimulator::Config closePair()
+{
+    MeshSimulator::Config c;
+    c.numNodes = 2;
+    c.areaMeters = 10;
+    c.shadowingDb = 0;
+    c.routerFraction = 0;
+    c.numPackets = 10;
+    c.hopLimit = 0;
+    return c;
+}
+} // namespace
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_sameSeedSameResults(void)
+{
+    MeshSimulator::Config c;
+    c.numNodes = 30;
+    c.numPackets = 20;
+
+    MeshSimulator::Results a = MeshSimulator(*radio, c).run();
+    MeshSimulator::Results b = MeshSimulator(*radio, c).run();
+    TEST_ASSERT_EQUAL(a.transmissions, b.transmissions);
+    TEST_ASSERT_EQUAL(a.rxGood, b.rxGood);
+    TEST_ASSERT_EQUAL(a.rxCollided, b.rxCollided);
+    TEST_ASSERT_EQUAL(a.durationMsec, b.durationMsec);
+    TEST_ASSERT_EQUAL_FLOAT(a.meanCoverage, b.meanCoverage);
+}
+
+// With no hops left, each packet is sent once by its origin and reaches the other node
+void test_hopLimitZeroIsNotRelayed(void)
+{
+    MeshSimulator::Config c = closePair();
+    MeshSimulator::Results r = MeshSimulator(*radio, c).run();
+    TEST_ASSERT_EQUAL(c.numPackets, r.originated);
+    TEST_ASSERT_EQUAL(r.originated, r.transmissions);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, r.meanCoverage);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, r.meanRelaysPerPacket);
+}
+
+void test_mutedNodesDoNotRelay(void)
+{
+    MeshSimulator::Config c = closePair();
+    c.numNodes = 5;
+    c.hopLimit = 3;
+    c.muteFraction = 1;
+    MeshSimulator::Results r = MeshSimulator(*radio, c).run();
+    TEST_ASSERT_EQUAL(r.originated, r.transmissions);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, r.meanCoverage);
+}
+
+void test_outOfRangeIsNotReached(void)
+{
+    MeshSimulator::Config c = closePair();
+    c.areaMeters = 1000000;
+    c.seed = 2;
+    MeshSimulator::Results r = MeshSimulator(*radio, c).run();
+    TEST_ASSERT_EQUAL(0, r.rxGood);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, r.meanCoverage);
+}
+
+// Three nodes in earshot of each other and one hop: the first relay out makes the third node cancel its own
+void test_clientsCancelDuplicateRelays(void)
+{
+    MeshSimulator::Config c = closePair();
+    c.numNodes = 3;
+    c.hopLimit = 1;
+    MeshSimulator::Results r = MeshSimulator(*radio, c).run();
+    TEST_ASSERT_EQUAL(2 * r.originated, r.transmissions);
+    TEST_ASSERT_EQUAL(r.originated, r.relaysCanceled);
+    // Both the origin and the node that canceled hear the relay as a dupe
+    TEST_ASSERT_EQUAL(2 * r.originated, r.rxDupe);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, r.meanCoverage);
+}
+
+// Routers keep their rebroadcast when they hear somebody else's, so every one of them relays
+void test_routersDoNotCancelRelays(void)
+{
+    MeshSimulator::Config c = closePair();
+    c.numNodes = 3;
+    c.hopLimit = 1;
+    c.routerFraction = 1;
+    MeshSimulator::Results r = MeshSimulator(*radio, c).run();
+    TEST_ASSERT_EQUAL(3 * r.originated, r.transmissions);
+    TEST_ASSERT_EQUAL(0, r.relaysCanceled);
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, r.meanRelaysPerPacket);
+}
+
+// The relay tests above depend on which roles cancel dupes and rebroadcast
+void test_roleRules(void)
+{
+    TEST_ASSERT_TRUE(FloodingRouter::roleCancelsDupes(meshtastic_Config_DeviceConfig_Role_CLIENT));
+    TEST_ASSERT_FALSE(FloodingRouter::roleCancelsDupes(meshtastic_Config_DeviceConfig_Role_ROUTER));
+    TEST_ASSERT_FALSE(FloodingRouter::roleCancelsDupes(meshtastic_Config_DeviceConfig_Role_ROUTER_LATE));
+
+    TEST_ASSERT_TRUE(FloodingRouter::roleRebroadcasts(meshtastic_Config_DeviceConfig_Role_CLIENT,
+                                                      meshtastic_Config_DeviceConfig_RebroadcastMode_ALL));
+    TEST_ASSERT_FALSE(FloodingRouter::roleRebroadcasts(meshtastic_Config_DeviceConfig_Role_CLIENT_MUTE,
+                                                       meshtastic_Config_DeviceConfig_RebroadcastMode_ALL));
+    TEST_ASSERT_FALSE(FloodingRouter::roleRebroadcasts(meshtastic_Config_DeviceConfig_Role_ROUTER,
+                                                       meshtastic_Config_DeviceConfig_RebroadcastMode_NONE));
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    if (!airTime)
+        airTime = new AirTime();
+    nodeDB = new NodeDB();
+    service = new MeshService();
+    routingModule = new RoutingModule();
+    channels.initDefaults();
+    channels.onConfigChanged();
+    config.lora.region = meshtastic_Config_LoRaConfig_RegionCode_US;
+    initRegion();
+    radio = new NullRadio();
+    radio->reconfigure();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_sameSeedSameResults);
+    RUN_TEST(test_hopLimitZeroIsNotRelayed);
+    RUN_TEST(test_mutedNodesDoNotRelay);
+    RUN_TEST(test_outOfRangeIsNotReached);
+    RUN_TEST(test_clientsCancelDuplicateRelays);
+    RUN_TEST(test_routersDoNotCancelRelays);
+    RUN_TEST(test_roleRules);
+    delete radio;
+    exit(UNITY_END());
+}
+#else
+void setup()
+{
+    initializeTestEnvironment();
+    LOG_WARN("This test requires ARCH_PORTDUINO");
+    UNITY_BEGIN();
+    UNITY_END();
+}
+#endif
+void loop() {}
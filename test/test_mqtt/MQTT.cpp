@@ -3,6 +3,8 @@
 #include <unity.h>
 
 #ifdef ARCH_PORTDUINO
+#include "gps/GeoCoord.h"
+#include "gps/RTC.h"
 #include "mesh/CryptoEngine.h"
 #include "mesh/Default.h"
 #include "mesh/MeshService.h"
@@ -11,6 +13,7 @@
 #include "modules/RoutingModule.h"
 #include "mqtt/MQTT.h"
 #include "mqtt/ServiceEnvelope.h"
+#include "mqtt/TopicTrie.h"
 
 #include <PubSubClient.h>
 #include <WiFiClient.h>
@@ -257,10 +260,12 @@ class MQTTUnitTest : public MQTT
         map_publish_interval_msecs = 0;
         perhapsReportToMap();
     }
-    void publish(const meshtastic_MeshPacket *p, std::string gateway = "!87654321", std::string channel = "test")
+    // Publish p in an envelope for channel, on the topic of topicChannel (the same channel unless given)
+    void publish(const meshtastic_MeshPacket *p, std::string gateway = "!87654321", std::string channel = "test",
+                 const char *topicChannel = NULL)
     {
         std::stringstream topic;
-        topic << "msh/2/e/" << channel << "/!" << gateway;
+        topic << "msh/2/e/" << (topicChannel ? topicChannel : channel) << "/!" << gateway;
         const meshtastic_ServiceEnvelope env = {.packet = const_cast<meshtastic_MeshPacket *>(p),
                                                 .channel_id = const_cast<char *>(channel.c_str()),
                                                 .gateway_id = const_cast<char *>(gateway.c_str())};
@@ -303,6 +308,40 @@ const meshtastic_MeshPacket encrypted = {
     .encrypted = {.size = 0},
     .id = 3,
 };
+
+// Give channel index a 16 byte PSK, derived from seed, and recompute the channel hashes.
+void setChannelKey(ChannelIndex index, uint8_t seed)
+{
+    meshtastic_ChannelSettings &settings = channelFile.channels[index].settings;
+    settings.psk.size = 16;
+    for (uint8_t i = 0; i < 16; i++)
+        settings.psk.bytes[i] = seed + i;
+    channels.onConfigChanged();
+}
+
+// A text message encrypted the way another node would send it on channel index.
+meshtastic_MeshPacket makeEncrypted(PacketId id, const char *text, ChannelIndex index)
+{
+    meshtastic_Data data = meshtastic_Data_init_default;
+    data.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
+    data.payload.size = strlen(text);
+    memcpy(data.payload.bytes, text, data.payload.size);
+
+    meshtastic_MeshPacket p = encrypted;
+    p.id = id;
+    p.channel = channels.getHash(index);
+    p.encrypted.size = pb_encode_to_bytes(p.encrypted.bytes, sizeof(p.encrypted.bytes), &meshtastic_Data_msg, &data);
+    crypto->setKey(channels.getKey(index));
+    crypto->encryptPacket(p.from, p.id, p.encrypted.size, p.encrypted.bytes);
+    return p;
+}
+
+void assertText(const char *text, const meshtastic_MeshPacket &p)
+{
+    TEST_ASSERT_EQUAL(meshtastic_MeshPacket_decoded_tag, p.which_payload_variant);
+    TEST_ASSERT_EQUAL(strlen(text), p.decoded.payload.size);
+    TEST_ASSERT_EQUAL_MEMORY(text, p.decoded.payload.bytes, p.decoded.payload.size);
+}
 } // namespace
 
 // Initialize mocks and configuration before running each test.
@@ -562,6 +601,75 @@ void test_receiveWithoutChannelDownlink(void)
     TEST_ASSERT_TRUE(mockRouter->packets_.empty());
 }
 
+// Packets on a secondary channel are routed to that channel's index.
+void test_receiveOnSecondaryChannel(void)
+{
+    channelFile.channels[1] = meshtastic_Channel{
+        .index = 1,
+        .has_settings = true,
+        .settings = {.name = "second", .uplink_enabled = true, .downlink_enabled = true},
+        .role = meshtastic_Channel_Role_SECONDARY,
+    };
+    channelFile.channels_count = 2;
+    mqtt->onChannelsChanged();
+
+    unitTest->publish(&decoded, "!87654321", "second");
+
+    TEST_ASSERT_EQUAL(1, mockRouter->packets_.size());
+    const meshtastic_MeshPacket &p = mockRouter->packets_.front();
+    TEST_ASSERT_EQUAL(decoded.id, p.id);
+    TEST_ASSERT_EQUAL(1, p.channel);
+    TEST_ASSERT_TRUE(pubsub->subscriptions_.count("msh/2/e/second/+"));
+}
+
+// The envelope's channel_id decides the channel, even when the packet arrives on another channel's topic.
+void test_receiveEnvelopeChannelOverridesTopic(void)
+{
+    channelFile.channels[1] = meshtastic_Channel{
+        .index = 1,
+        .has_settings = true,
+        .settings = {.name = "second", .uplink_enabled = true, .downlink_enabled = true},
+        .role = meshtastic_Channel_Role_SECONDARY,
+    };
+    channelFile.channels_count = 2;
+    setChannelKey(1, 0x50);
+    const meshtastic_MeshPacket e = makeEncrypted(50, "second", 1);
+
+    unitTest->publish(&e, "!87654321", "second", "test");
+
+    TEST_ASSERT_TRUE(loopUntil([] { return !mockRouter->packets_.empty(); }));
+    TEST_ASSERT_EQUAL(1, mockRouter->packets_.size());
+    const meshtastic_MeshPacket &p = mockRouter->packets_.front();
+    TEST_ASSERT_EQUAL(50, p.id);
+    assertText("second", p);
+    TEST_ASSERT_EQUAL(1, p.channel);
+
+    // So it is dropped when the channel it names doesn't allow downlink, whatever the topic
+    mockRouter->packets_.clear();
+    channelFile.channels[1].settings.downlink_enabled = false;
+    unitTest->publish(&decoded, "!87654321", "second", "test");
+    TEST_ASSERT_TRUE(mockRouter->packets_.empty());
+}
+
+// Topic filters resolve to their channel, wildcards only match where expected.
+void test_topicTrieMatches(void)
+{
+    TopicTrie trie;
+    trie.insert("msh/US/2/e/PKI/+", {TopicTrie::Kind::PKI, 0});
+    trie.insert("msh/US/2/e/LongFast/+", {TopicTrie::Kind::ENCRYPTED, 0});
+    trie.insert("msh/US/2/e/mqtt/+", {TopicTrie::Kind::ENCRYPTED, 1});
+    trie.insert("msh/US/2/json/mqtt/+", {TopicTrie::Kind::JSON, 1});
+
+    TopicTrie::Match m = trie.match("msh/US/2/e/mqtt/!12345678");
+    TEST_ASSERT_EQUAL(TopicTrie::Kind::ENCRYPTED, m.kind);
+    TEST_ASSERT_EQUAL(1, m.channel);
+    TEST_ASSERT_EQUAL(TopicTrie::Kind::PKI, trie.match("msh/US/2/e/PKI/!12345678").kind);
+    TEST_ASSERT_EQUAL(TopicTrie::Kind::JSON, trie.match("msh/US/2/json/mqtt/!12345678").kind);
+    TEST_ASSERT_EQUAL(TopicTrie::Kind::NONE, trie.match("msh/US/2/e/mqtt").kind);
+    TEST_ASSERT_EQUAL(TopicTrie::Kind::NONE, trie.match("msh/US/2/e/mqtt/!12345678/extra").kind);
+    TEST_ASSERT_EQUAL(TopicTrie::Kind::NONE, trie.match("msh/EU/2/e/mqtt/!12345678").kind);
+}
+
 // Test receiving an encrypted MeshPacket on the PKI topic.
 void test_receiveEncryptedPKITopicToUs(void)
 {
@@ -576,6 +684,113 @@ void test_receiveEncryptedPKITopicToUs(void)
     TEST_ASSERT_TRUE(p.via_mqtt);
 }
 
+// Encrypted downlink is decrypted in batches, without reordering it against decoded downlink arriving in between.
+void test_receiveEncryptedKeepsOrder(void)
+{
+    setChannelKey(0, 0x10);
+    const meshtastic_MeshPacket first = makeEncrypted(20, "first", 0);
+    const meshtastic_MeshPacket second = makeEncrypted(21, "second", 0);
+    const meshtastic_MeshPacket last = makeEncrypted(22, "last", 0);
+
+    unitTest->publish(&first);
+    unitTest->publish(&second);
+    unitTest->publish(&decoded);
+    unitTest->publish(&last);
+
+    TEST_ASSERT_TRUE(loopUntil([] { return mockRouter->packets_.size() == 4; }));
+    auto it = mockRouter->packets_.begin();
+    TEST_ASSERT_EQUAL(20, it->id);
+    assertText("first", *it++);
+    TEST_ASSERT_EQUAL(21, it->id);
+    assertText("second", *it++);
+    TEST_ASSERT_EQUAL(decoded.id, it++->id);
+    TEST_ASSERT_EQUAL(22, it->id);
+    assertText("last", *it);
+    TEST_ASSERT_TRUE(it->via_mqtt);
+    TEST_ASSERT_EQUAL(0, it->channel);
+}
+
+// Packets we have no key for are dropped from the batch, the rest still get through.
+void test_receiveEncryptedDropsUndecryptable(void)
+{
+    setChannelKey(0, 0x20);
+    const meshtastic_MeshPacket good = makeEncrypted(30, "good", 0);
+    meshtastic_MeshPacket bad = makeEncrypted(31, "bad", 0);
+    bad.encrypted.bytes[0] ^= 0xff; // no longer decrypts to a valid protobuf
+    const meshtastic_MeshPacket alsoGood = makeEncrypted(32, "also good", 0);
+
+    meshtastic_MqttClientProxyMessage message = meshtastic_MqttClientProxyMessage_init_default;
+    strcat(message.topic, "msh/2/e/test/!87654321");
+    message.which_payload_variant = meshtastic_MqttClientProxyMessage_data_tag;
+    const meshtastic_MeshPacket *burst[] = {&good, &bad, &alsoGood};
+    for (const meshtastic_MeshPacket *p : burst) {
+        const meshtastic_ServiceEnvelope env = {
+            .packet = const_cast<meshtastic_MeshPacket *>(p), .channel_id = "test", .gateway_id = "!87654321"};
+        message.payload_variant.data.size =
+            pb_encode_to_bytes(message.payload_variant.data.bytes, sizeof(message.payload_variant.data.bytes),
+                               &meshtastic_ServiceEnvelope_msg, &env);
+        mqtt->onClientProxyReceive(message);
+    }
+
+    TEST_ASSERT_EQUAL(2, mockRouter->packets_.size());
+    TEST_ASSERT_EQUAL(30, mockRouter->packets_.front().id);
+    assertText("good", mockRouter->packets_.front());
+    TEST_ASSERT_EQUAL(32, mockRouter->packets_.back().id);
+    assertText("also good", mockRouter->packets_.back());
+}
+
+// perhapsDecodeBatch() gives the same results as decoding the packets one at a time, in the order they were passed.
+void test_perhapsDecodeBatch(void)
+{
+    channelFile.channels[1] = meshtastic_Channel{
+        .index = 1,
+        .has_settings = true,
+        .settings = {.name = "second", .uplink_enabled = true, .downlink_enabled = true},
+        .role = meshtastic_Channel_Role_SECONDARY,
+    };
+    channelFile.channels_count = 2;
+    setChannelKey(1, 0x40);
+    setChannelKey(0, 0x30);
+
+    meshtastic_MeshPacket in[6] = {
+        makeEncrypted(40, "zero", 1), makeEncrypted(41, "one", 0), decoded, makeEncrypted(43, "three", 1),
+        makeEncrypted(44, "four", 0), makeEncrypted(45, "five", 0),
+    };
+    // A hash none of our channels have
+    in[5].channel = 0;
+    while (in[5].channel == channels.getHash(0) || in[5].channel == channels.getHash(1))
+        in[5].channel++;
+    meshtastic_MeshPacket batch[6], single[6];
+    meshtastic_MeshPacket *packets[6];
+    DecodeState results[6];
+    for (size_t i = 0; i < 6; i++) {
+        batch[i] = single[i] = in[i];
+        packets[i] = &batch[i];
+    }
+
+    perhapsDecodeBatch(packets, 6, results);
+
+    const char *texts[] = {"zero", "one", NULL, "three", "four"};
+    const ChannelIndex channel[] = {1, 0, 0, 1, 0};
+    for (size_t i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL(DecodeState::DECODE_SUCCESS, results[i]);
+        if (texts[i]) {
+            assertText(texts[i], batch[i]);
+            TEST_ASSERT_EQUAL(channel[i], batch[i].channel);
+        }
+    }
+    TEST_ASSERT_EQUAL(DecodeState::DECODE_FAILURE, results[5]);
+    TEST_ASSERT_EQUAL(meshtastic_MeshPacket_encrypted_tag, batch[5].which_payload_variant);
+
+    for (size_t i = 0; i < 6; i++) {
+        TEST_ASSERT_EQUAL(results[i], perhapsDecode(&single[i]));
+        TEST_ASSERT_EQUAL(single[i].which_payload_variant, batch[i].which_payload_variant);
+        TEST_ASSERT_EQUAL(single[i].channel, batch[i].channel);
+        if (results[i] == DecodeState::DECODE_SUCCESS)
+            TEST_ASSERT_EQUAL_MEMORY(&single[i].decoded, &batch[i].decoded, sizeof(single[i].decoded));
+    }
+}
+
 // Should ignore messages published to MQTT by this gateway.
 void test_receiveIgnoresOwnPublishedMessages(void)
 {
@@ -725,6 +940,64 @@ void test_reportToMapImpreciseProxied(void)
     const DecodedServiceEnvelope env(message.payload_variant.data.bytes, message.payload_variant.data.size);
 }
 
+// A batched map report carries our position and those of the nodes heard over LoRa on uplink channels.
+void test_reportToMapBatched(void)
+{
+    moduleConfig.mqtt.proxy_to_client_enabled = true;
+    moduleConfig.mqtt.map_report_settings.batch_node_positions = true;
+    MQTTUnitTest::restart();
+
+    meshtastic_NodeInfoLite heard = meshtastic_NodeInfoLite_init_zero;
+    heard.num = 20;
+    heard.has_position = true;
+    heard.position.latitude_i = 70012345;
+    heard.position.longitude_i = -30054321;
+    heard.last_heard = getTime();
+    meshtastic_NodeInfoLite viaMqtt = heard;
+    viaMqtt.num = 21;
+    viaMqtt.via_mqtt = true;
+    meshtastic_NodeInfoLite noPosition = heard;
+    noPosition.num = 22;
+    noPosition.has_position = false;
+
+    const pb_size_t numMeshNodes = nodeDB->numMeshNodes;
+    const std::vector<meshtastic_NodeInfoLite> savedNodes(nodeDB->meshNodes->begin(), nodeDB->meshNodes->begin() + 3);
+    nodeDB->meshNodes->at(0) = heard;
+    nodeDB->meshNodes->at(1) = viaMqtt;
+    nodeDB->meshNodes->at(2) = noPosition;
+    nodeDB->numMeshNodes = 3;
+
+    unitTest->reportToMap(/*precision=*/14);
+
+    std::copy(savedNodes.begin(), savedNodes.end(), nodeDB->meshNodes->begin());
+    nodeDB->numMeshNodes = numMeshNodes;
+
+    TEST_ASSERT_EQUAL(1, mockMeshService->messages_.size());
+    const meshtastic_MqttClientProxyMessage &message = mockMeshService->messages_.front();
+    TEST_ASSERT_EQUAL_STRING("msh/2/map_batch/", message.topic);
+    TEST_ASSERT_EQUAL(meshtastic_MqttClientProxyMessage_data_tag, message.which_payload_variant);
+    meshtastic_MapReportBatch batch = meshtastic_MapReportBatch_init_zero;
+    TEST_ASSERT_TRUE(pb_decode_from_bytes(message.payload_variant.data.bytes, message.payload_variant.data.size,
+                                          &meshtastic_MapReportBatch_msg, &batch));
+    TEST_ASSERT_EQUAL_STRING("!12345678", batch.gateway_id);
+    TEST_ASSERT_EQUAL(2, batch.nodes_count);
+
+    int32_t latitude = localPosition.latitude_i, longitude = localPosition.longitude_i;
+    GeoCoord::applyPrecision(latitude, longitude, 14);
+    TEST_ASSERT_EQUAL(10, batch.nodes[0].num);
+    TEST_ASSERT_EQUAL(latitude, batch.nodes[0].latitude_i);
+    TEST_ASSERT_EQUAL(longitude, batch.nodes[0].longitude_i);
+
+    latitude = heard.position.latitude_i;
+    longitude = heard.position.longitude_i;
+    GeoCoord::applyPrecision(latitude, longitude, 14);
+    TEST_ASSERT_EQUAL(20, batch.nodes[1].num);
+    TEST_ASSERT_EQUAL(latitude, batch.nodes[1].latitude_i);
+    TEST_ASSERT_EQUAL(longitude, batch.nodes[1].longitude_i);
+    TEST_ASSERT_EQUAL(14, batch.nodes[1].position_precision);
+    TEST_ASSERT_EQUAL(heard.last_heard, batch.nodes[1].last_heard);
+}
+
 // isUsingDefaultServer returns true when using the default server.
 void test_usingDefaultServer(void)
 {
@@ -888,7 +1161,13 @@ void setup()
     RUN_TEST(test_receiveDecodedProtoFromProxy);
     RUN_TEST(test_receiveEmptyDataFromProxy);
     RUN_TEST(test_receiveWithoutChannelDownlink);
+    RUN_TEST(test_receiveOnSecondaryChannel);
+    RUN_TEST(test_receiveEnvelopeChannelOverridesTopic);
+    RUN_TEST(test_topicTrieMatches);
     RUN_TEST(test_receiveEncryptedPKITopicToUs);
+    RUN_TEST(test_receiveEncryptedKeepsOrder);
+    RUN_TEST(test_receiveEncryptedDropsUndecryptable);
+    RUN_TEST(test_perhapsDecodeBatch);
     RUN_TEST(test_receiveIgnoresOwnPublishedMessages);
     RUN_TEST(test_receiveAcksOwnSentMessages);
     RUN_TEST(test_receiveIgnoresSentMessagesFromOthers);
@@ -900,6 +1179,7 @@ void setup()
     RUN_TEST(test_publishTextMessageWithProxy);
     RUN_TEST(test_reportToMapDefaultImprecise);
     RUN_TEST(test_reportToMapImpreciseProxied);
+    RUN_TEST(test_reportToMapBatched);
     RUN_TEST(test_usingDefaultServer);
     RUN_TEST(test_usingDefaultServerWithPort);
     RUN_TEST(test_usingDefaultServerWithInvalidPort);
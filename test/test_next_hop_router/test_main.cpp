@@ -0,0 +1,273 @@
+#include "DebugConfiguration.h"
+#include "TestUtil.h"
+#include <unity.h>
+
+#ifdef ARCH_PORTDUINO
+#include "mesh/MeshTypes.h"
+#include "mesh/NextHopRouter.h"
+
+#include <vector>
+
+namespace
+{
+const NodeNum sender = 0x1234;
+
+// Used to access the retransmission schedule of NextHopRouter without a radio
+class NextHopRouterUnderTest : public NextHopRouter
+{
+  public:
+    ~NextHopRouterUnderTest()
+    {
+        clear();
+        // cryptLock is created in the constructor for Router.
+        delete cryptLock;
+        cryptLock = NULL;
+    }
+
+    using NextHopRouter::delayRetransmissions;
+    using NextHopRouter::popDueRetransmission;
+    using NextHopRouter::retxQueue;
+
+    // Add (or replace) the retransmission of packet id, due at nextTxMsec
+    PendingPacket *schedule(PacketId id, uint32_t nextTxMsec)
+    {
+        cancel(id);
+        meshtastic_MeshPacket *p = packetPool.allocZeroed();
+        p->from = sender;
+        p->id = id;
+        PendingPacket &rec = pending[GlobalPacketId(p)] = PendingPacket(p, NUM_RELIABLE_RETX);
+        rec.nextTxMsec = nextTxMsec;
+        scheduleRetransmission(&rec);
+        return &rec;
+    }
+
+    // Move an existing retransmission to a new deadline, the way setNextTx() does
+    void reschedule(PacketId id, uint32_t nextTxMsec)
+    {
+        PendingPacket *rec = findPendingPacket(sender, id);
+        TEST_ASSERT_NOT_NULL(rec);
+        rec->nextTxMsec = nextTxMsec;
+        scheduleRetransmission(rec);
+    }
+
+    void cancel(PacketId id)
+    {
+        PendingPacket *rec = findPendingPacket(sender, id);
+        if (!rec)
+            return;
+        meshtastic_MeshPacket *p = rec->packet;
+        // Records from schedule() haven't been sent over LoRa yet, so stopRetransmission() leaves the packet to us
+        TEST_ASSERT_TRUE(stopRetransmission(sender, id));
+        packetPool.release(p);
+    }
+
+    // Pop everything due at 'now', in order
+    std::vector<PacketId> drain(uint32_t now, int32_t *waitMsec = NULL)
+    {
+        std::vector<PacketId> ids;
+        RetransmissionDeadline due = {0, 0, GlobalPacketId(0, 0)};
+        int32_t wait;
+        while (popDueRetransmission(now, due, wait))
+            ids.push_back(due.key.id);
+        if (waitMsec)
+            *waitMsec = wait;
+        return ids;
+    }
+
+    size_t numPending() const { return pending.size(); }
+
+    void clear()
+    {
+        for (auto &it : pending)
+            packetPool.release(it.second.packet);
+        pending.clear();
+        retxQueue = decltype(retxQueue)();
+        retxDelayMsec = 0;
+    }
+};
+
+NextHopRouterUnderTest *nextHopRouter;
+} // namespace
+
+void setUp(void)
+{
+    nextHopRouter->clear();
+}
+
+void tearDown(void) {}
+
+void test_deadlineOrderSurvivesRollover(void)
+{
+    RetransmissionDeadlineLater later;
+    RetransmissionDeadline beforeWrap = {0xFFFFFF00, 1, GlobalPacketId(sender, 1)};
+    RetransmissionDeadline afterWrap = {0x00000100, 2, GlobalPacketId(sender, 2)};
+    TEST_ASSERT_TRUE(later(afterWrap, beforeWrap));
+    TEST_ASSERT_FALSE(later(beforeWrap, afterWrap));
+    TEST_ASSERT_FALSE(later(beforeWrap, beforeWrap));
+}
+
+void test_popsInDeadlineOrder(void)
+{
+    nextHopRouter->schedule(1, 300);
+    nextHopRouter->schedule(2, 100);
+    nextHopRouter->schedule(3, 200);
+
+    int32_t wait;
+    std::vector<PacketId> due = nextHopRouter->drain(250, &wait);
+    TEST_ASSERT_EQUAL(2, due.size());
+    TEST_ASSERT_EQUAL(2, due[0]);
+    TEST_ASSERT_EQUAL(3, due[1]);
+    TEST_ASSERT_EQUAL(50, wait);
+
+    due = nextHopRouter->drain(300, &wait);
+    TEST_ASSERT_EQUAL(1, due.size());
+    TEST_ASSERT_EQUAL(1, due[0]);
+    TEST_ASSERT_EQUAL(INT32_MAX, wait);
+}
+
+// Deadlines on both sides of millis() wrapping around come out in time order, not numeric order
+void test_popsAcrossRollover(void)
+{
+    nextHopRouter->schedule(1, 0x00000100);
+    nextHopRouter->schedule(2, 0xFFFFFF00);
+
+    int32_t wait;
+    std::vector<PacketId> due = nextHopRouter->drain(0xFFFFFF80, &wait);
+    TEST_ASSERT_EQUAL(1, due.size());
+    TEST_ASSERT_EQUAL(2, due[0]);
+    TEST_ASSERT_EQUAL(0x180, wait);
+
+    due = nextHopRouter->drain(0x00000100);
+    TEST_ASSERT_EQUAL(1, due.size());
+    TEST_ASSERT_EQUAL(1, due[0]);
+}
+
+// A stopped packet leaves its heap entry behind, which must be skipped rather than reported or waited for
+void test_skipsStoppedEntries(void)
+{
+    nextHopRouter->schedule(1, 100);
+    nextHopRouter->schedule(2, 200);
+    nextHopRouter->cancel(1);
+    TEST_ASSERT_EQUAL(2, nextHopRouter->retxQueue.size());
+
+    int32_t wait;
+    TEST_ASSERT_EQUAL(0, nextHopRouter->drain(150, &wait).size());
+    TEST_ASSERT_EQUAL(50, wait);
+    TEST_ASSERT_EQUAL(1, nextHopRouter->retxQueue.size());
+}
+
+void test_cancelThenRescheduleSameId(void)
+{
+    nextHopRouter->schedule(1, 100);
+    nextHopRouter->schedule(2, 300);
+    nextHopRouter->cancel(1);
+    nextHopRouter->schedule(1, 500);
+
+    std::vector<PacketId> due = nextHopRouter->drain(1000);
+    TEST_ASSERT_EQUAL(2, due.size());
+    TEST_ASSERT_EQUAL(2, due[0]);
+    TEST_ASSERT_EQUAL(1, due[1]); // Only once, at the new deadline
+}
+
+void test_rescheduleLaterSupersedesOldEntry(void)
+{
+    nextHopRouter->schedule(1, 100);
+    nextHopRouter->schedule(2, 200);
+    nextHopRouter->reschedule(1, 300);
+
+    std::vector<PacketId> due = nextHopRouter->drain(250);
+    TEST_ASSERT_EQUAL(1, due.size());
+    TEST_ASSERT_EQUAL(2, due[0]);
+
+    due = nextHopRouter->drain(300);
+    TEST_ASSERT_EQUAL(1, due.size());
+    TEST_ASSERT_EQUAL(1, due[0]);
+}
+
+void test_delayKeepsExceptedDeadline(void)
+{
+    nextHopRouter->schedule(1, 100);
+    PendingPacket *keep = nextHopRouter->schedule(2, 100);
+    nextHopRouter->delayRetransmissions(1000, keep->packet);
+
+    std::vector<PacketId> due = nextHopRouter->drain(100);
+    TEST_ASSERT_EQUAL(1, due.size());
+    TEST_ASSERT_EQUAL(2, due[0]);
+    TEST_ASSERT_EQUAL(1, nextHopRouter->drain(1100).size());
+}
+
+// Stale entries from packets that were acked early get compacted away, rather than growing the heap forever
+void test_staleEntriesAreCompacted(void)
+{
+    for (PacketId id = 1; id <= 1000; id++) {
+        nextHopRouter->schedule(id, 1000 + id);
+        nextHopRouter->cancel(id);
+    }
+    TEST_ASSERT_EQUAL(0, nextHopRouter->numPending());
+    TEST_ASSERT_TRUE(nextHopRouter->retxQueue.size() <= 4 * 1 + 16 + 1); // The limit while one packet is pending
+}
+
+void test_benchmarkRetransmissionQueue(void)
+{
+    const size_t sizes[] = {10, 100, 1000};
+    const uint32_t rounds = 1000;
+    for (size_t n : sizes) {
+        nextHopRouter->clear();
+        for (PacketId id = 1; id <= n; id++)
+            nextHopRouter->schedule(id, 1000000 + id * 37 % 5000);
+
+        // What runOnce() does while nothing is due, which is almost always
+        RetransmissionDeadline due = {0, 0, GlobalPacketId(0, 0)};
+        int32_t wait;
+        uint32_t start = micros();
+        for (uint32_t i = 0; i < rounds; i++)
+            nextHopRouter->popDueRetransmission(0, due, wait);
+        const uint32_t idle = micros() - start;
+
+        // Each packet due once and rescheduled, as when the retransmissions go out
+        start = micros();
+        uint32_t now = 1000000;
+        for (size_t sent = 0; sent < n;) {
+            now += 50;
+            while (nextHopRouter->popDueRetransmission(now, due, wait)) {
+                nextHopRouter->reschedule(due.key.id, now + 100000);
+                sent++;
+            }
+        }
+        const uint32_t busy = micros() - start;
+
+        char msg[96];
+        snprintf(msg, sizeof(msg), "%4u pending: idle check %.3f us, due+reschedule %.3f us/packet", (unsigned)n,
+                 (float)idle / rounds, (float)busy / n);
+        TEST_MESSAGE(msg);
+    }
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    nextHopRouter = new NextHopRouterUnderTest();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_deadlineOrderSurvivesRollover);
+    RUN_TEST(test_popsInDeadlineOrder);
+    RUN_TEST(test_popsAcrossRollover);
+    RUN_TEST(test_skipsStoppedEntries);
+    RUN_TEST(test_cancelThenRescheduleSameId);
+    RUN_TEST(test_rescheduleLaterSupersedesOldEntry);
+    RUN_TEST(test_delayKeepsExceptedDeadline);
+    RUN_TEST(test_staleEntriesAreCompacted);
+    RUN_TEST(test_benchmarkRetransmissionQueue);
+    delete nextHopRouter;
+    exit(UNITY_END());
+}
+#else
+void setup()
+{
+    initializeTestEnvironment();
+    LOG_WARN("This test requires ARCH_PORTDUINO");
+    UNITY_BEGIN();
+    UNITY_END();
+}
+#endif
+void loop() {}
@@ -0,0 +1,197 @@
+#include "gps/GeoCoord.h"
+#include "mesh/NodePositionIndex.h"
+
+#ifdef ARCH_PORTDUINO
+#include "mesh/NodeDB.h"
+#endif
+
+#include "TestUtil.h"
+#include <Arduino.h>
+#include <random>
+#include <unity.h>
+#include <vector>
+
+struct TestNode {
+    uint32_t num;
+    int32_t latitude_i;
+    int32_t longitude_i;
+};
+
+static const size_t NUM_NODES = 5000;
+
+static NodePositionIndex positions;
+static std::vector<TestNode> testNodes;
+
+// Half the nodes spread over the globe, half clustered near two cities (one of them on the antimeridian)
+static void populate()
+{
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int32_t> anyLat(-850000000, 850000000);
+    std::uniform_int_distribution<int32_t> anyLon(-1800000000, 1799999999);
+    std::uniform_int_distribution<int32_t> nearby(-5000000, 5000000);
+
+    positions.clear();
+    testNodes.clear();
+    for (uint32_t num = 1; num <= NUM_NODES; num++) {
+        TestNode n = {num, 0, 0};
+        if (num % 2) {
+            n.latitude_i = anyLat(rng);
+            n.longitude_i = anyLon(rng);
+        } else {
+            n.latitude_i = 375000000 + nearby(rng);
+            int64_t lon = (num % 4 ? -1220000000 : 1799000000) + nearby(rng);
+            n.longitude_i = (int32_t)(lon > 1800000000 ? lon - 3600000000LL : lon);
+        }
+        positions.update(n.num, n.latitude_i, n.longitude_i);
+        testNodes.push_back(n);
+    }
+}
+
+static size_t bruteForceWithin(int32_t latitude_i, int32_t longitude_i, float meters)
+{
+    size_t count = 0;
+    for (const TestNode &n : testNodes) {
+        if (n.latitude_i == 0 && n.longitude_i == 0)
+            continue;
+        if (GeoCoord::latLongToMeter(latitude_i * 1e-7, longitude_i * 1e-7, n.latitude_i * 1e-7, n.longitude_i * 1e-7) <= meters)
+            count++;
+    }
+    return count;
+}
+
+void setUp(void)
+{
+    populate();
+}
+
+void tearDown(void) {}
+
+// Every query must find exactly what a scan of all nodes finds, including across the antimeridian and near the pole
+void test_radiusMatchesBruteForce(void)
+{
+    struct {
+        int32_t latitude_i;
+        int32_t longitude_i;
+        float meters;
+    } queries[] = {
+        {375000000, -1220000000, 20000},  {375000000, 1799990000, 300000}, {375000000, -1799990000, 300000},
+        {890000000, 0, 500000},           {0, 0, 20000000},                {100000000, 100000000, 1000000},
+    };
+
+    for (auto &q : queries) {
+        std::vector<NodePositionIndex::Match> found = positions.withinRadius(q.latitude_i, q.longitude_i, q.meters);
+        TEST_ASSERT_EQUAL(bruteForceWithin(q.latitude_i, q.longitude_i, q.meters), found.size());
+        for (size_t i = 1; i < found.size(); i++)
+            TEST_ASSERT_TRUE(found[i - 1].meters <= found[i].meters);
+    }
+}
+
+void test_updateAndRemove(void)
+{
+    // Move a node from one side of the world to the other, then drop its position
+    positions.update(1, 375000000, -1220000000);
+    testNodes[0] = {1, 375000000, -1220000000};
+    TEST_ASSERT_EQUAL(1, positions.withinRadius(375000000, -1220000000, 1).size());
+
+    positions.update(1, 0, 0);
+    testNodes[0] = {1, 0, 0};
+    TEST_ASSERT_EQUAL(0, positions.withinRadius(375000000, -1220000000, 1).size());
+    TEST_ASSERT_EQUAL(NUM_NODES - 1, positions.size());
+
+    positions.remove(2);
+    testNodes[1] = {2, 0, 0};
+    TEST_ASSERT_EQUAL(bruteForceWithin(375000000, -1220000000, 100000), positions.withinRadius(375000000, -1220000000, 100000).size());
+}
+
+void test_nearest(void)
+{
+    std::vector<NodePositionIndex::Match> found = positions.nearest(375000000, 1799990000, 10);
+    TEST_ASSERT_EQUAL(10, found.size());
+
+    // No node outside the results may be closer than the furthest result
+    TEST_ASSERT_EQUAL(10, bruteForceWithin(375000000, 1799990000, found.back().meters));
+}
+
+void test_benchmarkQueries(void)
+{
+    const int iterations = 200;
+
+    uint32_t start = micros();
+    size_t indexed = 0;
+    for (int i = 0; i < iterations; i++)
+        indexed += positions.withinRadius(375000000, -1220000000, 10000).size();
+    uint32_t indexUs = micros() - start;
+
+    start = micros();
+    size_t scanned = 0;
+    for (int i = 0; i < iterations; i++)
+        scanned += bruteForceWithin(375000000, -1220000000, 10000);
+    uint32_t scanUs = micros() - start;
+
+    TEST_ASSERT_EQUAL(scanned, indexed);
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%u nodes, 10 km radius: index %u us, full scan %u us per query", (unsigned)NUM_NODES,
+             (unsigned)(indexUs / iterations), (unsigned)(scanUs / iterations));
+    TEST_MESSAGE(msg);
+}
+
+#ifdef ARCH_PORTDUINO
+static meshtastic_Position positionAt(int32_t latitude_i, int32_t longitude_i)
+{
+    meshtastic_Position p = meshtastic_Position_init_default;
+    p.has_latitude_i = p.has_longitude_i = true;
+    p.latitude_i = latitude_i;
+    p.longitude_i = longitude_i;
+    return p;
+}
+
+// NodeDB only builds its index when first asked, then has to keep it current through every later change
+void test_nodeDBIndexIsLazy(void)
+{
+    nodeDB->resetNodes();
+    nodeDB->updatePosition(0x100, positionAt(375000000, -1220000000), RX_SRC_RADIO);
+    nodeDB->updatePosition(0x101, positionAt(375010000, -1220010000), RX_SRC_RADIO);
+
+    std::vector<NodePositionIndex::Match> found = nodeDB->getNodesWithin(375000000, -1220000000, 1000);
+    TEST_ASSERT_EQUAL(2, found.size());
+    TEST_ASSERT_EQUAL(0x100, found[0].num);
+
+    // Changes after the first query
+    nodeDB->updatePosition(0x100, positionAt(-337000000, 1510000000), RX_SRC_RADIO);
+    nodeDB->updatePosition(0x102, positionAt(375020000, -1220020000), RX_SRC_RADIO);
+    nodeDB->removeNodeByNum(0x101);
+
+    found = nodeDB->getNodesWithin(375000000, -1220000000, 1000);
+    TEST_ASSERT_EQUAL(1, found.size());
+    TEST_ASSERT_EQUAL(0x102, found[0].num);
+    found = nodeDB->getNearestNodes(-337000000, 1510000000, 1);
+    TEST_ASSERT_EQUAL(1, found.size());
+    TEST_ASSERT_EQUAL(0x100, found[0].num);
+
+    // A reset drops the index, the next query rebuilds it from what is left
+    nodeDB->resetNodes();
+    TEST_ASSERT_EQUAL(0, nodeDB->getNodesWithin(375000000, -1220000000, 1000).size());
+}
+#endif
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_radiusMatchesBruteForce);
+    RUN_TEST(test_updateAndRemove);
+    RUN_TEST(test_nearest);
+    RUN_TEST(test_benchmarkQueries);
+#ifdef ARCH_PORTDUINO
+    nodeDB = new NodeDB();
+    RUN_TEST(test_nodeDBIndexIsLazy);
+#endif
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}
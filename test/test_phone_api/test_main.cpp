@@ -0,0 +1,262 @@
+#include "DebugConfiguration.h"
+#include "TestUtil.h"
+#include <unity.h>
+
+#ifdef ARCH_PORTDUINO
+#include "mesh/NodeDB.h"
+#include "mesh/PhoneAPI.h"
+
+#include <pb_encode.h>
+#include <string.h>
+
+namespace
+{
+// Used to reach the FromRadio encoding of PhoneAPI without a client or a mesh service
+class PhoneAPIUnderTest : public PhoneAPI
+{
+  public:
+    using PhoneAPI::config_nonce;
+    using PhoneAPI::setFromRadio;
+    using PhoneAPI::setFromRadioConfig;
+    using PhoneAPI::setFromRadioModuleConfig;
+
+    // What was set must come out of both encodeFromRadio() and copyFromRadio() the same as encoding expected
+    void check(const meshtastic_FromRadio &expected)
+    {
+        uint8_t want[meshtastic_FromRadio_size], got[meshtastic_FromRadio_size];
+        size_t wantLen = pb_encode_to_bytes(want, sizeof(want), &meshtastic_FromRadio_msg, &expected);
+        TEST_ASSERT_TRUE(wantLen > 0);
+
+        size_t gotLen = encodeFromRadio(got);
+        TEST_ASSERT_EQUAL(wantLen, gotLen);
+        TEST_ASSERT_EQUAL_MEMORY(want, got, wantLen);
+
+        meshtastic_FromRadio copy;
+        copyFromRadio(copy);
+        TEST_ASSERT_EQUAL(expected.which_payload_variant, copy.which_payload_variant);
+        gotLen = pb_encode_to_bytes(got, sizeof(got), &meshtastic_FromRadio_msg, &copy);
+        TEST_ASSERT_EQUAL(wantLen, gotLen);
+        TEST_ASSERT_EQUAL_MEMORY(want, got, wantLen);
+    }
+
+  protected:
+    bool checkIsConnected() override { return true; }
+};
+
+PhoneAPIUnderTest *phoneAPI;
+
+meshtastic_FromRadio fromRadio(pb_size_t tag)
+{
+    meshtastic_FromRadio f;
+    memset(&f, 0, sizeof(f));
+    f.which_payload_variant = tag;
+    return f;
+}
+
+meshtastic_FromRadio configFromRadio(pb_size_t tag)
+{
+    meshtastic_FromRadio f = fromRadio(meshtastic_FromRadio_config_tag);
+    f.config.which_payload_variant = tag;
+    return f;
+}
+
+meshtastic_FromRadio moduleConfigFromRadio(pb_size_t tag)
+{
+    meshtastic_FromRadio f = fromRadio(meshtastic_FromRadio_moduleConfig_tag);
+    f.moduleConfig.which_payload_variant = tag;
+    return f;
+}
+
+// A text message long enough that its length takes two bytes
+meshtastic_FromRadio longPacket()
+{
+    meshtastic_FromRadio f = fromRadio(meshtastic_FromRadio_packet_tag);
+    f.packet.from = 0x1234;
+    f.packet.to = NODENUM_BROADCAST;
+    f.packet.id = 0xABCDEF;
+    f.packet.hop_limit = 3;
+    f.packet.which_payload_variant = meshtastic_MeshPacket_decoded_tag;
+    f.packet.decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
+    f.packet.decoded.payload.size = 200;
+    memset(f.packet.decoded.payload.bytes, 'x', f.packet.decoded.payload.size);
+    return f;
+}
+
+size_t encodedSize(const meshtastic_FromRadio &f)
+{
+    size_t size = 0;
+    TEST_ASSERT_TRUE(pb_get_encoded_size(&size, &meshtastic_FromRadio_msg, &f));
+    return size;
+}
+} // namespace
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// Every message variant we send, holding an all zero message, so only the tag and a zero length are written
+void test_zeroedMessages(void)
+{
+    meshtastic_FromRadio f;
+#define CHECK_ZEROED(tag, member, fields)                                                                                       \
+    f = fromRadio(tag);                                                                                                         \
+    phoneAPI->setFromRadio(tag, fields, &f.member);                                                                             \
+    phoneAPI->check(f);
+
+    CHECK_ZEROED(meshtastic_FromRadio_packet_tag, packet, meshtastic_MeshPacket_fields);
+    CHECK_ZEROED(meshtastic_FromRadio_my_info_tag, my_info, meshtastic_MyNodeInfo_fields);
+    CHECK_ZEROED(meshtastic_FromRadio_node_info_tag, node_info, meshtastic_NodeInfo_fields);
+    CHECK_ZEROED(meshtastic_FromRadio_log_record_tag, log_record, meshtastic_LogRecord_fields);
+    CHECK_ZEROED(meshtastic_FromRadio_channel_tag, channel, meshtastic_Channel_fields);
+    CHECK_ZEROED(meshtastic_FromRadio_queueStatus_tag, queueStatus, meshtastic_QueueStatus_fields);
+    CHECK_ZEROED(meshtastic_FromRadio_xmodemPacket_tag, xmodemPacket, meshtastic_XModem_fields);
+    CHECK_ZEROED(meshtastic_FromRadio_metadata_tag, metadata, meshtastic_DeviceMetadata_fields);
+    CHECK_ZEROED(meshtastic_FromRadio_mqttClientProxyMessage_tag, mqttClientProxyMessage,
+                 meshtastic_MqttClientProxyMessage_fields);
+    CHECK_ZEROED(meshtastic_FromRadio_fileInfo_tag, fileInfo, meshtastic_FileInfo_fields);
+    CHECK_ZEROED(meshtastic_FromRadio_clientNotification_tag, clientNotification, meshtastic_ClientNotification_fields);
+    CHECK_ZEROED(meshtastic_FromRadio_deviceuiConfig_tag, deviceuiConfig, meshtastic_DeviceUIConfig_fields);
+#undef CHECK_ZEROED
+}
+
+// The settings we send without a source object
+void test_emptyMessages(void)
+{
+    phoneAPI->setFromRadioConfig(meshtastic_Config_sessionkey_tag, meshtastic_Config_SessionkeyConfig_fields, nullptr);
+    phoneAPI->check(configFromRadio(meshtastic_Config_sessionkey_tag));
+
+    phoneAPI->setFromRadioConfig(meshtastic_Config_device_ui_tag, meshtastic_DeviceUIConfig_fields, nullptr);
+    phoneAPI->check(configFromRadio(meshtastic_Config_device_ui_tag));
+
+    phoneAPI->setFromRadio(meshtastic_FromRadio_config_tag, meshtastic_Config_fields, nullptr);
+    phoneAPI->check(fromRadio(meshtastic_FromRadio_config_tag));
+
+    phoneAPI->setFromRadio(meshtastic_FromRadio_moduleConfig_tag, meshtastic_ModuleConfig_fields, nullptr);
+    phoneAPI->check(fromRadio(meshtastic_FromRadio_moduleConfig_tag));
+}
+
+void test_configCompleteId(void)
+{
+    const uint32_t nonces[] = {1, 0x7F, 0x80, 0xDEADBEEF};
+    for (uint32_t nonce : nonces) {
+        phoneAPI->config_nonce = nonce;
+        phoneAPI->sendConfigComplete();
+        meshtastic_FromRadio f = fromRadio(meshtastic_FromRadio_config_complete_id_tag);
+        f.config_complete_id = nonce;
+        phoneAPI->check(f);
+    }
+}
+
+// Every Config and ModuleConfig variant, with the settings NodeDB installed
+void test_settings(void)
+{
+    meshtastic_FromRadio f;
+#define CHECK_CONFIG(tag, member, fields)                                                                                       \
+    f = configFromRadio(tag);                                                                                                   \
+    f.config.payload_variant.member = config.member;                                                                            \
+    phoneAPI->setFromRadioConfig(tag, fields, &f.config.payload_variant.member);                                                \
+    phoneAPI->check(f);
+
+    CHECK_CONFIG(meshtastic_Config_device_tag, device, meshtastic_Config_DeviceConfig_fields);
+    CHECK_CONFIG(meshtastic_Config_position_tag, position, meshtastic_Config_PositionConfig_fields);
+    CHECK_CONFIG(meshtastic_Config_power_tag, power, meshtastic_Config_PowerConfig_fields);
+    CHECK_CONFIG(meshtastic_Config_network_tag, network, meshtastic_Config_NetworkConfig_fields);
+    CHECK_CONFIG(meshtastic_Config_display_tag, display, meshtastic_Config_DisplayConfig_fields);
+    CHECK_CONFIG(meshtastic_Config_lora_tag, lora, meshtastic_Config_LoRaConfig_fields);
+    CHECK_CONFIG(meshtastic_Config_bluetooth_tag, bluetooth, meshtastic_Config_BluetoothConfig_fields);
+    CHECK_CONFIG(meshtastic_Config_security_tag, security, meshtastic_Config_SecurityConfig_fields);
+#undef CHECK_CONFIG
+
+#define CHECK_MODULE_CONFIG(tag, member, fields)                                                                                \
+    f = moduleConfigFromRadio(tag);                                                                                             \
+    f.moduleConfig.payload_variant.member = moduleConfig.member;                                                                \
+    phoneAPI->setFromRadioModuleConfig(tag, fields, &f.moduleConfig.payload_variant.member);                                    \
+    phoneAPI->check(f);
+
+    CHECK_MODULE_CONFIG(meshtastic_ModuleConfig_mqtt_tag, mqtt, meshtastic_ModuleConfig_MQTTConfig_fields);
+    CHECK_MODULE_CONFIG(meshtastic_ModuleConfig_serial_tag, serial, meshtastic_ModuleConfig_SerialConfig_fields);
+    CHECK_MODULE_CONFIG(meshtastic_ModuleConfig_external_notification_tag, external_notification,
+                        meshtastic_ModuleConfig_ExternalNotificationConfig_fields);
+    CHECK_MODULE_CONFIG(meshtastic_ModuleConfig_store_forward_tag, store_forward,
+                        meshtastic_ModuleConfig_StoreForwardConfig_fields);
+    CHECK_MODULE_CONFIG(meshtastic_ModuleConfig_range_test_tag, range_test, meshtastic_ModuleConfig_RangeTestConfig_fields);
+    CHECK_MODULE_CONFIG(meshtastic_ModuleConfig_telemetry_tag, telemetry, meshtastic_ModuleConfig_TelemetryConfig_fields);
+    CHECK_MODULE_CONFIG(meshtastic_ModuleConfig_canned_message_tag, canned_message,
+                        meshtastic_ModuleConfig_CannedMessageConfig_fields);
+    CHECK_MODULE_CONFIG(meshtastic_ModuleConfig_audio_tag, audio, meshtastic_ModuleConfig_AudioConfig_fields);
+    CHECK_MODULE_CONFIG(meshtastic_ModuleConfig_remote_hardware_tag, remote_hardware,
+                        meshtastic_ModuleConfig_RemoteHardwareConfig_fields);
+    CHECK_MODULE_CONFIG(meshtastic_ModuleConfig_neighbor_info_tag, neighbor_info,
+                        meshtastic_ModuleConfig_NeighborInfoConfig_fields);
+    CHECK_MODULE_CONFIG(meshtastic_ModuleConfig_ambient_lighting_tag, ambient_lighting,
+                        meshtastic_ModuleConfig_AmbientLightingConfig_fields);
+    CHECK_MODULE_CONFIG(meshtastic_ModuleConfig_detection_sensor_tag, detection_sensor,
+                        meshtastic_ModuleConfig_DetectionSensorConfig_fields);
+    CHECK_MODULE_CONFIG(meshtastic_ModuleConfig_paxcounter_tag, paxcounter, meshtastic_ModuleConfig_PaxcounterConfig_fields);
+#undef CHECK_MODULE_CONFIG
+}
+
+// Messages of 128 bytes or more need a second byte for their length
+void test_multiByteLengths(void)
+{
+    meshtastic_FromRadio f = longPacket();
+    TEST_ASSERT_TRUE(encodedSize(f) > 128 + 2);
+    phoneAPI->setFromRadio(meshtastic_FromRadio_packet_tag, meshtastic_MeshPacket_fields, &f.packet);
+    phoneAPI->check(f);
+
+    f = fromRadio(meshtastic_FromRadio_node_info_tag);
+    f.node_info.num = 0x1234;
+    f.node_info.has_user = true;
+    memset(f.node_info.user.id, 'i', sizeof(f.node_info.user.id) - 1);
+    memset(f.node_info.user.long_name, 'l', sizeof(f.node_info.user.long_name) - 1);
+    memset(f.node_info.user.short_name, 's', sizeof(f.node_info.user.short_name) - 1);
+    f.node_info.user.public_key.size = sizeof(f.node_info.user.public_key.bytes);
+    memset(f.node_info.user.public_key.bytes, 0x5A, f.node_info.user.public_key.size);
+    f.node_info.last_heard = 0xFFFFFFFF;
+    TEST_ASSERT_TRUE(encodedSize(f) > 128 + 2);
+    phoneAPI->setFromRadio(meshtastic_FromRadio_node_info_tag, meshtastic_NodeInfo_fields, &f.node_info);
+    phoneAPI->check(f);
+
+    // Both the Config and the SecurityConfig inside it are long enough
+    f = configFromRadio(meshtastic_Config_security_tag);
+    meshtastic_Config_SecurityConfig &security = f.config.payload_variant.security;
+    security.public_key.size = security.private_key.size = 32;
+    memset(security.public_key.bytes, 0x11, 32);
+    memset(security.private_key.bytes, 0x22, 32);
+    security.admin_key_count = 3;
+    for (pb_size_t i = 0; i < security.admin_key_count; i++) {
+        security.admin_key[i].size = 32;
+        memset(security.admin_key[i].bytes, 0x33 + i, 32);
+    }
+    size_t innerSize = 0;
+    TEST_ASSERT_TRUE(pb_get_encoded_size(&innerSize, meshtastic_Config_SecurityConfig_fields, &security));
+    TEST_ASSERT_TRUE(innerSize >= 128);
+    phoneAPI->setFromRadioConfig(meshtastic_Config_security_tag, meshtastic_Config_SecurityConfig_fields, &security);
+    phoneAPI->check(f);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    nodeDB = new NodeDB();
+    phoneAPI = new PhoneAPIUnderTest();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_zeroedMessages);
+    RUN_TEST(test_emptyMessages);
+    RUN_TEST(test_configCompleteId);
+    RUN_TEST(test_settings);
+    RUN_TEST(test_multiByteLengths);
+    delete phoneAPI;
+    exit(UNITY_END());
+}
+#else
+void setup()
+{
+    initializeTestEnvironment();
+    LOG_WARN("This test requires ARCH_PORTDUINO");
+    UNITY_BEGIN();
+    UNITY_END();
+}
+#endif
+void loop() {}
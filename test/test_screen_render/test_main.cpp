@@ -0,0 +1,238 @@
+#include "DebugConfiguration.h"
+#include "TestUtil.h"
+#include <unity.h>
+
+#if ARCH_PORTDUINO && HAS_SCREEN
+#include "gps/RTC.h"
+#include "graphics/HeadlessDisplay.h"
+#include "graphics/Screen.h"
+#include "graphics/draw/ClockRenderer.h"
+#include "graphics/draw/MessageRenderer.h"
+#include "graphics/draw/NodeListRenderer.h"
+#include "graphics/draw/UIRenderer.h"
+#include "main.h"
+#include "mesh/NodeDB.h"
+
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+
+#define NUM_TEST_NODES 80
+
+struct Frame {
+    const char *name;
+    void (*draw)(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t x, int16_t y);
+};
+
+// drawLastHeardScreen() and friends only exist on e-ink builds, everything else cycles through them in one frame
+static void drawLastHeard(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t x, int16_t y)
+{
+    graphics::NodeListRenderer::drawNodeListScreen(display, state, x, y, "Last Heard",
+                                                   graphics::NodeListRenderer::drawEntryLastHeard);
+}
+
+static void drawHopSignal(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t x, int16_t y)
+{
+    graphics::NodeListRenderer::drawNodeListScreen(display, state, x, y, "Hops/Sig",
+                                                   graphics::NodeListRenderer::drawEntryHopSignal);
+}
+
+static void drawDistance(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t x, int16_t y)
+{
+    graphics::NodeListRenderer::drawNodeListScreen(display, state, x, y, "Distance", graphics::NodeListRenderer::drawNodeDistance);
+}
+
+static const Frame frames[] = {
+    {"device_focused", graphics::UIRenderer::drawDeviceFocused},
+    {"compass_location", graphics::UIRenderer::drawCompassAndLocationScreen},
+    {"last_heard", drawLastHeard},
+    {"hop_signal", drawHopSignal},
+    {"distance", drawDistance},
+    {"node_compasses", graphics::NodeListRenderer::drawNodeListWithCompasses},
+    {"digital_clock", graphics::ClockRenderer::drawDigitalClockFrame},
+    {"analog_clock", graphics::ClockRenderer::drawAnalogClockFrame},
+    {"text_message", graphics::MessageRenderer::drawTextMessageFrame},
+};
+
+static std::unique_ptr<HeadlessDisplay> display;
+static OLEDDisplayUiState uiState;
+
+// A mesh around our own position, in a fixed pattern so the rendered frames don't change between runs
+static void populateNodeDB()
+{
+    const int32_t ourLat = 474000000, ourLon = 85000000;
+    meshtastic_NodeInfoLite *us = nodeDB->getMeshNode(nodeDB->getNodeNum());
+    if (us) {
+        us->has_position = true;
+        us->position.latitude_i = ourLat;
+        us->position.longitude_i = ourLon;
+    }
+
+    const uint32_t now = getTime();
+    size_t count = nodeDB->getNumMeshNodes();
+    for (uint32_t i = 1; i <= NUM_TEST_NODES && count < nodeDB->meshNodes->size(); i++, count++) {
+        meshtastic_NodeInfoLite &n = (*nodeDB->meshNodes)[count];
+        n = meshtastic_NodeInfoLite_init_default;
+        n.num = 0x10000000 + i;
+        n.has_user = true;
+        snprintf(n.user.long_name, sizeof(n.user.long_name), "Test node %u", (unsigned)i);
+        snprintf(n.user.short_name, sizeof(n.user.short_name), "T%03u", (unsigned)i);
+        n.last_heard = now - i * 97;
+        n.snr = (int)(i % 25) - 12;
+        n.has_hops_away = true;
+        n.hops_away = i % 4;
+        if (i % 3 != 0) {
+            n.has_position = true;
+            n.position.latitude_i = ourLat + (int32_t)((i * 7919) % 20000) - 10000;
+            n.position.longitude_i = ourLon + (int32_t)((i * 104729) % 30000) - 15000;
+        }
+        n.is_favorite = i <= 3;
+    }
+    nodeDB->numMeshNodes = count;
+
+    meshtastic_MeshPacket &mp = devicestate.rx_text_message;
+    mp = meshtastic_MeshPacket_init_default;
+    mp.from = 0x10000001;
+    mp.rx_time = now - 60;
+    mp.which_payload_variant = meshtastic_MeshPacket_decoded_tag;
+    mp.decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
+    // Long enough to scroll, so the frame has as many lines to lay out as a real message can
+    const char *text = "Roger that, moving to checkpoint 4 now. Will report back when we get there, ETA about 20 minutes. "
+                       "Road past the bridge is closed, we are taking the forest track instead. Keep channel 2 open and "
+                       "check in every 30 minutes.";
+    mp.decoded.payload.size = strlen(text);
+    memcpy(mp.decoded.payload.bytes, text, mp.decoded.payload.size);
+}
+
+// The clock frames show the current time, so they can't be checked against an image or against themselves
+static bool isClockFrame(const Frame &frame)
+{
+    return frame.draw == graphics::ClockRenderer::drawDigitalClockFrame ||
+           frame.draw == graphics::ClockRenderer::drawAnalogClockFrame;
+}
+
+static void render(const Frame &frame)
+{
+    display->clear();
+    frame.draw(display.get(), &uiState, 0, 0);
+    display->display();
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_everyFrameDraws(void)
+{
+    const char *dumpDir = getenv("MESHTASTIC_SCREEN_DUMP_DIR");
+    for (const Frame &frame : frames) {
+        render(frame);
+        TEST_ASSERT_TRUE_MESSAGE(display->countSetPixels() > 0, frame.name);
+
+        // Set MESHTASTIC_SCREEN_DUMP_DIR to look at the frames
+        if (dumpDir) {
+            std::string path = std::string(dumpDir) + "/" + frame.name + ".png";
+            TEST_ASSERT_TRUE_MESSAGE(display->writePNG(path.c_str()), path.c_str());
+        }
+    }
+}
+
+// Frames that don't depend on the clock must come out exactly the same every time
+void test_framesAreDeterministic(void)
+{
+    for (const Frame &frame : frames) {
+        if (isClockFrame(frame))
+            continue;
+        render(frame);
+        const uint32_t first = display->checksum();
+        render(frame);
+        TEST_ASSERT_EQUAL_HEX32_MESSAGE(first, display->checksum(), frame.name);
+    }
+}
+
+// Compare each frame with the image checked in under golden/. Run with MESHTASTIC_SCREEN_UPDATE_GOLDEN=1 from the project
+// root to write the images, or rewrite them after a deliberate change to the layout, and look at the diff before committing
+// them. A missing image fails the test, otherwise a frame could go unchecked without anyone noticing.
+void test_framesMatchGolden(void)
+{
+    const char *goldenDir = getenv("MESHTASTIC_SCREEN_GOLDEN_DIR");
+    if (!goldenDir)
+        goldenDir = "test/test_screen_render/golden";
+    const bool update = getenv("MESHTASTIC_SCREEN_UPDATE_GOLDEN") != nullptr;
+    if (update)
+        mkdir(goldenDir, 0755);
+
+    std::string missing;
+    for (const Frame &frame : frames) {
+        if (isClockFrame(frame))
+            continue;
+        render(frame);
+        const std::string path = std::string(goldenDir) + "/" + frame.name + ".png";
+        if (update) {
+            TEST_ASSERT_TRUE_MESSAGE(display->writePNG(path.c_str()), path.c_str());
+            continue;
+        }
+
+        FILE *f = fopen(path.c_str(), "rb");
+        if (!f) {
+            missing += missing.empty() ? frame.name : std::string(", ") + frame.name;
+            continue;
+        }
+        fclose(f);
+        TEST_ASSERT_TRUE_MESSAGE(display->matchesPNG(path.c_str()), frame.name);
+    }
+
+    if (!missing.empty()) {
+        std::string msg = "No golden image for " + missing + ", generate with MESHTASTIC_SCREEN_UPDATE_GOLDEN=1";
+        TEST_FAIL_MESSAGE(msg.c_str());
+    }
+}
+
+void test_benchmarkFrames(void)
+{
+    const uint32_t iterations = 200;
+    for (const Frame &frame : frames) {
+        render(frame); // warm up any caches
+        const uint32_t start = micros();
+        for (uint32_t i = 0; i < iterations; i++)
+            render(frame);
+        const uint32_t elapsed = micros() - start;
+
+        char msg[96];
+        snprintf(msg, sizeof(msg), "%-18s %8.1f us/frame (%u nodes)", frame.name, (float)elapsed / iterations,
+                 (unsigned)nodeDB->getNumMeshNodes());
+        TEST_MESSAGE(msg);
+    }
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    nodeDB = new NodeDB();
+    populateNodeDB();
+    // Otherwise the bearings frame stays blank until there is a heading
+    uiconfig.compass_mode = meshtastic_CompassMode_FREEZE_HEADING;
+
+    // The renderers ask the global screen for things like the heading, it never gets set up or drawn to
+    screen = new graphics::Screen(ScanI2C::DeviceAddress(), meshtastic_Config_DisplayConfig_OledType_OLED_AUTO, GEOMETRY_128_64);
+    display.reset(new HeadlessDisplay(GEOMETRY_128_64));
+    display->init();
+    uiState = OLEDDisplayUiState();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_everyFrameDraws);
+    RUN_TEST(test_framesAreDeterministic);
+    RUN_TEST(test_framesMatchGolden);
+    RUN_TEST(test_benchmarkFrames);
+    exit(UNITY_END());
+}
+#else
+void setup()
+{
+    initializeTestEnvironment();
+    LOG_WARN("This test requires a native build with HAS_SCREEN");
+    UNITY_BEGIN();
+    UNITY_END();
+}
+#endif
+void loop() {}
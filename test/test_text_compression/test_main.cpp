@@ -0,0 +1,215 @@
+#include "DebugConfiguration.h"
+#include "TestUtil.h"
+#include <unity.h>
+
+#ifdef ARCH_PORTDUINO
+#include "mesh/Channels.h"
+#include "mesh/CryptoEngine.h"
+#include "mesh/NodeDB.h"
+#include "mesh/Router.h"
+#include "mesh/compression/unishox2.h"
+
+#include <string.h>
+#include <string>
+
+namespace
+{
+const NodeNum us = 10, capable = 0x20, legacy = 0x30;
+
+const char *text = "Meet at the north gate at 18:30, bring the spare batteries and the long antenna";
+
+// Let a node tell us, through NodeInfo, whether it can decode compressed text
+void hearNodeInfo(NodeNum from, bool canDecompress)
+{
+    meshtastic_MeshPacket p = meshtastic_MeshPacket_init_zero;
+    p.from = from;
+    p.which_payload_variant = meshtastic_MeshPacket_decoded_tag;
+    p.decoded.portnum = meshtastic_PortNum_NODEINFO_APP;
+    p.decoded.has_bitfield = true;
+    p.decoded.bitfield = canDecompress ? BITFIELD_CAN_DECOMPRESS_TEXT_MASK : 0;
+    nodeDB->updateFrom(p);
+}
+
+bool canDecompress(NodeNum n)
+{
+    const meshtastic_NodeInfoLite *node = nodeDB->getMeshNode(n);
+    return node && (node->bitfield & NODEINFO_BITFIELD_CAN_DECOMPRESS_TEXT_MASK);
+}
+
+meshtastic_MeshPacket textTo(NodeNum to)
+{
+    meshtastic_MeshPacket p = meshtastic_MeshPacket_init_zero;
+    p.from = us;
+    p.to = to;
+    p.which_payload_variant = meshtastic_MeshPacket_decoded_tag;
+    p.decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
+    p.decoded.payload.size = strlen(text);
+    memcpy(p.decoded.payload.bytes, text, p.decoded.payload.size);
+    return p;
+}
+
+// A packet on the primary channel, as another node would send it, carrying data with the given port and payload
+meshtastic_MeshPacket receive(NodeNum to, meshtastic_PortNum portnum, const void *payload, size_t size)
+{
+    meshtastic_Data data = meshtastic_Data_init_zero;
+    data.portnum = portnum;
+    data.payload.size = size;
+    memcpy(data.payload.bytes, payload, size);
+
+    meshtastic_MeshPacket p = meshtastic_MeshPacket_init_zero;
+    p.from = capable;
+    p.to = to;
+    p.id = 0x1234;
+    p.channel = channels.getHash(0);
+    p.which_payload_variant = meshtastic_MeshPacket_encrypted_tag;
+    p.encrypted.size = pb_encode_to_bytes(p.encrypted.bytes, sizeof(p.encrypted.bytes), &meshtastic_Data_msg, &data);
+    crypto->setKey(channels.getKey(0));
+    crypto->encryptPacket(p.from, p.id, p.encrypted.size, p.encrypted.bytes);
+    return p;
+}
+
+meshtastic_MeshPacket receiveCompressed(NodeNum to)
+{
+    char compressed[sizeof(meshtastic_Data_payload_t::bytes)];
+    int len = unishox2_compress_lines(text, strlen(text), compressed, sizeof(compressed), USX_PSET_DFLT, NULL);
+    TEST_ASSERT_TRUE(len > 0 && len < (int)strlen(text));
+    return receive(to, meshtastic_PortNum_TEXT_MESSAGE_COMPRESSED_APP, compressed, len);
+}
+} // namespace
+
+void setUp(void)
+{
+    myNodeInfo.my_node_num = us;
+    nodeDB->resetNodes();
+}
+
+void tearDown(void) {}
+
+void test_nodeInfoSetsAndClearsCapability(void)
+{
+    hearNodeInfo(capable, true);
+    TEST_ASSERT_TRUE(canDecompress(capable));
+
+    hearNodeInfo(capable, false);
+    TEST_ASSERT_FALSE(canDecompress(capable));
+}
+
+// Only NodeInfo carries the capability, the bit means nothing on other packets
+void test_otherPacketsLeaveCapabilityAlone(void)
+{
+    hearNodeInfo(capable, true);
+
+    meshtastic_MeshPacket p = meshtastic_MeshPacket_init_zero;
+    p.from = capable;
+    p.which_payload_variant = meshtastic_MeshPacket_decoded_tag;
+    p.decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
+    p.decoded.has_bitfield = true;
+    nodeDB->updateFrom(p);
+    TEST_ASSERT_TRUE(canDecompress(capable));
+
+    p.from = legacy;
+    p.decoded.bitfield = BITFIELD_CAN_DECOMPRESS_TEXT_MASK;
+    nodeDB->updateFrom(p);
+    TEST_ASSERT_FALSE(canDecompress(legacy));
+}
+
+void test_shouldCompressText(void)
+{
+    hearNodeInfo(capable, true);
+    hearNodeInfo(legacy, false);
+
+    meshtastic_MeshPacket p = textTo(capable);
+    TEST_ASSERT_TRUE(shouldCompressText(&p));
+
+    p = textTo(legacy);
+    TEST_ASSERT_FALSE(shouldCompressText(&p));
+
+    p = textTo(0x40); // not in the NodeDB
+    TEST_ASSERT_FALSE(shouldCompressText(&p));
+
+    p = textTo(NODENUM_BROADCAST);
+    TEST_ASSERT_FALSE(shouldCompressText(&p));
+
+    p = textTo(us);
+    TEST_ASSERT_FALSE(shouldCompressText(&p));
+
+    p = textTo(capable);
+    p.from = legacy; // relaying someone else's text
+    TEST_ASSERT_FALSE(shouldCompressText(&p));
+
+    p = textTo(capable);
+    p.decoded.portnum = meshtastic_PortNum_POSITION_APP;
+    TEST_ASSERT_FALSE(shouldCompressText(&p));
+}
+
+// Compressed text sent to us comes out of perhapsDecode() as the original plain text
+void test_decodeExpandsTextToUs(void)
+{
+    meshtastic_MeshPacket p = receiveCompressed(us);
+    TEST_ASSERT_EQUAL(DecodeState::DECODE_SUCCESS, perhapsDecode(&p));
+    TEST_ASSERT_EQUAL(meshtastic_PortNum_TEXT_MESSAGE_APP, p.decoded.portnum);
+    TEST_ASSERT_EQUAL(strlen(text), p.decoded.payload.size);
+    TEST_ASSERT_EQUAL_MEMORY(text, p.decoded.payload.bytes, p.decoded.payload.size);
+}
+
+// Relays forward compressed text at its compressed size
+void test_decodeLeavesRelayedTextCompressed(void)
+{
+    meshtastic_MeshPacket p = receiveCompressed(legacy);
+    TEST_ASSERT_EQUAL(DecodeState::DECODE_SUCCESS, perhapsDecode(&p));
+    TEST_ASSERT_EQUAL(meshtastic_PortNum_TEXT_MESSAGE_COMPRESSED_APP, p.decoded.portnum);
+    TEST_ASSERT_TRUE(p.decoded.payload.size < strlen(text));
+}
+
+// Text that would expand past the payload size is passed on as it arrived, rather than overflowing or being cut short
+void test_decodeKeepsOversizedText(void)
+{
+    std::string digits;
+    for (int i = 0; i < 30; i++)
+        digits += "0123456789";
+    char compressed[sizeof(meshtastic_Data_payload_t::bytes)];
+    int len = unishox2_compress_lines(digits.data(), digits.size(), compressed, sizeof(compressed), USX_PSET_DFLT, NULL);
+    TEST_ASSERT_TRUE(len > 0 && len <= (int)sizeof(compressed));
+
+    meshtastic_MeshPacket p = receive(us, meshtastic_PortNum_TEXT_MESSAGE_COMPRESSED_APP, compressed, len);
+    TEST_ASSERT_EQUAL(DecodeState::DECODE_SUCCESS, perhapsDecode(&p));
+    TEST_ASSERT_EQUAL(meshtastic_PortNum_TEXT_MESSAGE_COMPRESSED_APP, p.decoded.portnum);
+    TEST_ASSERT_EQUAL(len, p.decoded.payload.size);
+    TEST_ASSERT_EQUAL_MEMORY(compressed, p.decoded.payload.bytes, len);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    nodeDB = new NodeDB();
+    if (!cryptLock)
+        cryptLock = new concurrency::Lock();
+
+    channelFile.channels[0] = meshtastic_Channel{
+        .index = 0,
+        .has_settings = true,
+        .settings = {.psk = {.size = 16, .bytes = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16}}, .name = "test"},
+        .role = meshtastic_Channel_Role_PRIMARY,
+    };
+    channelFile.channels_count = 1;
+    channels.onConfigChanged();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_nodeInfoSetsAndClearsCapability);
+    RUN_TEST(test_otherPacketsLeaveCapabilityAlone);
+    RUN_TEST(test_shouldCompressText);
+    RUN_TEST(test_decodeExpandsTextToUs);
+    RUN_TEST(test_decodeLeavesRelayedTextCompressed);
+    RUN_TEST(test_decodeKeepsOversizedText);
+    exit(UNITY_END());
+}
+#else
+void setup()
+{
+    initializeTestEnvironment();
+    LOG_WARN("This test requires ARCH_PORTDUINO");
+    UNITY_BEGIN();
+    UNITY_END();
+}
+#endif
+void loop() {}
@@ -0,0 +1,226 @@
+#include "graphics/TFTBlit.h"
+
+#include "TestUtil.h"
+#include <Arduino.h>
+#include <unity.h>
+#include <vector>
+
+using namespace graphics;
+
+#define WIDTH 320
+#define HEIGHT 240
+#define BUFFER_SIZE (WIDTH * HEIGHT / 8)
+
+static const uint16_t ON = 0x67F2;
+static const uint16_t OFF = 0x0000;
+
+// Bytes a typical SPI panel needs to set the address window before any pixel data (CASET, RASET and RAMWR with arguments)
+#define WINDOW_OVERHEAD_BYTES 11
+
+/// Stands in for the LGFX device: keeps the panel contents and counts what would go over the bus
+struct FakePanel {
+    std::vector<uint16_t> pixels = std::vector<uint16_t>(WIDTH * HEIGHT, OFF);
+    uint32_t writes = 0;
+    uint32_t busBytes = 0;
+
+    void drawPixel(uint16_t x, uint16_t y, uint16_t color)
+    {
+        pixels[y * WIDTH + x] = color;
+        writes++;
+        busBytes += WINDOW_OVERHEAD_BYTES + 2;
+    }
+
+    void pushImage(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *data)
+    {
+        for (uint16_t j = 0; j < h; j++)
+            memcpy(&pixels[(y + j) * WIDTH + x], data + j * w, w * sizeof(uint16_t));
+        writes++;
+        busBytes += WINDOW_OVERHEAD_BYTES + 2 * w * h;
+    }
+};
+
+static uint8_t frame[BUFFER_SIZE], back[BUFFER_SIZE];
+static uint16_t line[WIDTH];
+
+static void setPixel(uint8_t *buf, uint16_t x, uint16_t y, bool on)
+{
+    if (on)
+        buf[x + (y / 8) * WIDTH] |= 1 << (y & 7);
+    else
+        buf[x + (y / 8) * WIDTH] &= ~(1 << (y & 7));
+}
+
+static bool getPixel(const uint8_t *buf, uint16_t x, uint16_t y)
+{
+    return buf[x + (y / 8) * WIDTH] & (1 << (y & 7));
+}
+
+/// What TFTDisplay::display() used to do
+static void blitPerPixel(FakePanel &panel)
+{
+    for (uint16_t y = 0; y < HEIGHT; y++)
+        for (uint16_t x = 0; x < WIDTH; x++)
+            if (getPixel(frame, x, y) != getPixel(back, x, y))
+                panel.drawPixel(x, y, getPixel(frame, x, y) ? ON : OFF);
+}
+
+static void blitSpans(FakePanel &panel)
+{
+    TFTBlit::forEachChangedSpan(frame, back, WIDTH, HEIGHT, [&](uint16_t x, uint16_t y, uint16_t w) {
+        TFTBlit::rowToRGB565(frame, WIDTH, x, y, w, ON, OFF, line);
+        panel.pushImage(x, y, w, 1, line);
+    });
+}
+
+static void assertPanelShowsFrame(const FakePanel &panel)
+{
+    for (uint16_t y = 0; y < HEIGHT; y++)
+        for (uint16_t x = 0; x < WIDTH; x++)
+            TEST_ASSERT_EQUAL_HEX16(getPixel(frame, x, y) ? ON : OFF, panel.pixels[y * WIDTH + x]);
+}
+
+// Crude stand-in for a line of text: a row of 6x8 glyph cells with some pixels lit
+static void drawText(uint8_t *buf, uint16_t x, uint16_t y, uint16_t numChars, uint32_t seed)
+{
+    for (uint16_t c = 0; c < numChars; c++)
+        for (uint16_t gx = 0; gx < 5; gx++)
+            for (uint16_t gy = 0; gy < 8; gy++)
+                setPixel(buf, x + c * 6 + gx, y + gy, ((seed + c * 31 + gx * 7 + gy * 13) % 3) == 0);
+}
+
+void setUp(void)
+{
+    memset(frame, 0, sizeof(frame));
+    memset(back, 0, sizeof(back));
+}
+
+void tearDown(void) {}
+
+void test_unchangedFrameWritesNothing(void)
+{
+    drawText(frame, 10, 10, 20, 1);
+    memcpy(back, frame, sizeof(back));
+    uint32_t spans = 0;
+    TFTBlit::forEachChangedSpan(frame, back, WIDTH, HEIGHT, [&](uint16_t, uint16_t, uint16_t) { spans++; });
+    TEST_ASSERT_EQUAL(0, spans);
+}
+
+void test_fromBlankOnlyCoversLitPixels(void)
+{
+    setPixel(frame, 3, 5, true);
+    setPixel(frame, WIDTH - 1, HEIGHT - 1, true);
+    uint32_t pixels = 0;
+    TFTBlit::forEachChangedSpan(frame, nullptr, WIDTH, HEIGHT, [&](uint16_t x, uint16_t y, uint16_t w) {
+        TEST_ASSERT_TRUE((x == 3 && y == 5) || (x == WIDTH - 1 && y == HEIGHT - 1));
+        pixels += w;
+    });
+    TEST_ASSERT_EQUAL(2, pixels);
+}
+
+void test_randomChangesMatchPerPixel(void)
+{
+    randomSeed(42);
+    FakePanel panel;
+    for (int i = 0; i < 200; i++) {
+        memcpy(back, frame, sizeof(back));
+        // Mix of isolated pixels and small blocks, including the edges of the screen
+        const long changes = random(0, 40);
+        for (long c = 0; c < changes; c++) {
+            const uint16_t x = random(0, WIDTH), y = random(0, HEIGHT);
+            const uint16_t w = random(1, 12), h = random(1, 12);
+            const bool on = random(0, 2);
+            for (uint16_t j = y; j < y + h && j < HEIGHT; j++)
+                for (uint16_t k = x; k < x + w && k < WIDTH; k++)
+                    setPixel(frame, k, j, on);
+        }
+        blitSpans(panel);
+        assertPanelShowsFrame(panel);
+    }
+}
+
+static void benchmark(const char *name, void (*makeFrames)(uint32_t))
+{
+    const uint32_t iterations = 50;
+    FakePanel oldPanel, newPanel;
+    uint32_t oldUsec = 0, newUsec = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        makeFrames(i);
+        // Both panels start out showing the previous frame
+        for (uint16_t y = 0; y < HEIGHT; y++)
+            for (uint16_t x = 0; x < WIDTH; x++)
+                oldPanel.pixels[y * WIDTH + x] = newPanel.pixels[y * WIDTH + x] = getPixel(back, x, y) ? ON : OFF;
+
+        uint32_t start = micros();
+        blitPerPixel(oldPanel);
+        oldUsec += micros() - start;
+        start = micros();
+        blitSpans(newPanel);
+        newUsec += micros() - start;
+    }
+    assertPanelShowsFrame(oldPanel);
+    assertPanelShowsFrame(newPanel);
+
+    char msg[200];
+    snprintf(msg, sizeof(msg), "%-16s per pixel: %7.1f us %6u writes %7u bus bytes | spans: %7.1f us %5u writes %7u bus bytes",
+             name, (float)oldUsec / iterations, (unsigned)(oldPanel.writes / iterations),
+             (unsigned)(oldPanel.busBytes / iterations), (float)newUsec / iterations, (unsigned)(newPanel.writes / iterations),
+             (unsigned)(newPanel.busBytes / iterations));
+    TEST_MESSAGE(msg);
+}
+
+// The clock ticking on the home frame: a few characters change
+static void clockTick(uint32_t i)
+{
+    memset(back, 0, sizeof(back));
+    memset(frame, 0, sizeof(frame));
+    drawText(back, 100, 100, 8, i);
+    drawText(frame, 100, 100, 8, i);
+    drawText(frame, 100 + 6 * 6, 100, 2, i + 1);
+}
+
+// Swiping to another frame, most of the screen changes
+static void frameSwitch(uint32_t i)
+{
+    memset(back, 0, sizeof(back));
+    memset(frame, 0, sizeof(frame));
+    for (uint16_t row = 0; row < 12; row++) {
+        drawText(back, 4, 20 + row * 18, 40, i + row);
+        drawText(frame, 4, 20 + row * 18, 50, i + row + 100);
+    }
+}
+
+// Scrolling a message list by one line of text
+static void scrollList(uint32_t i)
+{
+    memset(back, 0, sizeof(back));
+    memset(frame, 0, sizeof(frame));
+    for (uint16_t row = 0; row < 12; row++) {
+        drawText(back, 4, 16 + row * 18, 30 + (row * 7) % 20, i + row);
+        drawText(frame, 4, 16 + row * 18, 30 + ((row + 1) * 7) % 20, i + row + 1);
+    }
+}
+
+void test_benchmarkTransitions(void)
+{
+    benchmark("clock tick", clockTick);
+    benchmark("frame switch", frameSwitch);
+    benchmark("scroll list", scrollList);
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_unchangedFrameWritesNothing);
+    RUN_TEST(test_fromBlankOnlyCoversLitPixels);
+    RUN_TEST(test_randomChangesMatchPerPixel);
+    RUN_TEST(test_benchmarkTransitions);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}
@@ -0,0 +1,136 @@
+#include "gps/UBXFrameParser.h"
+
+#include "TestUtil.h"
+#include <Arduino.h>
+#include <string.h>
+#include <unity.h>
+
+// UBX-ACK-ACK for UBX-CFG-RATE, as sent by a u-blox module
+static const uint8_t ackCfgRate[] = {0xB5, 0x62, 0x05, 0x01, 0x02, 0x00, 0x06, 0x08, 0x16, 0x3F};
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_parsesFrame(void)
+{
+    uint8_t payload[8] = {0};
+    UBXFrameParser parser(payload, sizeof(payload));
+
+    TEST_ASSERT_EQUAL(sizeof(ackCfgRate), parser.feed(ackCfgRate, sizeof(ackCfgRate)));
+    TEST_ASSERT_TRUE(parser.hasFrame());
+    TEST_ASSERT_EQUAL_HEX8(0x05, parser.msgClass());
+    TEST_ASSERT_EQUAL_HEX8(0x01, parser.msgId());
+    TEST_ASSERT_EQUAL(2, parser.payloadLength());
+    TEST_ASSERT_EQUAL_HEX8(0x06, payload[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x08, payload[1]);
+}
+
+// NMEA traffic and stray sync bytes around the frame, fed a byte at a time
+void test_skipsNoiseAcrossChunks(void)
+{
+    uint8_t stream[128];
+    const char *nmea = "$GPGGA,,,,,,0,00,99.99,,,,,,*48\r\n\xB5\xB5";
+    size_t length = strlen(nmea);
+    memcpy(stream, nmea, length);
+    memcpy(stream + length, ackCfgRate, sizeof(ackCfgRate));
+    length += sizeof(ackCfgRate);
+
+    uint8_t payload[2];
+    UBXFrameParser parser(payload, sizeof(payload));
+    int frames = 0;
+    for (size_t i = 0; i < length; i++) {
+        parser.feed(stream + i, 1);
+        if (parser.hasFrame())
+            frames++;
+    }
+    TEST_ASSERT_EQUAL(1, frames);
+    TEST_ASSERT_EQUAL_HEX8(0x08, payload[1]);
+}
+
+void test_rejectsBadChecksum(void)
+{
+    uint8_t corrupt[sizeof(ackCfgRate)];
+    memcpy(corrupt, ackCfgRate, sizeof(corrupt));
+    corrupt[7] ^= 0x01; // Flip a payload bit
+
+    uint8_t payload[2];
+    UBXFrameParser parser(payload, sizeof(payload));
+    parser.feed(corrupt, sizeof(corrupt));
+    TEST_ASSERT_FALSE(parser.hasFrame());
+    TEST_ASSERT_EQUAL(1, parser.checksumFailures());
+
+    // The parser has resynced, and picks up the next good frame
+    parser.feed(ackCfgRate, sizeof(ackCfgRate));
+    TEST_ASSERT_TRUE(parser.hasFrame());
+}
+
+// feed() stops after each frame, so back to back frames in one chunk are all seen
+void test_backToBackFrames(void)
+{
+    uint8_t stream[sizeof(ackCfgRate) * 3];
+    for (int i = 0; i < 3; i++)
+        memcpy(stream + i * sizeof(ackCfgRate), ackCfgRate, sizeof(ackCfgRate));
+
+    uint8_t payload[2];
+    UBXFrameParser parser(payload, sizeof(payload));
+    int frames = 0;
+    size_t position = 0;
+    while (position < sizeof(stream)) {
+        position += parser.feed(stream + position, sizeof(stream) - position);
+        if (parser.hasFrame())
+            frames++;
+    }
+    TEST_ASSERT_EQUAL(3, frames);
+}
+
+// A frame longer than the buffer is skipped without swallowing the data after its header
+void test_oversizedLengthIsRejected(void)
+{
+    uint8_t stream[6 + sizeof(ackCfgRate)] = {0xB5, 0x62, 0x01, 0x07, 0xFF, 0xFF};
+    memcpy(stream + 6, ackCfgRate, sizeof(ackCfgRate));
+
+    uint8_t payload[2];
+    UBXFrameParser parser(payload, sizeof(payload));
+    parser.feed(stream, sizeof(stream));
+    TEST_ASSERT_TRUE(parser.hasFrame());
+    TEST_ASSERT_EQUAL_HEX8(0x05, parser.msgClass());
+    TEST_ASSERT_EQUAL(1, parser.oversizedFrames());
+}
+
+// A false sync right before a real frame: the bogus header is the real frame's sync, class and ID
+void test_resyncsAfterFalseSync(void)
+{
+    uint8_t stream[2 + sizeof(ackCfgRate)] = {0xB5, 0x62};
+    memcpy(stream + 2, ackCfgRate, sizeof(ackCfgRate));
+
+    uint8_t payload[2];
+    UBXFrameParser parser(payload, sizeof(payload));
+    TEST_ASSERT_EQUAL(sizeof(stream), parser.feed(stream, sizeof(stream)));
+    TEST_ASSERT_TRUE(parser.hasFrame());
+    TEST_ASSERT_EQUAL_HEX8(0x05, parser.msgClass());
+    TEST_ASSERT_EQUAL_HEX8(0x01, parser.msgId());
+    TEST_ASSERT_EQUAL_HEX8(0x06, payload[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x08, payload[1]);
+    TEST_ASSERT_EQUAL(1, parser.oversizedFrames());
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_parsesFrame);
+    RUN_TEST(test_skipsNoiseAcrossChunks);
+    RUN_TEST(test_rejectsBadChecksum);
+    RUN_TEST(test_backToBackFrames);
+    RUN_TEST(test_oversizedLengthIsRejected);
+    RUN_TEST(test_resyncsAfterFalseSync);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}
@@ -0,0 +1,156 @@
+#include "mesh/compression/unishox2.h"
+
+#include "TestUtil.h"
+#include <Arduino.h>
+#include <string>
+#include <unity.h>
+
+// The kind of text AtakPluginModule and PositionModule compress: callsigns, device ids and short chat messages
+static const char *corpus[] = {"ALPHA-1",
+                               "SGT Johnson 3rd PLT",
+                               "ANDROID-a1b2c3d4e5f6",
+                               "Meet at 12:30 near the bridge",
+                               "Roger that, moving to checkpoint 4 now",
+                               "The quick brown fox jumps over the lazy dog. The quick brown fox!",
+                               "123e4567-e89b-12d3-a456-426614174000",
+                               "https://www.example.com/path?x=1",
+                               "Ça va? Ünïcödé テスト 日本語",
+                               "aaaaaaaaaaaaaaaaaaaabbbbbbbbb",
+                               "line1\r\nline2\nline3\ttab"};
+
+static void hexToBytes(uint8_t *result, const std::string &hex)
+{
+    for (unsigned int i = 0; i < hex.length(); i += 2)
+        result[i / 2] = (uint8_t)strtol(hex.substr(i, 2).c_str(), NULL, 16);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// The encoded format is shared with other devices and apps, so the output must stay bit for bit the same
+void test_compressIsBitExact(void)
+{
+    struct {
+        const char *in;
+        const char *expected;
+    } vectors[] = {
+        {"ALPHA-1", "804f1e3b48168a7f"},
+        {"ANDROID-a1b2c3d4e5f6", "804e75babe80b445450d961ea72fb1"},
+        {"Roger that, moving to checkpoint 4 now", "86ebd9ed4769824bcd7d5e7b28a5cf67cfdf8abc845cfa0caf72"},
+    };
+    for (auto &v : vectors) {
+        char out[128];
+        uint8_t expected[64];
+        const size_t expectedLen = strlen(v.expected) / 2;
+        hexToBytes(expected, v.expected);
+
+        int len = unishox2_compress_lines(v.in, strlen(v.in), out, sizeof(out), USX_PSET_DFLT, NULL);
+        TEST_ASSERT_EQUAL(expectedLen, len);
+        TEST_ASSERT_EQUAL_MEMORY(expected, out, expectedLen);
+    }
+}
+
+static void assertRoundTrip(const std::string &in)
+{
+    char compressed[512], decompressed[512];
+    int len = unishox2_compress_lines(in.data(), in.size(), compressed, sizeof(compressed), USX_PSET_DFLT, NULL);
+    TEST_ASSERT_TRUE(len > 0 && len <= (int)sizeof(compressed));
+    int outLen = unishox2_decompress(compressed, len, decompressed, sizeof(decompressed), USX_PSET_DFLT);
+    TEST_ASSERT_EQUAL(in.size(), outLen);
+    TEST_ASSERT_EQUAL_MEMORY(in.data(), decompressed, in.size());
+}
+
+void test_roundTripCorpus(void)
+{
+    for (const char *s : corpus)
+        assertRoundTrip(s);
+}
+
+void test_roundTripFuzz(void)
+{
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 .,-:/!?\"{}\n\r\t";
+    randomSeed(1234);
+    for (int i = 0; i < 2000; i++) {
+        std::string s;
+        const long len = random(0, 120);
+        const long mode = random(0, 3);
+        for (long j = 0; j < len; j++) {
+            if (mode == 0)
+                s += alphabet[random(0, sizeof(alphabet) - 1)];
+            else if (mode == 1)
+                s += (char)random(1, 256); // arbitrary bytes, exercises the binary and unicode escapes
+            else if (random(0, 6) == 0)
+                s += "\xc3\xa9"; // mostly ascii with some multi byte UTF-8
+            else
+                s += alphabet[random(0, 26)];
+        }
+        assertRoundTrip(s);
+    }
+}
+
+// Decoding data off the mesh must never write past the output buffer, however broken the input
+void test_decompressGarbageIsBounded(void)
+{
+    randomSeed(5678);
+    for (int i = 0; i < 2000; i++) {
+        char in[64];
+        char out[72];
+        const long len = random(0, sizeof(in));
+        for (long j = 0; j < len; j++)
+            in[j] = random(0, 256);
+        memset(out, 0x55, sizeof(out));
+        unishox2_decompress(in, len, out, 64, USX_PSET_DFLT);
+        for (size_t j = 64; j < sizeof(out); j++)
+            TEST_ASSERT_EQUAL_HEX8(0x55, out[j]);
+    }
+}
+
+void test_benchmarkCorpus(void)
+{
+    const uint32_t iterations = 2000;
+    char compressed[256], decompressed[256];
+    size_t numBytes = 0, numCompressed = 0;
+
+    uint32_t start = micros();
+    for (uint32_t i = 0; i < iterations; i++)
+        for (const char *s : corpus)
+            unishox2_compress_lines(s, strlen(s), compressed, sizeof(compressed), USX_PSET_DFLT, NULL);
+    uint32_t compressUsec = micros() - start;
+
+    uint32_t decompressUsec = 0;
+    for (const char *s : corpus) {
+        int len = unishox2_compress_lines(s, strlen(s), compressed, sizeof(compressed), USX_PSET_DFLT, NULL);
+        numBytes += strlen(s);
+        numCompressed += len;
+        start = micros();
+        for (uint32_t i = 0; i < iterations; i++)
+            unishox2_decompress(compressed, len, decompressed, sizeof(decompressed), USX_PSET_DFLT);
+        decompressUsec += micros() - start;
+    }
+
+    const float messages = (float)iterations * (sizeof(corpus) / sizeof(corpus[0]));
+    char msg[128];
+    snprintf(msg, sizeof(msg), "corpus %u -> %u bytes, compress %.3f us/msg, decompress %.3f us/msg", (unsigned)numBytes,
+             (unsigned)numCompressed, compressUsec / messages, decompressUsec / messages);
+    TEST_MESSAGE(msg);
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_compressIsBitExact);
+    RUN_TEST(test_roundTripCorpus);
+    RUN_TEST(test_roundTripFuzz);
+    RUN_TEST(test_decompressGarbageIsBounded);
+    RUN_TEST(test_benchmarkCorpus);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}